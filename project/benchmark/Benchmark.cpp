@@ -0,0 +1,95 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 経過時間(ナノ秒)
+double ElapsedNs(Clock::time_point start, Clock::time_point end) { return std::chrono::duration<double, std::nano>(end - start).count(); }
+
+} // namespace
+
+// 計測する
+void Benchmark::Run(const std::string& name, size_t itemsPerCall, const std::function<void()>& func) {
+	if (!settings_.filter.empty() && name.find(settings_.filter) == std::string::npos) {
+		return;
+	}
+
+	// 暖機しながら1サンプルあたりの呼び出し回数を決める
+	size_t callsPerSample = 1;
+	double warmupNs = settings_.warmupMs * 1.0e6;
+	double sampleNs = settings_.sampleMs * 1.0e6;
+	Clock::time_point warmupStart = Clock::now();
+	while (true) {
+		Clock::time_point start = Clock::now();
+		for (size_t i = 0; i < callsPerSample; ++i) {
+			func();
+		}
+		double elapsed = ElapsedNs(start, Clock::now());
+		if (elapsed < sampleNs) {
+			callsPerSample *= 2;
+		} else if (ElapsedNs(warmupStart, Clock::now()) >= warmupNs) {
+			break;
+		}
+	}
+
+	// 計測
+	std::vector<double> samples(settings_.sampleCount);
+	for (double& sample : samples) {
+		Clock::time_point start = Clock::now();
+		for (size_t i = 0; i < callsPerSample; ++i) {
+			func();
+		}
+		sample = ElapsedNs(start, Clock::now()) / static_cast<double>(callsPerSample * itemsPerCall);
+	}
+
+	// 統計
+	std::sort(samples.begin(), samples.end());
+	Result result;
+	result.name = name;
+	result.itemsPerCall = itemsPerCall;
+	result.callsPerSample = callsPerSample;
+	result.sampleCount = samples.size();
+	result.minNs = samples.front();
+	result.medianNs = samples[samples.size() / 2];
+	double sum = 0.0;
+	for (double sample : samples) {
+		sum += sample;
+	}
+	result.meanNs = sum / static_cast<double>(samples.size());
+	double variance = 0.0;
+	for (double sample : samples) {
+		variance += (sample - result.meanNs) * (sample - result.meanNs);
+	}
+	result.stddevNs = std::sqrt(variance / static_cast<double>(samples.size()));
+
+	std::fprintf(stderr, "%-48s %12.3f ns/item\n", name.c_str(), result.medianNs);
+	results_.push_back(result);
+}
+
+// 結果の表を出力
+void Benchmark::PrintTable() const {
+	std::printf("%-48s %12s %12s %12s %12s\n", "name", "min(ns)", "median(ns)", "mean(ns)", "stddev(ns)");
+	for (const Result& result : results_) {
+		std::printf("%-48s %12.3f %12.3f %12.3f %12.3f\n", result.name.c_str(), result.minNs, result.medianNs, result.meanNs, result.stddevNs);
+	}
+}
+
+// 結果をJSONで出力
+std::string Benchmark::ToJson() const {
+	std::ostringstream json;
+	json << "{\n  \"unit\": \"ns/item\",\n  \"results\": [\n";
+	for (size_t i = 0; i < results_.size(); ++i) {
+		const Result& result = results_[i];
+		json << "    {\"name\": \"" << result.name << "\", \"itemsPerCall\": " << result.itemsPerCall << ", \"callsPerSample\": " << result.callsPerSample
+		     << ", \"samples\": " << result.sampleCount << ", \"min\": " << result.minNs << ", \"median\": " << result.medianNs << ", \"mean\": " << result.meanNs
+		     << ", \"stddev\": " << result.stddevNs << "}" << (i + 1 < results_.size() ? "," : "") << "\n";
+	}
+	json << "  ]\n}\n";
+	return json.str();
+}
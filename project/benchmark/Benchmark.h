@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 最適化で計算が消されないように値を使ったことにする
+template<class T> inline void DoNotOptimize(const T& value) {
+	static volatile unsigned char sink = 0;
+	sink = static_cast<unsigned char>(sink + *reinterpret_cast<const volatile unsigned char*>(&value));
+}
+
+// マイクロベンチマークの計測と結果の出力
+class Benchmark {
+public:
+	// 1つの計測結果
+	struct Result {
+		std::string name;
+		// 1回の呼び出しで処理する要素数(バッチ版の比較用)
+		size_t itemsPerCall = 1;
+		size_t callsPerSample = 0;
+		size_t sampleCount = 0;
+		// 1要素あたりのナノ秒
+		double minNs = 0.0;
+		double medianNs = 0.0;
+		double meanNs = 0.0;
+		double stddevNs = 0.0;
+	};
+
+	// 計測設定
+	struct Settings {
+		// 暖機にかける時間(ミリ秒)
+		double warmupMs = 50.0;
+		// 1サンプルにかける目安の時間(ミリ秒)
+		double sampleMs = 10.0;
+		// サンプル数
+		size_t sampleCount = 30;
+		// 名前にこの文字列を含むものだけ実行する(空なら全部)
+		std::string filter;
+	};
+
+	explicit Benchmark(const Settings& settings) : settings_(settings) {}
+
+	// 計測する
+	// func : 1回呼ぶとitemsPerCall個の要素を処理する関数
+	void Run(const std::string& name, size_t itemsPerCall, const std::function<void()>& func);
+
+	// 結果の表を出力
+	void PrintTable() const;
+
+	// 結果をJSONで出力
+	std::string ToJson() const;
+
+	// 結果のgetter
+	const std::vector<Result>& GetResults() const { return results_; }
+
+private:
+	Settings settings_;
+	std::vector<Result> results_;
+};
+
+// 各モジュールのベンチマークの登録
+void RunMathBenchmarks(Benchmark& benchmark);
+void RunTrigBenchmarks(Benchmark& benchmark);
+void RunSpriteBenchmarks(Benchmark& benchmark);
+void RunSpriteSystemBenchmarks(Benchmark& benchmark);
+void RunTextureAtlasBenchmarks(Benchmark& benchmark);
+void RunParallelSpriteBenchmarks(Benchmark& benchmark);
+void RunFlipbookBenchmarks(Benchmark& benchmark);
+void RunTweenBenchmarks(Benchmark& benchmark);
+void RunTextBenchmarks(Benchmark& benchmark);
+void RunNineSliceBenchmarks(Benchmark& benchmark);
+void RunRenderQueueBenchmarks(Benchmark& benchmark);
+void RunTilemapBenchmarks(Benchmark& benchmark);
+void RunBroadphaseBenchmarks(Benchmark& benchmark);
+void RunSceneGraphBenchmarks(Benchmark& benchmark);
+
+// SIMD版・バッチ版・3x4専用の行列計算の誤差を調べる(スカラー版との差が許容値を超えたらfalse)
+bool RunMathCheck();
+// 視錐台・矩形のカリングを調べる(スカラー版の判定と表示する番号が違えばfalse)
+bool RunCullingCheck();
+// sin/cos近似の誤差を調べる(許容誤差を超えたらfalse)
+bool RunTrigAccuracyCheck();
+// スプライトのインスタンスの詰め方を調べる(SpriteBatchと結果が違えばfalse)
+bool RunSpriteInstanceCheck();
+// SpriteSystemがまとめて求めたWorld行列を調べる(MakeAffineMatrixと値が違えばfalse)
+bool RunSpriteSystemCheck();
+// テクスチャアトラスの詰め方とキャッシュを調べる(画像が壊れていればfalse)
+bool RunTextureAtlasCheck();
+// ワーカースレッドで分けたスプライトの更新と書き込みを調べる(1スレッドと結果が違えばfalse)
+bool RunParallelSpriteCheck();
+// パラパラアニメのコマの進み方を調べる(再生方法ごとの並びが違えばfalse)
+bool RunFlipbookCheck();
+// 焼き込んだイージングの誤差とTweenの進み方を調べる(誤差が大きいか値が違えばfalse)
+bool RunTweenCheck();
+// 文字列の並べ方とキャッシュを調べる(頂点の位置・ページ分けが違えばfalse)
+bool RunTextCheck();
+// 9分割スプライトの頂点とバッチのランを調べる(頂点の位置・UV・ランの分け方が違えばfalse)
+bool RunNineSliceCheck();
+// 描く順番のkeyと基数ソートを調べる(std::stable_sortと順番が違えばfalse)
+bool RunRenderQueueCheck();
+// タイルマップのチャンクの頂点と作り直し方を調べる(頂点の位置・UV・作り直したチャンク数が違えばfalse)
+bool RunTilemapCheck();
+// スプライトの当たり判定の候補を調べる(総当たりと組が違えばfalse)
+bool RunBroadphaseCheck();
+// シーングラフの差分更新を調べる(全部計算し直した行列と違うか、動かしていないノードを計算し直したらfalse)
+bool RunSceneGraphCheck();
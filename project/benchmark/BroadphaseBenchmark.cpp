@@ -0,0 +1,172 @@
+#include "2d/SpriteBroadphase.h"
+#include "2d/SpriteSystem.h"
+#include "Benchmark.h"
+#include "base/Culling.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// スプライトの大きさと、1つあたりの広さ(平均して1つに1組くらい重なる)
+const float kBodySize = 16.0f;
+const float kAreaPerBody = 1600.0f;
+// 1フレームに動く最大のピクセル数
+const float kMaxSpeed = 2.0f;
+
+// 動き回るスプライト
+struct MovingBodies {
+	SpriteSystem system;
+	std::vector<SpriteHandle> handles;
+	std::vector<Vector2> velocities;
+	float worldSize = 0.0f;
+};
+
+// count個のスプライトを正方形の中にばらまく
+void Spawn(MovingBodies& bodies, uint32_t count, std::mt19937& random) {
+	bodies.worldSize = std::sqrt(kAreaPerBody * static_cast<float>(count));
+	std::uniform_real_distribution<float> position(0.0f, bodies.worldSize);
+	std::uniform_real_distribution<float> velocity(-kMaxSpeed, kMaxSpeed);
+	for (uint32_t i = 0; i < count; ++i) {
+		SpriteHandle handle = bodies.system.Create(0, {kBodySize, kBodySize});
+		bodies.system.SetPosition(handle, {position(random), position(random)});
+		bodies.handles.push_back(handle);
+		bodies.velocities.push_back({velocity(random), velocity(random)});
+	}
+}
+
+// 1フレーム分動かす(端で跳ね返る)
+void Move(MovingBodies& bodies) {
+	for (size_t i = 0; i < bodies.handles.size(); ++i) {
+		Vector2 position = bodies.system.GetPosition(bodies.handles[i]);
+		Vector2& velocity = bodies.velocities[i];
+		position.x += velocity.x;
+		position.y += velocity.y;
+		if (position.x < 0.0f || position.x > bodies.worldSize) {
+			velocity.x = -velocity.x;
+		}
+		if (position.y < 0.0f || position.y > bodies.worldSize) {
+			velocity.y = -velocity.y;
+		}
+		bodies.system.SetPosition(bodies.handles[i], position);
+	}
+}
+
+// 全ての組を比べる(答え合わせと比較用)
+void FindPairsBruteForce(const SpriteSystem& system, std::vector<Rect2D>& rects, std::vector<SpritePair>& outPairs) {
+	rects.resize(system.GetCount());
+	system.ComputeBoundingRects(rects.data());
+	outPairs.clear();
+	for (uint32_t i = 0; i < rects.size(); ++i) {
+		for (uint32_t j = i + 1; j < rects.size(); ++j) {
+			if (rects[i].left <= rects[j].right && rects[i].right >= rects[j].left && rects[i].top <= rects[j].bottom && rects[i].bottom >= rects[j].top) {
+				outPairs.push_back({system.GetHandle(i), system.GetHandle(j)});
+			}
+		}
+	}
+}
+
+// 組の並びと、組の中の2つの順番をそろえる
+std::vector<std::pair<uint64_t, uint64_t>> Normalize(const std::vector<SpritePair>& pairs) {
+	auto toKey = [](SpriteHandle handle) { return (static_cast<uint64_t>(handle.index) << 32) | handle.generation; };
+	std::vector<std::pair<uint64_t, uint64_t>> keys;
+	for (const SpritePair& pair : pairs) {
+		keys.push_back(std::minmax(toKey(pair.a), toKey(pair.b)));
+	}
+	std::sort(keys.begin(), keys.end());
+	return keys;
+}
+
+} // namespace
+
+// 重なっている組が総当たりと同じになるかを調べる(動かしたり、作成・削除したりしながら)
+bool RunBroadphaseCheck() {
+	std::mt19937 random(7);
+	MovingBodies bodies;
+	Spawn(bodies, 1500, random);
+	// アンカーポイント・フリップ・回転・大きさが違うものも混ぜる
+	for (size_t i = 0; i < bodies.handles.size(); i += 5) {
+		bodies.system.SetAnchorPoint(bodies.handles[i], {0.5f, 1.0f});
+		bodies.system.SetIsFlipX(bodies.handles[i], i % 2 == 0);
+		bodies.system.SetRotation(bodies.handles[i + 1], 0.7f);
+		bodies.system.SetSize(bodies.handles[i + 2], {48.0f, 8.0f});
+	}
+	// 縁がちょうど接しているもの
+	SpriteHandle touchingA = bodies.system.Create(0, {10.0f, 10.0f});
+	SpriteHandle touchingB = bodies.system.Create(0, {10.0f, 10.0f});
+	bodies.system.SetPosition(touchingA, {-100.0f, -100.0f});
+	bodies.system.SetPosition(touchingB, {-90.0f, -100.0f});
+
+	SpriteBroadphase broadphase;
+	std::vector<Rect2D> rects;
+	std::vector<SpritePair> expected;
+	bool passed = true;
+	for (uint32_t frame = 0; frame < 20 && passed; ++frame) {
+		Move(bodies);
+		// ときどき削除して作り直す(スロットが使い回される)
+		if (frame % 4 == 3) {
+			for (size_t i = frame; i < bodies.handles.size(); i += 97) {
+				bodies.system.Destroy(bodies.handles[i]);
+				bodies.handles[i] = bodies.system.Create(0, {kBodySize, kBodySize});
+				bodies.system.SetPosition(bodies.handles[i], {bodies.worldSize * 0.5f, bodies.worldSize * 0.5f});
+			}
+		}
+		broadphase.Update(bodies.system);
+		FindPairsBruteForce(bodies.system, rects, expected);
+		passed = broadphase.GetCount() == bodies.system.GetCount() && !expected.empty() && Normalize(broadphase.GetPairs()) == Normalize(expected);
+	}
+	// 少しずつ動かしただけなら、並べ直しはスプライト数よりずっと少ない
+	passed = passed && broadphase.GetSortMoveCount() < bodies.handles.size();
+	// 全部消したら空になる
+	for (SpriteHandle handle : bodies.handles) {
+		bodies.system.Destroy(handle);
+	}
+	bodies.system.Destroy(touchingA);
+	broadphase.Update(bodies.system);
+	passed = passed && broadphase.GetCount() == 1 && broadphase.GetPairs().empty();
+
+	std::printf("broadphase %s\n\n", passed ? "" : "FAILED");
+	return passed;
+}
+
+// 動き回るスプライトの重なっている組を毎フレーム求める(総当たりとsweep and pruneの比較)
+void RunBroadphaseBenchmarks(Benchmark& benchmark) {
+	for (uint32_t count : {10000u, 50000u}) {
+		std::mt19937 random(count);
+		MovingBodies bodies;
+		Spawn(bodies, count, random);
+		std::string suffix = "/" + std::to_string(count / 1000) + "k";
+
+		// 総当たりは5万では1回に数秒かかるので1万だけ
+		if (count <= 10000) {
+			std::vector<Rect2D> rects;
+			std::vector<SpritePair> pairs;
+			benchmark.Run("Broadphase/bruteForce" + suffix, count, [&]() {
+				Move(bodies);
+				FindPairsBruteForce(bodies.system, rects, pairs);
+				DoNotOptimize(pairs.size());
+			});
+		}
+
+		SpriteBroadphase broadphase;
+		uint32_t frameCount = 0;
+		uint64_t sortMoveCount = 0;
+		benchmark.Run("Broadphase/sweepAndPrune" + suffix, count, [&]() {
+			Move(bodies);
+			broadphase.Update(bodies.system);
+			sortMoveCount += broadphase.GetSortMoveCount();
+			++frameCount;
+			DoNotOptimize(broadphase.GetPairs().size());
+		});
+
+		// 計測しなかった場合(--filter)は表示しない
+		if (frameCount > 1) {
+			std::printf("Broadphase %u bodies: %zu pairs, %.0f sort moves per frame\n\n", count, broadphase.GetPairs().size(),
+			            static_cast<double>(sortMoveCount) / frameCount);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+#include "2d/FlipbookSystem.h"
+#include "2d/SpriteSystem.h"
+#include "Benchmark.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// 計測するアニメーション数
+const uint32_t kAnimationCount = 50000;
+// 1フレームの経過時間
+const float kDeltaTime = 1.0f / 60.0f;
+
+// 4x4のコマに分けたシート
+SpriteTextureRegion MakeSheet() { return {0, {1024.0f, 1024.0f}, {256.0f, 0.0f}, {512.0f, 512.0f}}; }
+
+} // namespace
+
+// 再生方法ごとのコマの進み方と、コマが変わったときだけ書き込むかを調べる
+bool RunFlipbookCheck() {
+	SpriteSystem system;
+	FlipbookSystem flipbook;
+	const float kFramesPerSecond = 10.0f;
+	FlipbookClipId clip = flipbook.CreateGridClip(MakeSheet(), 4, 4, 4, kFramesPerSecond);
+	// 格子は左上から横に並ぶ
+	bool passed = flipbook.GetClipFrameCount(clip) == 4 && flipbook.GetClipFrame(clip, 3).origin == Vector2{640.0f, 0.0f} &&
+	              flipbook.GetClipFrame(clip, 1).size == Vector2{128.0f, 128.0f};
+
+	SpriteHandle loop = system.Create(0, {1024.0f, 1024.0f});
+	SpriteHandle pingPong = system.Create(0, {1024.0f, 1024.0f});
+	SpriteHandle once = system.Create(0, {1024.0f, 1024.0f});
+	flipbook.Play(loop, clip, FlipbookPlayMode::kLoop);
+	flipbook.Play(pingPong, clip, FlipbookPlayMode::kPingPong);
+	flipbook.Play(once, clip, FlipbookPlayMode::kOnce);
+	// 最初のUpdateで0コマ目を書き込む
+	flipbook.Update(0.0f, system);
+	passed = passed && flipbook.GetFrameChangeCount() == 3 && system.GetTextureCutSize(loop) == Vector2{128.0f, 128.0f};
+
+	// 1コマ分の時間ずつ進める(ずれで境目をまたがないように少しだけ長く進める)
+	float step = 1.0f / kFramesPerSecond + 1.0e-4f;
+	std::vector<uint32_t> loopFrames, pingPongFrames, onceFrames;
+	for (uint32_t i = 0; i < 9; ++i) {
+		flipbook.Update(step, system);
+		loopFrames.push_back(flipbook.GetFrame(loop));
+		pingPongFrames.push_back(flipbook.GetFrame(pingPong));
+		onceFrames.push_back(flipbook.GetFrame(once));
+	}
+	flipbook.Stop(loop);
+	flipbook.Stop(pingPong);
+	passed = passed && loopFrames == std::vector<uint32_t>{1, 2, 3, 0, 1, 2, 3, 0, 1};
+	passed = passed && pingPongFrames == std::vector<uint32_t>{1, 2, 3, 2, 1, 0, 1, 2, 3};
+	passed = passed && onceFrames == std::vector<uint32_t>{1, 2, 3, 3, 3, 3, 3, 3, 3} && flipbook.IsFinished(once);
+
+	// コマが変わらなければ書き込まないので、四角形も計算し直さない
+	system.Update();
+	system.ResetRebuildCount();
+	flipbook.ResetFrameChangeCount();
+	flipbook.Update(kDeltaTime, system);
+	system.Update();
+	passed = passed && flipbook.GetFrameChangeCount() == 0 && system.GetRebuildCount() == 0;
+
+	// 削除したスプライトのアニメーションはUpdateで取り除き、スロットを使い回したスプライトは別扱い
+	system.Destroy(once);
+	SpriteHandle reused = system.Create(0, {1024.0f, 1024.0f});
+	passed = passed && reused.index == once.index && !flipbook.IsPlaying(reused);
+	flipbook.Update(kDeltaTime, system);
+	passed = passed && flipbook.GetCount() == 0;
+	flipbook.Play(reused, clip, FlipbookPlayMode::kLoop, -1.0f);
+	// 逆再生では0コマ目の前が最後のコマ
+	flipbook.Update(0.5f / kFramesPerSecond, system);
+	passed = passed && flipbook.GetFrame(reused) == 3;
+
+	// 1回だけの再生は、コマ数と速さの組み合わせによらず最後のコマで終わったことになる
+	// (コマ数 / 速さで止めた時間に速さを掛けると、丸めでコマ数に少し届かない組み合わせがある)
+	const struct {
+		uint32_t frameCount;
+		float framesPerSecond;
+	} kOnceCases[] = {{31, 7.0f}, {53, 13.0f}, {61, 13.0f}, {62, 7.0f}, {63, 30.0f}, {4, 10.0f}};
+	for (const auto& onceCase : kOnceCases) {
+		std::vector<SpriteTextureRegion> frames(onceCase.frameCount, MakeSheet());
+		FlipbookClipId onceClip = flipbook.CreateClip(frames.data(), onceCase.frameCount, onceCase.framesPerSecond);
+		flipbook.Play(reused, onceClip, FlipbookPlayMode::kOnce);
+		for (uint32_t i = 0; i < 2000; ++i) {
+			flipbook.Update(kDeltaTime, system);
+		}
+		passed = passed && flipbook.IsFinished(reused) && flipbook.GetFrame(reused) == onceCase.frameCount - 1;
+	}
+
+	std::printf("flipbook animation %s\n\n", passed ? "" : "FAILED");
+	return passed;
+}
+
+// コマ送りの比較(毎フレーム全スプライトの切り出しを書き換える場合と、コマが変わったものだけ書き込む場合)
+// 8コマ/秒なので、60FPSでは大体7〜8フレームに1回しかコマが変わらない
+void RunFlipbookBenchmarks(Benchmark& benchmark) {
+	SpriteSystem system;
+	FlipbookSystem flipbook;
+	const uint32_t kColumns = 4;
+	const float kFramesPerSecond = 8.0f;
+	SpriteTextureRegion sheet = MakeSheet();
+	FlipbookClipId clip = flipbook.CreateGridClip(sheet, kColumns, kColumns, kColumns * kColumns, kFramesPerSecond);
+	std::vector<SpriteHandle> handles(kAnimationCount);
+	for (uint32_t i = 0; i < kAnimationCount; ++i) {
+		handles[i] = system.Create(sheet);
+		// 速さをばらばらにしてコマが変わるフレームをずらす
+		flipbook.Play(handles[i], clip, static_cast<FlipbookPlayMode>(i % 2), 0.7f + static_cast<float>(i % 7) * 0.1f);
+	}
+	flipbook.Update(0.0f, system);
+	system.Update();
+
+	// 手で毎フレームSetTextureLeftTop・SetTextureCutSizeを呼ぶ(コマ番号は経過時間から求める)
+	std::vector<float> times(kAnimationCount, 0.0f);
+	Vector2 cellSize = {sheet.size.x / kColumns, sheet.size.y / kColumns};
+	benchmark.Run("Flipbook/manualSetters", kAnimationCount, [&]() {
+		for (uint32_t i = 0; i < kAnimationCount; ++i) {
+			times[i] += kDeltaTime;
+			uint32_t frame = static_cast<uint32_t>(times[i] * kFramesPerSecond) % (kColumns * kColumns);
+			system.SetTextureLeftTop(handles[i], {cellSize.x * static_cast<float>(frame % kColumns), cellSize.y * static_cast<float>(frame / kColumns)});
+			system.SetTextureCutSize(handles[i], cellSize);
+		}
+		system.Update();
+		DoNotOptimize(system.GetQuads()[0]);
+	});
+
+	benchmark.Run("Flipbook/system", kAnimationCount, [&]() {
+		flipbook.Update(kDeltaTime, system);
+		system.Update();
+		DoNotOptimize(system.GetQuads()[0]);
+	});
+}
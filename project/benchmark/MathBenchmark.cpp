@@ -0,0 +1,585 @@
+#include "Benchmark.h"
+#include "base/Culling.h"
+#include "base/Math.h"
+#include "base/TransformBatch.h"
+#include "base/VectorMath.h"
+#include "base/WorkerPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+// バッチ版の要素数
+const size_t kBatchSize = 1024;
+// SIMD版とスカラー版の差の許容値(値の大きさに対する比。1以下の値は絶対誤差で見る)
+const float kMathTolerance = 1e-4f;
+
+// 乱数で埋めた行列
+Matrix4x4 RandomMatrix(std::mt19937& random) {
+	std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+	Matrix4x4 result;
+	for (auto& row : result.m) {
+		for (float& value : row) {
+			value = distribution(random);
+		}
+	}
+	return result;
+}
+
+// 乱数で埋めたTransform
+Transform RandomTransform(std::mt19937& random) {
+	std::uniform_real_distribution<float> distribution(-3.0f, 3.0f);
+	return {
+	    {distribution(random), distribution(random), distribution(random)},
+	    {distribution(random), distribution(random), distribution(random)},
+	    {distribution(random), distribution(random), distribution(random)},
+	};
+}
+
+// 2つの行列の差(値の大きさに対する比)の最大値
+float MaxRelativeError(const Matrix4x4& actual, const Matrix4x4& expected) {
+	float maxError = 0.0f;
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 4; ++column) {
+			float error = std::fabs(actual.m[row][column] - expected.m[row][column]) / std::max(1.0f, std::fabs(expected.m[row][column]));
+			maxError = std::max(maxError, error);
+		}
+	}
+	return maxError;
+}
+
+// 逆行列の誤差が大きくならない行列(対角成分を大きくして、行列式が0に近いものを避ける)
+Matrix4x4 RandomInvertibleMatrix(std::mt19937& random) {
+	Matrix4x4 result = RandomMatrix(random);
+	for (int i = 0; i < 4; ++i) {
+		result.m[i][i] += result.m[i][i] < 0.0f ? -8.0f : 8.0f;
+	}
+	return result;
+}
+
+// 不均一な拡縮のアフィン変換(拡縮の大きさは0.5～3で、向きの反転も含む)
+AffineTransform RandomAffineTransform(std::mt19937& random) {
+	std::uniform_real_distribution<float> scale(0.5f, 3.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> translate(-10.0f, 10.0f);
+	Vector3 scaleVector = {scale(random), scale(random), random() % 4 == 0 ? -scale(random) : scale(random)};
+	return MakeAffineTransform(scaleVector, {angle(random), angle(random), angle(random)}, {translate(random), translate(random), translate(random)});
+}
+
+// 差の最大値を1行表示して、許容値に収まっているかを返す
+bool PrintMathError(const char* name, float maxError) {
+	bool ok = maxError <= kMathTolerance;
+	std::printf("%-32s %14.3e %s\n", name, maxError, ok ? "" : "FAILED");
+	return ok;
+}
+
+// 行列の積と逆行列
+void RunMatrixBenchmarks(Benchmark& benchmark, std::mt19937& random) {
+	std::vector<Matrix4x4> a(kBatchSize), b(kBatchSize), out(kBatchSize);
+	for (size_t i = 0; i < kBatchSize; ++i) {
+		a[i] = RandomMatrix(random);
+		b[i] = RandomMatrix(random);
+	}
+
+	benchmark.Run("Multiply/scalar", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = MultiplyScalar(a[i], b[i]);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("Multiply/sse", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = Multiply(a[i], b[i]);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("MultiplyBatch/sse", kBatchSize, [&]() {
+		MultiplyBatch(a.data(), b.data(), out.data(), kBatchSize);
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("MultiplyBatch/sharedRhs", kBatchSize, [&]() {
+		MultiplyBatch(a.data(), b[0], out.data(), kBatchSize);
+		DoNotOptimize(out[0]);
+	});
+
+	benchmark.Run("Inverse/scalar", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = InverseScalar(a[i]);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("Inverse/sse", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = Inverse(a[i]);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("InverseBatch/sse", kBatchSize, [&]() {
+		InverseBatch(a.data(), out.data(), kBatchSize);
+		DoNotOptimize(out[0]);
+	});
+}
+
+// アフィン変換
+void RunAffineBenchmarks(Benchmark& benchmark, std::mt19937& random) {
+	std::vector<Transform> transforms(kBatchSize);
+	std::vector<Quaternion> rotations(kBatchSize);
+	std::vector<AffineTransform> affines(kBatchSize), affineOut(kBatchSize);
+	std::vector<Matrix4x4> matrices(kBatchSize), out(kBatchSize);
+	for (size_t i = 0; i < kBatchSize; ++i) {
+		transforms[i] = RandomTransform(random);
+		rotations[i] = MakeEulerQuaternion(transforms[i].rotate);
+		affines[i] = MakeAffineTransform(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+		matrices[i] = ToMatrix4x4(affines[i]);
+	}
+
+	benchmark.Run("MakeAffineMatrix/scalar", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = MakeAffineMatrixScalar(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("MakeAffineMatrix/euler", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = MakeAffineMatrix(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("MakeAffineMatrix/quaternion", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = MakeAffineMatrixQuaternion(transforms[i].scale, rotations[i], transforms[i].translate);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("MakeAffineMatrixBatch", kBatchSize, [&]() {
+		MakeAffineMatrixBatch(transforms.data(), out.data(), kBatchSize);
+		DoNotOptimize(out[0]);
+	});
+
+	// 回転の補間
+	benchmark.Run("Quaternion/Nlerp", kBatchSize, [&]() {
+		Quaternion q = rotations[0];
+		for (size_t i = 1; i < kBatchSize; ++i) {
+			q = Nlerp(q, rotations[i], 0.5f);
+		}
+		DoNotOptimize(q);
+	});
+	benchmark.Run("Quaternion/Slerp", kBatchSize, [&]() {
+		Quaternion q = rotations[0];
+		for (size_t i = 1; i < kBatchSize; ++i) {
+			q = Slerp(q, rotations[i], 0.5f);
+		}
+		DoNotOptimize(q);
+	});
+
+	// 3x4専用の逆変換・合成と4x4の比較
+	benchmark.Run("AffineTransform/Inverse", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			affineOut[i] = Inverse(affines[i]);
+		}
+		DoNotOptimize(affineOut[0]);
+	});
+	benchmark.Run("AffineTransform/Compose", kBatchSize, [&]() {
+		for (size_t i = 0; i + 1 < kBatchSize; ++i) {
+			affineOut[i] = Compose(affines[i], affines[i + 1]);
+		}
+		DoNotOptimize(affineOut[0]);
+	});
+	benchmark.Run("Matrix4x4/InverseAffine", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = Inverse(matrices[i]);
+		}
+		DoNotOptimize(out[0]);
+	});
+}
+
+// 法線変換用の行列(均一スケールの割合で比べる)
+void RunNormalMatrixBenchmarks(Benchmark& benchmark, std::mt19937& random) {
+	std::vector<Matrix4x4> worlds(kBatchSize);
+	std::vector<Matrix3x3> out(kBatchSize);
+	std::vector<uint8_t> allUniform(kBatchSize, 1);
+	for (size_t i = 0; i < kBatchSize; ++i) {
+		Transform transform = RandomTransform(random);
+		worlds[i] = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+	}
+
+	benchmark.Run("MakeNormalMatrix/scalar", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = MakeNormalMatrix(worlds[i]);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("MakeNormalMatrixBatch/nonUniform", kBatchSize, [&]() {
+		MakeNormalMatrixBatch(worlds.data(), nullptr, out.data(), kBatchSize);
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("MakeNormalMatrixBatch/uniform", kBatchSize, [&]() {
+		MakeNormalMatrixBatch(worlds.data(), allUniform.data(), out.data(), kBatchSize);
+		DoNotOptimize(out[0]);
+	});
+}
+
+// ベクトル演算(法線の正規化・変換)
+void RunVectorBenchmarks(Benchmark& benchmark, std::mt19937& random) {
+	const size_t kCount = 10000;
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+	std::vector<Vector3> a(kCount), b(kCount), out(kCount);
+	std::vector<float> dots(kCount);
+	for (size_t i = 0; i < kCount; ++i) {
+		a[i] = {distribution(random), distribution(random), distribution(random)};
+		b[i] = {distribution(random), distribution(random), distribution(random)};
+	}
+	Matrix4x4 world = MakeAffineMatrix({1.0f, 2.0f, 3.0f}, {0.3f, 0.2f, 0.1f}, {4.0f, 5.0f, 6.0f});
+	AffineTransform affine = ToAffineTransform(world);
+
+	benchmark.Run("Normalize/scalar", kCount, [&]() {
+		for (size_t i = 0; i < kCount; ++i) {
+			out[i] = Normalize(a[i]);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("NormalizeBatch", kCount, [&]() {
+		NormalizeBatch(a.data(), out.data(), kCount);
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("Dot/scalar", kCount, [&]() {
+		for (size_t i = 0; i < kCount; ++i) {
+			dots[i] = Dot(a[i], b[i]);
+		}
+		DoNotOptimize(dots[0]);
+	});
+	benchmark.Run("DotBatch", kCount, [&]() {
+		DotBatch(a.data(), b.data(), dots.data(), kCount);
+		DoNotOptimize(dots[0]);
+	});
+	benchmark.Run("Cross/scalar", kCount, [&]() {
+		for (size_t i = 0; i < kCount; ++i) {
+			out[i] = Cross(a[i], b[i]);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("CrossBatch", kCount, [&]() {
+		CrossBatch(a.data(), b.data(), out.data(), kCount);
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("TransformPoint/scalar", kCount, [&]() {
+		for (size_t i = 0; i < kCount; ++i) {
+			out[i] = TransformPoint(a[i], affine);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("TransformPointBatch", kCount, [&]() {
+		TransformPointBatch(a.data(), world, out.data(), kCount);
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("TransformNormal/scalar", kCount, [&]() {
+		for (size_t i = 0; i < kCount; ++i) {
+			out[i] = Normalize(TransformDirection(a[i], affine));
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("TransformNormalBatch", kCount, [&]() {
+		TransformNormalBatch(a.data(), world, out.data(), kCount);
+		DoNotOptimize(out[0]);
+	});
+}
+
+// 投影行列
+void RunProjectionBenchmarks(Benchmark& benchmark) {
+	std::vector<Matrix4x4> out(kBatchSize);
+	// 実行時の値にして定数畳み込みさせない
+	volatile float fovY = 0.45f;
+	volatile float width = 1280.0f;
+	volatile float height = 720.0f;
+
+	benchmark.Run("MakePerspectiveFovMatrix", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = MakePerspectiveFovMatrix(fovY, width / height, 0.1f, 100.0f);
+		}
+		DoNotOptimize(out[0]);
+	});
+	benchmark.Run("MakeOrthographicMatrix", kBatchSize, [&]() {
+		for (size_t i = 0; i < kBatchSize; ++i) {
+			out[i] = MakeOrthographicMatrix(0.0f, 0.0f, width, height, 0.0f, 100.0f);
+		}
+		DoNotOptimize(out[0]);
+	});
+}
+
+// オブジェクトごとのWVP計算とTransformBatchの比較
+void RunTransformBatchBenchmarks(Benchmark& benchmark, std::mt19937& random) {
+	Matrix4x4 viewProjection = Multiply(ToMatrix4x4(Inverse(MakeAffineTransform({1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -5.0f}))), MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+	// 毎回スレッドを作らないように、全ての数で同じワーカースレッドを使う
+	WorkerPool workerPool;
+
+	for (size_t count : {size_t(1000), size_t(10000), size_t(100000)}) {
+		std::vector<Transform> transforms(count);
+		TransformBatch batch;
+		batch.Resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			transforms[i] = RandomTransform(random);
+			batch.SetTransform(i, transforms[i]);
+		}
+		std::vector<TransformBatch::TransformationMatrix> out(count);
+
+		std::string suffix = "/" + std::to_string(count);
+		benchmark.Run("TransformPerObject" + suffix, count, [&]() {
+			for (size_t i = 0; i < count; ++i) {
+				Matrix4x4 world = MakeAffineMatrixScalar(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+				out[i].WVP = MultiplyScalar(world, viewProjection);
+				out[i].World = world;
+			}
+			DoNotOptimize(out[0]);
+		});
+		benchmark.Run("TransformBatch" + suffix, count, [&]() {
+			batch.Update(viewProjection, out.data());
+			DoNotOptimize(out[0]);
+		});
+		benchmark.Run("TransformBatch/workerPool" + suffix, count, [&]() {
+			batch.Update(viewProjection, out.data(), workerPool);
+			DoNotOptimize(out[0]);
+		});
+	}
+}
+
+// ほとんどが画面外にある場合のカリング
+void RunCullingBenchmarks(Benchmark& benchmark, std::mt19937& random) {
+	const size_t kCount = 100000;
+	Matrix4x4 viewProjection = Multiply(ToMatrix4x4(Inverse(MakeAffineTransform({1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -5.0f}))), MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+	Frustum frustum = MakeFrustum(viewProjection);
+
+	// 広い範囲にばらまくので、視錐台・画面内に入るのは数%
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> size(0.5f, 2.0f);
+	std::vector<BoundingSphere> spheres(kCount);
+	std::vector<AABB> boxes(kCount);
+	std::vector<Rect2D> rects(kCount);
+	for (size_t i = 0; i < kCount; ++i) {
+		Vector3 center = {position(random), position(random), position(random)};
+		float radius = size(random);
+		spheres[i] = {center, radius};
+		boxes[i] = {center - Vector3{radius, radius, radius}, center + Vector3{radius, radius, radius}};
+		float x = position(random) * 20.0f;
+		float y = position(random) * 20.0f;
+		rects[i] = {x, y, x + radius * 32.0f, y + radius * 32.0f};
+	}
+	std::vector<uint32_t> visible(kCount);
+
+	benchmark.Run("CullSpheres/mostlyOffscreen", kCount, [&]() { DoNotOptimize(CullSpheres(frustum, spheres.data(), kCount, visible.data())); });
+	benchmark.Run("CullAABBs/mostlyOffscreen", kCount, [&]() { DoNotOptimize(CullAABBs(frustum, boxes.data(), kCount, visible.data())); });
+	benchmark.Run("CullRects/mostlyOffscreen", kCount, [&]() { DoNotOptimize(CullRects({0.0f, 0.0f, 1280.0f, 720.0f}, rects.data(), kCount, visible.data())); });
+}
+
+// 平面の表側からの距離(Culling.cppと同じ順番で足す)
+float PlaneDistance(const Plane& plane, const Vector3& point) {
+	return (point.x * plane.normal.x + point.y * plane.normal.y) + (point.z * plane.normal.z + plane.distance);
+}
+
+// スカラー版の球のカリング
+std::vector<uint32_t> CullSpheresScalar(const Frustum& frustum, const std::vector<BoundingSphere>& spheres) {
+	std::vector<uint32_t> visible;
+	for (size_t i = 0; i < spheres.size(); ++i) {
+		bool inside = true;
+		for (const Plane& plane : frustum.planes) {
+			inside = inside && PlaneDistance(plane, spheres[i].center) >= -spheres[i].radius;
+		}
+		if (inside) {
+			visible.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	return visible;
+}
+
+// スカラー版のAABBのカリング
+std::vector<uint32_t> CullAABBsScalar(const Frustum& frustum, const std::vector<AABB>& boxes) {
+	std::vector<uint32_t> visible;
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		bool inside = true;
+		for (const Plane& plane : frustum.planes) {
+			Vector3 farthest = {
+			    plane.normal.x >= 0.0f ? boxes[i].max.x : boxes[i].min.x,
+			    plane.normal.y >= 0.0f ? boxes[i].max.y : boxes[i].min.y,
+			    plane.normal.z >= 0.0f ? boxes[i].max.z : boxes[i].min.z,
+			};
+			inside = inside && PlaneDistance(plane, farthest) >= 0.0f;
+		}
+		if (inside) {
+			visible.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	return visible;
+}
+
+// スカラー版の矩形のカリング
+std::vector<uint32_t> CullRectsScalar(const Rect2D& viewport, const std::vector<Rect2D>& rects) {
+	std::vector<uint32_t> visible;
+	for (size_t i = 0; i < rects.size(); ++i) {
+		const Rect2D& rect = rects[i];
+		if (rect.left <= viewport.right && rect.right >= viewport.left && rect.top <= viewport.bottom && rect.bottom >= viewport.top) {
+			visible.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	return visible;
+}
+
+} // namespace
+
+// SIMD版・バッチ版の行列計算と3x4専用の計算をスカラー版の4x4の計算と比べる
+bool RunMathCheck() {
+	std::mt19937 random(4242);
+	// バッチ版は4つずつの端数が出るように数を変える
+	const size_t kCounts[] = {1, 2, 3, 4, 5, 6, 7, 1027};
+	const size_t kMaxCount = 1027;
+	std::vector<Matrix4x4> a(kMaxCount), b(kMaxCount), invertible(kMaxCount), out(kMaxCount);
+	std::vector<Transform> transforms(kMaxCount);
+	for (size_t i = 0; i < kMaxCount; ++i) {
+		a[i] = RandomMatrix(random);
+		b[i] = RandomMatrix(random);
+		invertible[i] = RandomInvertibleMatrix(random);
+		transforms[i] = RandomTransform(random);
+	}
+
+	float multiplyError = 0.0f;
+	float inverseError = 0.0f;
+	float affineError = 0.0f;
+	for (size_t i = 0; i < kMaxCount; ++i) {
+		multiplyError = std::max(multiplyError, MaxRelativeError(Multiply(a[i], b[i]), MultiplyScalar(a[i], b[i])));
+		inverseError = std::max(inverseError, MaxRelativeError(Inverse(invertible[i]), InverseScalar(invertible[i])));
+		affineError = std::max(affineError, MaxRelativeError(MakeAffineMatrix(transforms[i].scale, transforms[i].rotate, transforms[i].translate),
+		                                                     MakeAffineMatrixScalar(transforms[i].scale, transforms[i].rotate, transforms[i].translate)));
+	}
+
+	float multiplyBatchError = 0.0f;
+	float sharedRhsError = 0.0f;
+	float inverseBatchError = 0.0f;
+	float affineBatchError = 0.0f;
+	for (size_t count : kCounts) {
+		// 書き込まれなかった要素が分かるように、先に0以外で埋めておく
+		std::fill(out.begin(), out.end(), Matrix4x4{{{1e9f}}});
+		MultiplyBatch(a.data(), b.data(), out.data(), count);
+		for (size_t i = 0; i < count; ++i) {
+			multiplyBatchError = std::max(multiplyBatchError, MaxRelativeError(out[i], MultiplyScalar(a[i], b[i])));
+		}
+		std::fill(out.begin(), out.end(), Matrix4x4{{{1e9f}}});
+		MultiplyBatch(a.data(), b[0], out.data(), count);
+		for (size_t i = 0; i < count; ++i) {
+			sharedRhsError = std::max(sharedRhsError, MaxRelativeError(out[i], MultiplyScalar(a[i], b[0])));
+		}
+		std::fill(out.begin(), out.end(), Matrix4x4{{{1e9f}}});
+		InverseBatch(invertible.data(), out.data(), count);
+		for (size_t i = 0; i < count; ++i) {
+			inverseBatchError = std::max(inverseBatchError, MaxRelativeError(out[i], InverseScalar(invertible[i])));
+		}
+		std::fill(out.begin(), out.end(), Matrix4x4{{{1e9f}}});
+		MakeAffineMatrixBatch(transforms.data(), out.data(), count);
+		for (size_t i = 0; i < count; ++i) {
+			affineBatchError = std::max(affineBatchError, MaxRelativeError(out[i], MakeAffineMatrixScalar(transforms[i].scale, transforms[i].rotate, transforms[i].translate)));
+		}
+	}
+
+	// 3x4専用の計算は4x4の一般的な計算と比べる
+	// 不均一な拡縮と回転を2回合成して、せん断を含むものも作る
+	float affineInverseError = 0.0f;
+	float composeError = 0.0f;
+	float transformPointError = 0.0f;
+	std::uniform_real_distribution<float> pointDistribution(-10.0f, 10.0f);
+	for (size_t i = 0; i < kMaxCount; ++i) {
+		AffineTransform a1 = RandomAffineTransform(random);
+		AffineTransform a2 = RandomAffineTransform(random);
+		AffineTransform sheared = Compose(a1, a2);
+		for (const AffineTransform& affine : {a1, sheared}) {
+			affineInverseError = std::max(affineInverseError, MaxRelativeError(ToMatrix4x4(Inverse(affine)), InverseScalar(ToMatrix4x4(affine))));
+		}
+		composeError = std::max(composeError, MaxRelativeError(ToMatrix4x4(sheared), MultiplyScalar(ToMatrix4x4(a1), ToMatrix4x4(a2))));
+
+		// 点は(x, y, z, 1)の行ベクトルとして4x4行列を掛けたものと比べる
+		Vector3 point = {pointDistribution(random), pointDistribution(random), pointDistribution(random)};
+		Matrix4x4 pointMatrix = {{{point.x, point.y, point.z, 1.0f}}};
+		Matrix4x4 expected = MultiplyScalar(pointMatrix, ToMatrix4x4(sheared));
+		Vector3 transformed = TransformPoint(point, sheared);
+		Matrix4x4 actual = {{{transformed.x, transformed.y, transformed.z, 1.0f}}};
+		transformPointError = std::max(transformPointError, MaxRelativeError(actual, expected));
+	}
+
+	bool passed = true;
+	std::printf("%-32s %14s\n", "math vs scalar", "maxRelError");
+	passed = PrintMathError("Multiply", multiplyError) && passed;
+	passed = PrintMathError("Inverse", inverseError) && passed;
+	passed = PrintMathError("MakeAffineMatrix", affineError) && passed;
+	passed = PrintMathError("MultiplyBatch", multiplyBatchError) && passed;
+	passed = PrintMathError("MultiplyBatch/sharedRhs", sharedRhsError) && passed;
+	passed = PrintMathError("InverseBatch", inverseBatchError) && passed;
+	passed = PrintMathError("MakeAffineMatrixBatch", affineBatchError) && passed;
+	passed = PrintMathError("AffineTransform/Inverse", affineInverseError) && passed;
+	passed = PrintMathError("AffineTransform/Compose", composeError) && passed;
+	passed = PrintMathError("AffineTransform/TransformPoint", transformPointError) && passed;
+	std::printf("\n");
+	return passed;
+}
+
+// 視錐台・ビューポートのカリングをスカラー版の平面・矩形の判定と比べる
+bool RunCullingCheck() {
+	std::mt19937 random(1618);
+	Matrix4x4 viewProjection = Multiply(ToMatrix4x4(Inverse(MakeAffineTransform({1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -5.0f}))), MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+	Frustum frustum = MakeFrustum(viewProjection);
+	const Rect2D viewport = {0.0f, 0.0f, 1280.0f, 720.0f};
+
+	// 半分くらいが見えるように、視錐台・画面の境目をまたぐ範囲にばらまく
+	std::uniform_real_distribution<float> positionXY(-20.0f, 20.0f);
+	std::uniform_real_distribution<float> positionZ(-10.0f, 110.0f);
+	std::uniform_real_distribution<float> size(0.1f, 3.0f);
+	std::uniform_real_distribution<float> screenX(-300.0f, 1500.0f);
+	std::uniform_real_distribution<float> screenY(-300.0f, 1000.0f);
+
+	// 4つずつの端数が出るように数を変える
+	const size_t kCounts[] = {0, 1, 2, 3, 5, 6, 7, 9, 1023};
+	bool passed = true;
+	for (size_t count : kCounts) {
+		// 範囲外を読んでいないかも分かるように、ちょうどの大きさで作る
+		std::vector<BoundingSphere> spheres(count);
+		std::vector<AABB> boxes(count);
+		std::vector<Rect2D> rects(count);
+		for (size_t i = 0; i < count; ++i) {
+			Vector3 center = {positionXY(random), positionXY(random), positionZ(random)};
+			float radius = size(random);
+			spheres[i] = {center, radius};
+			boxes[i] = {center - Vector3{radius, radius * 0.5f, radius * 2.0f}, center + Vector3{radius, radius * 0.5f, radius * 2.0f}};
+			float x = screenX(random);
+			float y = screenY(random);
+			rects[i] = {x, y, x + radius * 64.0f, y + radius * 32.0f};
+			// 境目にぴったり接する矩形も混ぜる(接していれば表示)
+			if (i % 5 == 4) {
+				rects[i] = i % 2 == 0 ? Rect2D{viewport.right, y, viewport.right + 10.0f, y + 10.0f} : Rect2D{x, viewport.top - 10.0f, x + 10.0f, viewport.top};
+			}
+		}
+
+		// 書き込みすぎが分かるように、要素数より多めに取って埋めておく
+		std::vector<uint32_t> visible(count + 4, UINT32_MAX);
+		size_t visibleCount = CullSpheres(frustum, spheres.data(), count, visible.data());
+		passed = passed && std::vector<uint32_t>(visible.begin(), visible.begin() + visibleCount) == CullSpheresScalar(frustum, spheres) && visible[visibleCount] == UINT32_MAX;
+		std::fill(visible.begin(), visible.end(), UINT32_MAX);
+		visibleCount = CullAABBs(frustum, boxes.data(), count, visible.data());
+		passed = passed && std::vector<uint32_t>(visible.begin(), visible.begin() + visibleCount) == CullAABBsScalar(frustum, boxes) && visible[visibleCount] == UINT32_MAX;
+		std::fill(visible.begin(), visible.end(), UINT32_MAX);
+		visibleCount = CullRects(viewport, rects.data(), count, visible.data());
+		passed = passed && std::vector<uint32_t>(visible.begin(), visible.begin() + visibleCount) == CullRectsScalar(viewport, rects) && visible[visibleCount] == UINT32_MAX;
+	}
+
+	std::printf("culling %s\n\n", passed ? "" : "FAILED");
+	return passed;
+}
+
+// 数学関数のベンチマーク
+void RunMathBenchmarks(Benchmark& benchmark) {
+	std::mt19937 random(2319);
+	RunMatrixBenchmarks(benchmark, random);
+	RunAffineBenchmarks(benchmark, random);
+	RunNormalMatrixBenchmarks(benchmark, random);
+	RunVectorBenchmarks(benchmark, random);
+	RunProjectionBenchmarks(benchmark);
+	RunTransformBatchBenchmarks(benchmark, random);
+	RunCullingBenchmarks(benchmark, random);
+}
@@ -0,0 +1,154 @@
+#include "2d/NineSliceSprite.h"
+#include "2d/SpriteBatchBuilder.h"
+#include "2d/SpriteSystem.h"
+#include "Benchmark.h"
+#include "base/Math.h"
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+// 計測するパネル数
+const uint32_t kPanelCount = 2000;
+// 9分割の枚数
+const uint32_t kSliceCount = 9;
+
+// パネルの画像(1024x1024のページの中の128x64)と枠の幅
+const SpriteTextureRegion kPanelRegion = {3, {1024.0f, 1024.0f}, {256.0f, 0.0f}, {128.0f, 64.0f}};
+const NineSliceInsets kPanelInsets = {16.0f, 8.0f, 16.0f, 8.0f};
+
+bool IsVertex(const SpriteVertex& vertex, float x, float y, float u, float v) {
+	return vertex.position.x == x && vertex.position.y == y && vertex.texcoord.x == u && vertex.texcoord.y == v;
+}
+
+// 1方向の区切り(NineSliceSpriteと同じく、枠の幅の合計より小さければ枠を縮める)
+void ComputeSliceEdges(float start, float length, float insetStart, float insetEnd, float outEdges[4]) {
+	float insetSum = insetStart + insetEnd;
+	float shrink = insetSum > length ? length / insetSum : 1.0f;
+	outEdges[0] = start;
+	outEdges[1] = start + insetStart * shrink;
+	outEdges[2] = start + length - insetEnd * shrink;
+	outEdges[3] = start + length;
+}
+
+} // namespace
+
+// 9分割の頂点・インデックスと、バッチに積んだときのランを調べる
+bool RunNineSliceCheck() {
+	NineSliceSprite panel(kPanelRegion, kPanelInsets);
+	panel.SetPosition({10.0f, 20.0f});
+	panel.SetSize({200.0f, 100.0f});
+	bool passed = panel.Update() && !panel.Update();
+
+	// 四隅は画像と同じ大きさのまま、辺と中央が伸びる(左上から横に4つずつ)
+	const SpriteVertex* vertices = panel.GetVertices();
+	passed = passed && IsVertex(vertices[0], 10.0f, 20.0f, 256.0f / 1024.0f, 0.0f);
+	passed = passed && IsVertex(vertices[5], 26.0f, 28.0f, 272.0f / 1024.0f, 8.0f / 1024.0f);
+	passed = passed && IsVertex(vertices[10], 194.0f, 112.0f, 368.0f / 1024.0f, 56.0f / 1024.0f);
+	passed = passed && IsVertex(vertices[15], 210.0f, 120.0f, 384.0f / 1024.0f, 64.0f / 1024.0f);
+
+	// 枠の幅より小さくしたら枠を縮める(UVはそのまま)
+	panel.SetSize({16.0f, 100.0f});
+	passed = passed && panel.Update() && vertices[1].position.x == 18.0f && vertices[2].position.x == 18.0f && vertices[2].texcoord.x == 368.0f / 1024.0f;
+	// 変わらない値を入れても作り直さない
+	panel.SetSize({16.0f, 100.0f});
+	panel.SetColor({1.0f, 1.0f, 1.0f, 1.0f});
+	passed = passed && !panel.Update();
+
+	// インデックスは3x3のマスを四角形と同じ順番で並べ、2つ目は16頂点ずらす
+	std::vector<uint32_t> indices(NineSliceSprite::kIndexCount * 2);
+	NineSliceSprite::WriteIndices(indices.data(), 2);
+	passed = passed && indices[0] == 4 && indices[1] == 0 && indices[2] == 5 && indices[3] == 0 && indices[4] == 1 && indices[5] == 5;
+	passed = passed && indices[53] == 15 && indices[54] == 20 && *std::max_element(indices.begin(), indices.end()) == 31;
+
+	// 四角形と9分割はランを分け、9分割は4枚分の場所を使う
+	std::vector<SpriteVertex> batchVertices(6 * SpriteBatchBuilder::kVertexCountPerSprite);
+	SpriteBatchBuilder builder;
+	builder.SetDestination(batchVertices.data(), 6);
+	SpriteQuad quad = {};
+	passed = passed && builder.Add(quad, kIdentity4x4, {1.0f, 1.0f, 1.0f, 1.0f}, 3, BlendMode::kNormal);
+	passed = passed && builder.Add(panel) && !builder.Add(panel);
+	passed = passed && builder.Add(quad, kIdentity4x4, {1.0f, 1.0f, 1.0f, 1.0f}, 3, BlendMode::kNormal);
+	const std::vector<SpriteBatchBuilder::Run>& runs = builder.GetRuns();
+	passed = passed && builder.GetSpriteCount() == 6 && runs.size() == 3 && runs[1].mesh == SpriteMesh::kNineSlice && runs[1].firstSprite == 1 && runs[1].spriteCount == 1;
+	passed = passed && runs[2].mesh == SpriteMesh::kQuad && runs[2].firstSprite == 5;
+	passed = passed && batchVertices[4 + 15].position == vertices[15].position;
+
+	std::printf("nine-slice %s\n\n", passed ? "" : "FAILED");
+	return passed;
+}
+
+// UIのパネルを毎フレーム伸び縮みさせて積む(9枚のスプライトに分ける場合と、16頂点のメッシュ1つの比較)
+void RunNineSliceBenchmarks(Benchmark& benchmark) {
+	SpriteBatchBuilder builder;
+	std::vector<SpriteVertex> vertices(static_cast<size_t>(kPanelCount) * kSliceCount * SpriteBatchBuilder::kVertexCountPerSprite);
+	builder.SetDestination(vertices.data(), kPanelCount * kSliceCount);
+	uint32_t frame = 0;
+	auto panelWidth = [&](uint32_t panel) { return 160.0f + static_cast<float>((frame + panel) % 64); };
+
+	// 9枚のスプライト: 1枚ごとに画像の範囲を切り分け、毎フレーム9枚の座標と大きさを設定する
+	SpriteSystem system;
+	std::vector<SpriteHandle> slices(static_cast<size_t>(kPanelCount) * kSliceCount);
+	for (uint32_t panel = 0; panel < kPanelCount; ++panel) {
+		float us[4];
+		float vs[4];
+		ComputeSliceEdges(kPanelRegion.origin.x, kPanelRegion.size.x, kPanelInsets.left, kPanelInsets.right, us);
+		ComputeSliceEdges(kPanelRegion.origin.y, kPanelRegion.size.y, kPanelInsets.top, kPanelInsets.bottom, vs);
+		for (uint32_t slice = 0; slice < kSliceCount; ++slice) {
+			uint32_t row = slice / 3;
+			uint32_t column = slice % 3;
+			SpriteTextureRegion region = kPanelRegion;
+			region.origin = {us[column], vs[row]};
+			region.size = {us[column + 1] - us[column], vs[row + 1] - vs[row]};
+			slices[panel * kSliceCount + slice] = system.Create(region);
+		}
+	}
+	std::vector<uint32_t> indices(slices.size());
+	std::iota(indices.begin(), indices.end(), 0u);
+	benchmark.Run("NineSlice/nineSprites", kPanelCount, [&]() {
+		++frame;
+		for (uint32_t panel = 0; panel < kPanelCount; ++panel) {
+			float xs[4];
+			float ys[4];
+			ComputeSliceEdges(0.0f, panelWidth(panel), kPanelInsets.left, kPanelInsets.right, xs);
+			ComputeSliceEdges(static_cast<float>(panel), 48.0f, kPanelInsets.top, kPanelInsets.bottom, ys);
+			for (uint32_t slice = 0; slice < kSliceCount; ++slice) {
+				uint32_t row = slice / 3;
+				uint32_t column = slice % 3;
+				SpriteHandle handle = slices[panel * kSliceCount + slice];
+				system.SetPosition(handle, {xs[column], ys[row]});
+				system.SetSize(handle, {xs[column + 1] - xs[column], ys[row + 1] - ys[row]});
+			}
+		}
+		system.Update();
+		builder.Clear();
+		builder.Add(system, indices.data(), indices.size());
+		DoNotOptimize(vertices[0]);
+	});
+
+	// 9分割スプライト: 大きさを設定して16頂点を作り直し、そのままコピーする
+	std::vector<NineSliceSprite> panels(kPanelCount, NineSliceSprite(kPanelRegion, kPanelInsets));
+	for (uint32_t panel = 0; panel < kPanelCount; ++panel) {
+		panels[panel].SetPosition({0.0f, static_cast<float>(panel)});
+	}
+	benchmark.Run("NineSlice/mesh", kPanelCount, [&]() {
+		++frame;
+		builder.Clear();
+		for (uint32_t panel = 0; panel < kPanelCount; ++panel) {
+			panels[panel].SetSize({panelWidth(panel), 48.0f});
+			panels[panel].Update();
+			builder.Add(panels[panel]);
+		}
+		DoNotOptimize(vertices[0]);
+	});
+
+	// 計測しなかった場合(--filter)は表示しない
+	if (!benchmark.GetResults().empty() && benchmark.GetResults().back().name == "NineSlice/mesh") {
+		std::printf("NineSlice draw calls (%u panels)\n", kPanelCount);
+		std::printf("  perSprite   : %u\n", kPanelCount * kSliceCount);
+		std::printf("  batch/mesh  : %zu\n", builder.GetRuns().size());
+		std::printf("  vertices    : %u -> %u per panel\n\n", kSliceCount * SpriteBatchBuilder::kVertexCountPerSprite, NineSliceSprite::kVertexCount);
+	}
+}
@@ -0,0 +1,207 @@
+#include "2d/SpriteBatchBuilder.h"
+#include "2d/SpriteInstance.h"
+#include "2d/SpriteSystem.h"
+#include "Benchmark.h"
+#include "base/WorkerPool.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 計測するスプライト数
+const uint32_t kSpriteCount = 50000;
+// テクスチャの種類
+const uint32_t kTextureCount = 8;
+
+// テクスチャ・ブレンド・親ノードが混ざったスプライトを作る(同じseedなら同じ中身になる)
+void MakeSprites(SpriteSystem& system, SceneGraph& sceneGraph, SceneNodeId parentNode, uint32_t count, std::vector<SpriteHandle>& handles) {
+	std::mt19937 random(8128);
+	std::uniform_real_distribution<float> position(0.0f, 1280.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> size(16.0f, 128.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	handles.resize(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		// 同じテクスチャが数枚ずつ続く(ランがある程度まとまる)
+		SpriteHandle handle = system.Create(i / 3 % kTextureCount, {256.0f, 256.0f});
+		system.SetPosition(handle, {position(random), position(random)});
+		system.SetRotation(handle, angle(random));
+		system.SetSize(handle, {size(random), size(random)});
+		system.SetAnchorPoint(handle, {unit(random), unit(random)});
+		system.SetColor(handle, {unit(random), unit(random), unit(random), 1.0f});
+		system.SetBlendMode(handle, static_cast<BlendMode>(i * 7 % static_cast<uint32_t>(BlendMode::kCount)));
+		system.SetIsFlipX(handle, i % 3 == 0);
+		if (i % 4 == 0) {
+			system.SetParentNode(handle, &sceneGraph, parentNode);
+		}
+		handles[i] = handle;
+	}
+}
+
+// 1フレーム分の出力
+struct FrameOutput {
+	std::vector<SpriteVertex> vertices;
+	std::vector<SpriteBatchBuilder::Run> runs;
+	std::vector<SpriteInstance> instances;
+	std::vector<SpriteInstanceBuilder::Range> ranges;
+	uint32_t rebuildCount = 0;
+};
+
+// indicesのスプライトを計算して頂点とインスタンスを書き込む(workerPoolがnullなら1スレッド)
+// firstCount枚だけ先に積み、残りを後から積む(積んである状態から続けて積めるか)
+FrameOutput BuildFrame(WorkerPool* workerPool, const std::vector<uint32_t>& indices, size_t firstCount) {
+	SpriteSystem system;
+	SceneGraph sceneGraph;
+	SceneNodeId parentNode = sceneGraph.CreateNode(kInvalidSceneNode, {
+	                                                                      {1.5f, 0.5f, 1.0f},
+	                                                                      {0.0f, 0.0f, 0.3f},
+	                                                                      {20.0f, -10.0f, 0.0f}
+    });
+	sceneGraph.Update();
+	std::vector<SpriteHandle> handles;
+	MakeSprites(system, sceneGraph, parentNode, 20000, handles);
+
+	FrameOutput output;
+	const uint32_t count = static_cast<uint32_t>(indices.size());
+	output.vertices.resize(static_cast<size_t>(count) * SpriteBatchBuilder::kVertexCountPerSprite);
+	output.instances.resize(count);
+	SpriteBatchBuilder vertexBuilder;
+	vertexBuilder.SetDestination(output.vertices.data(), count);
+	SpriteInstanceBuilder instanceBuilder;
+	instanceBuilder.SetDestination(output.instances.data(), count);
+
+	if (workerPool) {
+		system.Update(indices.data(), indices.size(), *workerPool);
+	} else {
+		system.Update(indices.data(), indices.size());
+	}
+	vertexBuilder.Add(system, indices.data(), firstCount, workerPool);
+	vertexBuilder.Add(system, indices.data() + firstCount, indices.size() - firstCount, workerPool);
+	instanceBuilder.Add(system, indices.data(), firstCount, workerPool);
+	instanceBuilder.Add(system, indices.data() + firstCount, indices.size() - firstCount, workerPool);
+
+	output.runs = vertexBuilder.GetRuns();
+	output.ranges = instanceBuilder.GetRanges();
+	output.rebuildCount = system.GetRebuildCount();
+	// 入りきらなければ何も積まない
+	if (vertexBuilder.Add(system, indices.data(), 1, workerPool) || instanceBuilder.Add(system, indices.data(), 1, workerPool)) {
+		output.rebuildCount = 0;
+	}
+	return output;
+}
+
+bool IsSameFrame(const FrameOutput& a, const FrameOutput& b) {
+	bool passed = a.rebuildCount == b.rebuildCount && a.runs.size() == b.runs.size() && a.ranges.size() == b.ranges.size();
+	passed = passed && std::memcmp(a.vertices.data(), b.vertices.data(), sizeof(SpriteVertex) * a.vertices.size()) == 0;
+	passed = passed && std::memcmp(a.instances.data(), b.instances.data(), sizeof(SpriteInstance) * a.instances.size()) == 0;
+	for (size_t i = 0; passed && i < a.runs.size(); ++i) {
+		const SpriteBatchBuilder::Run& x = a.runs[i];
+		const SpriteBatchBuilder::Run& y = b.runs[i];
+		passed = x.textureIndex == y.textureIndex && x.blendMode == y.blendMode && x.firstSprite == y.firstSprite && x.spriteCount == y.spriteCount;
+	}
+	for (size_t i = 0; passed && i < a.ranges.size(); ++i) {
+		const SpriteInstanceBuilder::Range& x = a.ranges[i];
+		const SpriteInstanceBuilder::Range& y = b.ranges[i];
+		passed = x.blendMode == y.blendMode && x.firstInstance == y.firstInstance && x.instanceCount == y.instanceCount;
+	}
+	return passed;
+}
+
+} // namespace
+
+// ワーカースレッドで分けても1スレッドと同じ結果になるか調べる
+bool RunParallelSpriteCheck() {
+	// ParallelForは全ての位置をちょうど1回ずつ実行する(割り切れない数・スレッドより少ない範囲数も含める)
+	bool passed = true;
+	WorkerPool workerPool(4);
+	std::vector<uint32_t> hits;
+	for (size_t count : {0, 1, 99, 100, 101, 10007}) {
+		for (int repeat = 0; repeat < 50; ++repeat) {
+			hits.assign(count, 0);
+			workerPool.ParallelFor(count, 100, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					++hits[i];
+				}
+			});
+			for (uint32_t hit : hits) {
+				passed = passed && hit == 1;
+			}
+		}
+	}
+
+	// 見えている分だけ(5枚に1枚を抜く)を計算して書き込む
+	std::vector<uint32_t> indices;
+	for (uint32_t i = 0; i < 20000; ++i) {
+		if (i % 5 != 2) {
+			indices.push_back(i);
+		}
+	}
+	FrameOutput expected = BuildFrame(nullptr, indices, 1);
+	passed = passed && expected.rebuildCount == indices.size();
+	for (uint32_t threadCount : {1u, 3u, 4u}) {
+		WorkerPool pool(threadCount);
+		passed = passed && IsSameFrame(expected, BuildFrame(&pool, indices, 1)) && IsSameFrame(expected, BuildFrame(&pool, indices, 4097));
+	}
+	std::printf("parallel sprite update (%zu sprites) %s\n\n", indices.size(), passed ? "" : "FAILED");
+	return passed;
+}
+
+// ワーカースレッドの数ごとの1フレーム分の時間
+// 全スプライトを動かし、範囲を求めて計算し直し、頂点かインスタンスを書き込む
+// (ハードウェアのスレッド数より多くしても速くはならない。差が出るのは4〜16コアの環境)
+void RunParallelSpriteBenchmarks(Benchmark& benchmark) {
+	SpriteSystem system;
+	SceneGraph sceneGraph;
+	SceneNodeId parentNode = sceneGraph.CreateNode(kInvalidSceneNode, {
+	                                                                      {1.0f, 1.0f, 1.0f},
+	                                                                      {0.0f, 0.0f, 0.0f},
+	                                                                      {0.0f, 0.0f, 0.0f}
+    });
+	sceneGraph.Update();
+	std::vector<SpriteHandle> handles;
+	MakeSprites(system, sceneGraph, parentNode, kSpriteCount, handles);
+	std::vector<uint32_t> indices(kSpriteCount);
+	for (uint32_t i = 0; i < kSpriteCount; ++i) {
+		indices[i] = i;
+	}
+	system.Update();
+
+	std::vector<Rect2D> bounds(kSpriteCount);
+	std::vector<SpriteVertex> vertices(static_cast<size_t>(kSpriteCount) * SpriteBatchBuilder::kVertexCountPerSprite);
+	SpriteBatchBuilder vertexBuilder;
+	vertexBuilder.SetDestination(vertices.data(), kSpriteCount);
+	std::vector<SpriteInstance> instances(kSpriteCount);
+	SpriteInstanceBuilder instanceBuilder;
+	instanceBuilder.SetDestination(instances.data(), kSpriteCount);
+
+	for (uint32_t threadCount : {1u, 2u, 4u, 8u, 16u}) {
+		WorkerPool workerPool(threadCount);
+		auto update = [&]() {
+			workerPool.ParallelFor(kSpriteCount, 2048, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					Vector2 position = system.GetPosition(handles[i]);
+					position.x += 0.1f;
+					system.SetPosition(handles[i], position);
+				}
+			});
+			system.ComputeBoundingRects(bounds.data(), workerPool);
+			system.Update(indices.data(), indices.size(), workerPool);
+		};
+		std::string suffix = "/threads=" + std::to_string(threadCount);
+		benchmark.Run("SpriteFrame/batch" + suffix, kSpriteCount, [&]() {
+			update();
+			vertexBuilder.Clear();
+			vertexBuilder.Add(system, indices.data(), indices.size(), &workerPool);
+			DoNotOptimize(vertices[0]);
+		});
+		benchmark.Run("SpriteFrame/instanced" + suffix, kSpriteCount, [&]() {
+			update();
+			instanceBuilder.Clear();
+			instanceBuilder.Add(system, indices.data(), indices.size(), &workerPool);
+			DoNotOptimize(instances[0]);
+		});
+	}
+}
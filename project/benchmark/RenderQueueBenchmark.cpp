@@ -0,0 +1,208 @@
+#include "2d/SpriteBatchBuilder.h"
+#include "2d/SpriteInstance.h"
+#include "2d/SpriteRenderQueue.h"
+#include "2d/SpriteSystem.h"
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// 計測する数
+const uint32_t kEntryCount = 100000;
+// レイヤー・テクスチャの種類
+const uint32_t kLayerCount = 4;
+const uint32_t kTextureCount = 64;
+
+// ゲームの1フレームに近いkey(レイヤー数枚、ブレンド2種類、アトラスのページ数十枚、奥行きはばらばら)
+std::vector<uint64_t> MakeKeys(uint32_t count, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> depth(-100.0f, 100.0f);
+	std::vector<uint64_t> keys(count);
+	for (uint64_t& key : keys) {
+		uint8_t layer = static_cast<uint8_t>(random() % kLayerCount);
+		BlendMode blendMode = random() % 4 == 0 ? BlendMode::kAdd : BlendMode::kNormal;
+		key = SpriteRenderQueue::MakeKey(layer, blendMode, random() % kTextureCount, depth(random));
+	}
+	return keys;
+}
+
+} // namespace
+
+// keyの並びと、基数ソートがstd::stable_sortと同じ順番になるかを調べる
+bool RunRenderQueueCheck() {
+	// keyの大小はレイヤー > 不透明が先 > (不透明)テクスチャ > 奥行き、(半透明)奥行き > ブレンド > テクスチャ(奥行きは奥が先)
+	bool passed = SpriteRenderQueue::MakeKey(0, BlendMode::kAdd, 1000, -5.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNone, 0, 5.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNone, 1000, -5.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 0, 5.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNone, 3, -5.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNone, 4, 5.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNone, 3, 2.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNone, 3, 1.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kAdd, 0, 5.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 1000, -5.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 4, 5.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 3, -5.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 1000, 5.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kAdd, 0, 5.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 3, 5.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 4, 5.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 3, 2.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 3, 1.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 3, -1.0f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 3, -2.0f);
+	passed = passed && SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 3, 0.5f) < SpriteRenderQueue::MakeKey(1, BlendMode::kNormal, 3, -0.5f);
+
+	// 同じkeyが多い並びでも、std::stable_sortと同じ順番(同じkeyは積んだ順)になる
+	SpriteRenderQueue queue;
+	std::vector<uint64_t> keys = MakeKeys(20000, 1);
+	for (size_t i = 0; i < keys.size(); i += 3) {
+		keys[i] = keys[i / 2];
+	}
+	for (uint32_t i = 0; i < keys.size(); ++i) {
+		queue.Push(keys[i], i);
+	}
+	queue.Sort();
+	std::vector<uint32_t> expected(keys.size());
+	std::iota(expected.begin(), expected.end(), 0u);
+	std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+	passed = passed && queue.GetCount() == keys.size() && std::equal(expected.begin(), expected.end(), queue.GetValues());
+	passed = passed && std::is_sorted(queue.GetKeys(), queue.GetKeys() + queue.GetCount());
+
+	// テクスチャ番号だけが違うなら、その桁だけ並べ替える
+	queue.Clear();
+	for (uint32_t i = 0; i < 100; ++i) {
+		queue.Push(SpriteRenderQueue::MakeKey(2, BlendMode::kNormal, (i * 37) % 100, 0.0f), i);
+	}
+	queue.Sort();
+	passed = passed && queue.GetSortPassCount() == 1 && queue.GetValues()[0] == 0 && queue.GetValues()[1] == 73;
+
+	// 一番多く積んだ後は同じ2つの配列を入れ替えて使うだけ(確保し直さない)
+	std::vector<const uint64_t*> buffers;
+	for (uint32_t frame = 0; frame < 8; ++frame) {
+		queue.Clear();
+		for (uint32_t i = 0; i < keys.size() - frame * 100; ++i) {
+			queue.Push(keys[(i + frame) % keys.size()], i);
+		}
+		queue.Sort();
+		if (std::find(buffers.begin(), buffers.end(), queue.GetKeys()) == buffers.end()) {
+			buffers.push_back(queue.GetKeys());
+		}
+	}
+	passed = passed && buffers.size() <= 2;
+
+	// SpriteSystemから積むと、配列の位置がレイヤー・テクスチャの順に並ぶ
+	SpriteSystem system;
+	SpriteHandle back = system.Create(5, {64.0f, 64.0f});
+	SpriteHandle front = system.Create(2, {64.0f, 64.0f});
+	SpriteHandle middle = system.Create(9, {64.0f, 64.0f});
+	system.SetLayer(back, 0);
+	system.SetLayer(front, 3);
+	system.SetLayer(middle, 1);
+	const uint32_t indices[] = {system.IndexOf(front), system.IndexOf(middle), system.IndexOf(back)};
+	queue.Clear();
+	queue.Push(system, indices, 3);
+	queue.Sort();
+	passed = passed && queue.GetValues()[0] == system.IndexOf(back) && queue.GetValues()[1] == system.IndexOf(middle) && queue.GetValues()[2] == system.IndexOf(front);
+
+	// 並べた順に積むと、インスタンシングでもレイヤーの順に描く(ブレンドモードごとにまとめて描くと、上のレイヤーのkNoneが下になる)
+	SpriteSystem mixedSystem;
+	SpriteHandle upperNone = mixedSystem.Create(0, {64.0f, 64.0f});
+	SpriteHandle lowerNormal = mixedSystem.Create(1, {64.0f, 64.0f});
+	SpriteHandle lowerAdd = mixedSystem.Create(2, {64.0f, 64.0f});
+	SpriteHandle upperNormal = mixedSystem.Create(3, {64.0f, 64.0f});
+	mixedSystem.SetLayer(upperNone, 1);
+	mixedSystem.SetLayer(upperNormal, 1);
+	mixedSystem.SetBlendMode(lowerNormal, BlendMode::kNormal);
+	mixedSystem.SetBlendMode(lowerAdd, BlendMode::kAdd);
+	mixedSystem.SetBlendMode(upperNormal, BlendMode::kNormal);
+	mixedSystem.Update();
+	const uint32_t mixedIndices[] = {0, 1, 2, 3};
+	queue.Clear();
+	queue.Push(mixedSystem, mixedIndices, 4);
+	queue.Sort();
+	std::vector<SpriteInstance> instances(4);
+	SpriteInstanceBuilder instanceBuilder;
+	instanceBuilder.SetDestination(instances.data(), 4);
+	instanceBuilder.Add(mixedSystem, queue.GetValues(), queue.GetCount());
+	const std::vector<SpriteInstanceBuilder::Range>& ranges = instanceBuilder.GetRanges();
+	passed = passed && ranges.size() == 4 && ranges[0].blendMode == BlendMode::kNormal && ranges[1].blendMode == BlendMode::kAdd;
+	passed = passed && ranges.size() == 4 && ranges[2].blendMode == BlendMode::kNone && ranges[3].blendMode == BlendMode::kNormal && ranges[2].firstInstance == 2;
+	passed = passed && instances[0].textureIndex == 1 && instances[1].textureIndex == 2 && instances[2].textureIndex == 0 && instances[3].textureIndex == 3;
+
+	// 同じレイヤーの半透明は、テクスチャやブレンドが違っても奥から手前に並ぶ(不透明はその前)
+	SpriteSystem depthSystem;
+	SpriteHandle nearNormal = depthSystem.Create(1, {64.0f, 64.0f});
+	SpriteHandle middleNormal = depthSystem.Create(7, {64.0f, 64.0f});
+	SpriteHandle farAdd = depthSystem.Create(3, {64.0f, 64.0f});
+	SpriteHandle nearNone = depthSystem.Create(9, {64.0f, 64.0f});
+	depthSystem.SetBlendMode(nearNormal, BlendMode::kNormal);
+	depthSystem.SetBlendMode(middleNormal, BlendMode::kNormal);
+	depthSystem.SetBlendMode(farAdd, BlendMode::kAdd);
+	depthSystem.SetDepth(nearNormal, 1.0f);
+	depthSystem.SetDepth(middleNormal, 2.0f);
+	depthSystem.SetDepth(farAdd, 3.0f);
+	depthSystem.SetDepth(nearNone, 0.0f);
+	const uint32_t depthIndices[] = {0, 1, 2, 3};
+	queue.Clear();
+	queue.Push(depthSystem, depthIndices, 4);
+	queue.Sort();
+	const uint32_t* depthOrder = queue.GetValues();
+	passed = passed && depthOrder[0] == depthSystem.IndexOf(nearNone) && depthOrder[1] == depthSystem.IndexOf(farAdd);
+	passed = passed && depthOrder[2] == depthSystem.IndexOf(middleNormal) && depthOrder[3] == depthSystem.IndexOf(nearNormal);
+
+	std::printf("render queue %s\n\n", passed ? "" : "FAILED");
+	return passed;
+}
+
+// 10万個のkeyを毎フレーム並べ替える(std::stable_sortと基数ソートの比較)
+void RunRenderQueueBenchmarks(Benchmark& benchmark) {
+	std::vector<uint64_t> keys = MakeKeys(kEntryCount, 2);
+
+	std::vector<std::pair<uint64_t, uint32_t>> pairs;
+	pairs.reserve(kEntryCount);
+	benchmark.Run("RenderQueue/stableSort", kEntryCount, [&]() {
+		pairs.clear();
+		for (uint32_t i = 0; i < kEntryCount; ++i) {
+			pairs.push_back({keys[i], i});
+		}
+		std::stable_sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		DoNotOptimize(pairs[0].second);
+	});
+
+	SpriteRenderQueue queue;
+	benchmark.Run("RenderQueue/radix", kEntryCount, [&]() {
+		queue.Clear();
+		for (uint32_t i = 0; i < kEntryCount; ++i) {
+			queue.Push(keys[i], i);
+		}
+		queue.Sort();
+		DoNotOptimize(queue.GetValues()[0]);
+	});
+
+	// 計測しなかった場合(--filter)は表示しない
+	if (benchmark.GetResults().empty() || benchmark.GetResults().back().name != "RenderQueue/radix") {
+		return;
+	}
+	// 同じ並びのスプライトを積んだときのラン(DrawCall)の数
+	SpriteSystem system;
+	std::mt19937 random(3);
+	for (uint32_t i = 0; i < kEntryCount; ++i) {
+		SpriteHandle sprite = system.Create(random() % kTextureCount, {64.0f, 64.0f});
+		system.SetLayer(sprite, static_cast<uint8_t>(random() % kLayerCount));
+		system.SetBlendMode(sprite, random() % 4 == 0 ? BlendMode::kAdd : BlendMode::kNormal);
+		system.SetDepth(sprite, static_cast<float>(random() % 200));
+	}
+	system.Update();
+	std::vector<uint32_t> indices(kEntryCount);
+	std::iota(indices.begin(), indices.end(), 0u);
+	std::vector<SpriteVertex> vertices(static_cast<size_t>(kEntryCount) * SpriteBatchBuilder::kVertexCountPerSprite);
+	SpriteBatchBuilder builder;
+	builder.SetDestination(vertices.data(), kEntryCount);
+	builder.Add(system, indices.data(), indices.size());
+	size_t unsortedRunCount = builder.GetRuns().size();
+	queue.Clear();
+	queue.Push(system, indices.data(), indices.size());
+	queue.Sort();
+	builder.Clear();
+	builder.Add(system, queue.GetValues(), queue.GetCount());
+	std::printf("RenderQueue draw calls (%u sprites, %u layers, %u textures)\n", kEntryCount, kLayerCount, kTextureCount);
+	std::printf("  unsorted    : %zu\n", unsortedRunCount);
+	std::printf("  sorted      : %zu\n", builder.GetRuns().size());
+	std::printf("  radix passes: %u / 8\n\n", queue.GetSortPassCount());
+}
@@ -0,0 +1,163 @@
+#include "Benchmark.h"
+#include "base/Math.h"
+#include "scene/SceneGraph.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 計測するルートノード数と、1つのルートの下のノード数
+const uint32_t kRootCount = 100;
+const uint32_t kNodeCountPerRoot = 100;
+
+Transform MakeRandomTransform(std::mt19937& random) {
+	std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> translate(-10.0f, 10.0f);
+	return {
+	    {scale(random),     scale(random),     scale(random)    },
+	    {angle(random),     angle(random),     angle(random)    },
+	    {translate(random), translate(random), translate(random)},
+	};
+}
+
+// 親をたどって全部計算し直したWorld行列(Updateの結果と比べる用)
+Matrix4x4 ComputeWorldMatrix(const SceneGraph& sceneGraph, SceneNodeId node) {
+	const Transform& local = sceneGraph.GetLocalTransform(node);
+	Matrix4x4 localMatrix = MakeAffineMatrix(local.scale, local.rotate, local.translate);
+	SceneNodeId parent = sceneGraph.GetParent(node);
+	return parent == kInvalidSceneNode ? localMatrix : Multiply(localMatrix, ComputeWorldMatrix(sceneGraph, parent));
+}
+
+// 生きている全ノードのWorld行列が、全部計算し直したものと同じか
+bool IsSameAsFullRecompute(const SceneGraph& sceneGraph, const std::vector<SceneNodeId>& nodes) {
+	bool isSame = sceneGraph.GetNodeCount() == nodes.size();
+	for (SceneNodeId node : nodes) {
+		Matrix4x4 expected = ComputeWorldMatrix(sceneGraph, node);
+		const Matrix4x4& actual = sceneGraph.GetWorldMatrix(node);
+		for (uint32_t row = 0; row < 4; ++row) {
+			for (uint32_t column = 0; column < 4; ++column) {
+				isSame = isSame && actual.m[row][column] == expected.m[row][column];
+			}
+		}
+	}
+	return isSame;
+}
+
+// ancestorがnode自身かその祖先か
+bool IsAncestorOrSelf(const SceneGraph& sceneGraph, SceneNodeId ancestor, SceneNodeId node) {
+	for (SceneNodeId i = node; i != kInvalidSceneNode; i = sceneGraph.GetParent(i)) {
+		if (i == ancestor) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace
+
+// 作成・親の変更・削除をでたらめに繰り返しても、Updateの結果が全部計算し直したものと同じか調べる
+bool RunSceneGraphCheck() {
+	bool passed = true;
+	std::mt19937 random(2718);
+	for (uint32_t sequence = 0; sequence < 200 && passed; ++sequence) {
+		SceneGraph sceneGraph;
+		std::vector<SceneNodeId> nodes;
+		for (uint32_t step = 0; step < 60; ++step) {
+			uint32_t operation = static_cast<uint32_t>(random() % 10);
+			if (nodes.empty() || operation < 3) {
+				// 作成(半分はルート)
+				SceneNodeId parent = nodes.empty() || random() % 2 == 0 ? kInvalidSceneNode : nodes[random() % nodes.size()];
+				nodes.push_back(sceneGraph.CreateNode(parent, MakeRandomTransform(random)));
+			} else if (operation < 6) {
+				sceneGraph.SetLocalTransform(nodes[random() % nodes.size()], MakeRandomTransform(random));
+			} else if (operation < 8) {
+				// 親の変更(自分の子孫は親にできないので、そのときはルートにする)
+				SceneNodeId node = nodes[random() % nodes.size()];
+				SceneNodeId parent = nodes[random() % nodes.size()];
+				sceneGraph.SetParent(node, IsAncestorOrSelf(sceneGraph, node, parent) ? kInvalidSceneNode : parent);
+			} else if (operation < 9) {
+				// 削除(子孫もまとめて消える)
+				SceneNodeId removed = nodes[random() % nodes.size()];
+				std::vector<SceneNodeId> remaining;
+				for (SceneNodeId node : nodes) {
+					if (!IsAncestorOrSelf(sceneGraph, removed, node)) {
+						remaining.push_back(node);
+					}
+				}
+				sceneGraph.DestroyNode(removed);
+				nodes.swap(remaining);
+			} else {
+				sceneGraph.Update();
+				passed = passed && IsSameAsFullRecompute(sceneGraph, nodes);
+			}
+		}
+		sceneGraph.Update();
+		passed = passed && IsSameAsFullRecompute(sceneGraph, nodes);
+	}
+
+	// 何も変えなければ計算し直さない。葉を動かせば1つ、ルートを動かせば子孫も計算し直す
+	SceneGraph sceneGraph;
+	SceneNodeId root = sceneGraph.CreateNode();
+	SceneNodeId child = sceneGraph.CreateNode(root);
+	SceneNodeId leaf = sceneGraph.CreateNode(child);
+	SceneNodeId other = sceneGraph.CreateNode();
+	sceneGraph.Update();
+	passed = passed && sceneGraph.GetRecomputedNodeCount() == 4;
+	uint32_t otherGeneration = sceneGraph.GetWorldGeneration(other);
+	sceneGraph.Update();
+	passed = passed && sceneGraph.GetRecomputedNodeCount() == 0;
+	// 同じ値を入れても変更にならない
+	sceneGraph.SetTranslate(leaf, {0.0f, 0.0f, 0.0f});
+	sceneGraph.Update();
+	passed = passed && sceneGraph.GetRecomputedNodeCount() == 0;
+	sceneGraph.SetTranslate(leaf, {1.0f, 0.0f, 0.0f});
+	sceneGraph.Update();
+	passed = passed && sceneGraph.GetRecomputedNodeCount() == 1;
+	sceneGraph.SetRotate(root, {0.0f, 0.0f, 1.0f});
+	sceneGraph.Update();
+	passed = passed && sceneGraph.GetRecomputedNodeCount() == 3 && sceneGraph.GetWorldGeneration(other) == otherGeneration;
+
+	std::printf("scene graph %s\n\n", passed ? "" : "FAILED");
+	return passed;
+}
+
+// 1万ノードのUpdate(何も動かない場合、1つのルートだけ動く場合、全ルートが動く場合)
+void RunSceneGraphBenchmarks(Benchmark& benchmark) {
+	std::mt19937 random(3141);
+	SceneGraph sceneGraph;
+	std::vector<SceneNodeId> roots(kRootCount);
+	for (uint32_t r = 0; r < kRootCount; ++r) {
+		roots[r] = sceneGraph.CreateNode(kInvalidSceneNode, MakeRandomTransform(random));
+		// ルートの下に木を作る(親は同じルートの下のノードから選ぶ)
+		std::vector<SceneNodeId> subtree = {roots[r]};
+		for (uint32_t i = 1; i < kNodeCountPerRoot; ++i) {
+			subtree.push_back(sceneGraph.CreateNode(subtree[random() % subtree.size()], MakeRandomTransform(random)));
+		}
+	}
+	sceneGraph.Update();
+	const uint32_t nodeCount = static_cast<uint32_t>(sceneGraph.GetNodeCount());
+
+	benchmark.Run("SceneGraph/static", nodeCount, [&]() {
+		sceneGraph.Update();
+		DoNotOptimize(sceneGraph.GetRecomputedNodeCount());
+	});
+
+	float x = 0.0f;
+	benchmark.Run("SceneGraph/moveOneRoot", nodeCount, [&]() {
+		x += 0.01f;
+		sceneGraph.SetTranslate(roots[0], {x, 0.0f, 0.0f});
+		sceneGraph.Update();
+		DoNotOptimize(sceneGraph.GetRecomputedNodeCount());
+	});
+
+	benchmark.Run("SceneGraph/moveAllRoots", nodeCount, [&]() {
+		x += 0.01f;
+		for (SceneNodeId root : roots) {
+			sceneGraph.SetTranslate(root, {x, 0.0f, 0.0f});
+		}
+		sceneGraph.Update();
+		DoNotOptimize(sceneGraph.GetRecomputedNodeCount());
+	});
+}
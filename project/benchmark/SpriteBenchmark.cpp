@@ -0,0 +1,407 @@
+#include "2d/SpriteBatchBuilder.h"
+#include "2d/SpriteInstance.h"
+#include "2d/SpriteSystem.h"
+#include "Benchmark.h"
+#include "base/Math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 計測するスプライト数
+const uint32_t kSpriteCount = 10000;
+// テクスチャの種類
+const uint32_t kTextureCount = 8;
+
+// Sprite::Drawで1枚ごとに書き込んでいたバッファ(1枚ずつ別のリソース)
+struct PerSpriteBuffers {
+	struct VertexData {
+		Vector4 position;
+		Vector2 texcoord;
+		Vector3 normal;
+	};
+	struct Material {
+		Vector4 color;
+		int32_t enableLighting;
+		float paddding[3];
+		Matrix4x4 uvTransform;
+	};
+	struct TransformationMatrix {
+		Matrix4x4 WVP;
+		Matrix4x4 World;
+		Matrix4x4 WorldInverseTranspose;
+	};
+	VertexData vertices[4];
+	Material material;
+	TransformationMatrix transformationMatrix;
+};
+
+// 計測用のスプライト
+struct BenchSprite {
+	Vector2 position;
+	float rotation;
+	Vector2 size;
+	Vector4 color;
+	uint32_t textureIndex;
+	SpriteQuad quad;
+};
+
+std::vector<BenchSprite> MakeSprites(std::mt19937& random, bool isGroupedByTexture) {
+	std::uniform_real_distribution<float> position(0.0f, 1280.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> size(16.0f, 128.0f);
+	std::vector<BenchSprite> sprites(kSpriteCount);
+	for (uint32_t i = 0; i < kSpriteCount; ++i) {
+		BenchSprite& sprite = sprites[i];
+		sprite.position = {position(random), position(random)};
+		sprite.rotation = angle(random);
+		sprite.size = {size(random), size(random)};
+		sprite.color = {1.0f, 1.0f, 1.0f, 1.0f};
+		// 同じテクスチャがまとまっているか、毎回切り替わるか
+		sprite.textureIndex = isGroupedByTexture ? i * kTextureCount / kSpriteCount : i % kTextureCount;
+		sprite.quad = {
+		    {{0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 1.0f}, {1.0f, 0.0f}},
+		    {{0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 1.0f}, {1.0f, 0.0f}},
+		};
+	}
+	return sprites;
+}
+
+Matrix4x4 MakeSpriteWorldMatrix(const BenchSprite& sprite) {
+	return MakeAffineMatrix({sprite.size.x, sprite.size.y, 1.0f}, {0.0f, 0.0f, sprite.rotation}, {sprite.position.x, sprite.position.y, 0.0f});
+}
+
+// インスタンスから頂点を作る(SpriteInstanced.VS.hlslと同じ計算)
+SpriteVertex ExpandInstance(const SpriteInstance& instance, uint32_t vertexId) {
+	float cornerX = static_cast<float>(vertexId >> 1);
+	float cornerY = static_cast<float>(1 - (vertexId & 1));
+	SpriteVertex vertex;
+	vertex.position = {
+	    instance.translate.x + cornerX * instance.axes.x + cornerY * instance.axes.z,
+	    instance.translate.y + cornerX * instance.axes.y + cornerY * instance.axes.w,
+	    instance.depth,
+	    1.0f,
+	};
+	vertex.texcoord = {
+	    instance.uvRect.x + (instance.uvRect.z - instance.uvRect.x) * cornerX,
+	    instance.uvRect.y + (instance.uvRect.w - instance.uvRect.y) * cornerY,
+	};
+	vertex.color = instance.color;
+	return vertex;
+}
+
+// 以前のSpriteのように1枚ずつnewしたスプライト
+// 状態の後ろにGPUリソースなどのメンバが並ぶので、1枚分が大きく、アドレスもばらばらになる
+struct HeapSprite {
+	Vector2 position;
+	float rotation;
+	Vector2 size;
+	Vector2 anchorPoint;
+	uint8_t dirtyFlags;
+	Matrix4x4 worldMatrix;
+	SpriteQuad quad;
+	// ComPtrやバッファビューなどの分
+	uint8_t gpuMembers[256];
+};
+
+// 画面上で占める範囲(SpriteSystem::ComputeBoundingRectと同じ計算。フリップと親ノードはなし)
+Rect2D ComputeHeapSpriteBounds(const HeapSprite& sprite) {
+	float left = -sprite.anchorPoint.x * sprite.size.x;
+	float right = (1.0f - sprite.anchorPoint.x) * sprite.size.x;
+	float top = -sprite.anchorPoint.y * sprite.size.y;
+	float bottom = (1.0f - sprite.anchorPoint.y) * sprite.size.y;
+	if (sprite.rotation != 0.0f) {
+		float x = std::max(std::fabs(left), std::fabs(right));
+		float y = std::max(std::fabs(top), std::fabs(bottom));
+		float radius = std::sqrt(x * x + y * y);
+		left = -radius;
+		right = radius;
+		top = -radius;
+		bottom = radius;
+	}
+	return {std::min(left, right) + sprite.position.x, std::min(top, bottom) + sprite.position.y, std::max(left, right) + sprite.position.x,
+	        std::max(top, bottom) + sprite.position.y};
+}
+
+} // namespace
+
+// インスタンスの詰め方を調べる(SpriteBatchと同じ頂点になるか、ブレンドモードごとに並ぶか)
+bool RunSpriteInstanceCheck() {
+	const uint32_t kCount = 1000;
+	const float kMaxError = 1.0e-3f;
+	std::mt19937 random(4096);
+	std::vector<BenchSprite> sprites = MakeSprites(random, false);
+	sprites.resize(kCount);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<BlendMode> blendModes(kCount);
+	for (uint32_t i = 0; i < kCount; ++i) {
+		BenchSprite& sprite = sprites[i];
+		// アンカーポイント・フリップ・切り出しを混ぜる(フリップは座標とUVの符号が反転する)
+		float anchorX = unit(random), anchorY = unit(random);
+		float flipX = i % 3 == 0 ? -1.0f : 1.0f, flipY = i % 5 == 0 ? -1.0f : 1.0f;
+		float left = -anchorX * flipX, right = (1.0f - anchorX) * flipX;
+		float top = -anchorY * flipY, bottom = (1.0f - anchorY) * flipY;
+		float u0 = unit(random) * flipX, v0 = unit(random) * flipY, u1 = unit(random) * flipX, v1 = unit(random) * flipY;
+		sprite.quad = {
+		    {{left, bottom}, {left, top}, {right, bottom}, {right, top}},
+		    {{u0, v1}, {u0, v0}, {u1, v1}, {u1, v0}},
+		};
+		sprite.color = {unit(random), unit(random), unit(random), 1.0f};
+		// ブレンドモードは50枚ずつ切り替える
+		blendModes[i] = static_cast<BlendMode>(i / 50 % static_cast<uint32_t>(BlendMode::kCount));
+	}
+
+	std::vector<SpriteVertex> vertices(static_cast<size_t>(kCount) * SpriteBatchBuilder::kVertexCountPerSprite);
+	SpriteBatchBuilder vertexBuilder;
+	vertexBuilder.SetDestination(vertices.data(), kCount);
+	std::vector<SpriteInstance> instances(kCount);
+	SpriteInstanceBuilder instanceBuilder;
+	instanceBuilder.SetDestination(instances.data(), kCount);
+	for (uint32_t i = 0; i < kCount; ++i) {
+		const BenchSprite& sprite = sprites[i];
+		Matrix4x4 world = MakeSpriteWorldMatrix(sprite);
+		vertexBuilder.Add(sprite.quad, world, sprite.color, sprite.textureIndex, blendModes[i]);
+		instanceBuilder.Add(MakeSpriteInstance(sprite.quad, world, sprite.color, sprite.textureIndex), blendModes[i]);
+	}
+
+	// インスタンスは積んだ順に並び、範囲はブレンドモードが切り替わるところで分かれる
+	bool passed = true;
+	float maxError = 0.0f;
+	uint32_t next = 0;
+	for (const SpriteInstanceBuilder::Range& range : instanceBuilder.GetRanges()) {
+		passed = passed && range.firstInstance == next;
+		next += range.instanceCount;
+		for (uint32_t i = range.firstInstance; i < range.firstInstance + range.instanceCount; ++i) {
+			passed = passed && blendModes[i] == range.blendMode && instances[i].textureIndex == sprites[i].textureIndex;
+			for (uint32_t v = 0; v < SpriteBatchBuilder::kVertexCountPerSprite; ++v) {
+				SpriteVertex expected = vertices[static_cast<size_t>(i) * SpriteBatchBuilder::kVertexCountPerSprite + v];
+				SpriteVertex actual = ExpandInstance(instances[i], v);
+				maxError = std::max({maxError, std::fabs(expected.position.x - actual.position.x), std::fabs(expected.position.y - actual.position.y),
+				                     std::fabs(expected.texcoord.x - actual.texcoord.x), std::fabs(expected.texcoord.y - actual.texcoord.y)});
+				passed = passed && expected.color == actual.color;
+			}
+		}
+	}
+	passed = passed && next == kCount && instanceBuilder.GetRanges().size() == kCount / 50 && maxError <= kMaxError;
+	std::printf("sprite instance packing   maxError %.3e %s\n\n", maxError, passed ? "" : "FAILED");
+	return passed;
+}
+
+// スプライト描画のCPU側の処理(1枚ずつ描く場合とSpriteBatchの比較)
+// GPUへのコマンドは積まないので、DrawCall数は別に表示する
+void RunSpriteBenchmarks(Benchmark& benchmark) {
+	std::mt19937 random(8128);
+	std::vector<BenchSprite> sprites = MakeSprites(random, false);
+	std::vector<BenchSprite> groupedSprites = MakeSprites(random, true);
+	const Matrix4x4 viewProjection = MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f);
+
+	// 1枚ずつ: スプライトごとに別のバッファへ書き込み、1枚ごとにDrawCall
+	std::vector<std::unique_ptr<PerSpriteBuffers>> perSpriteBuffers(kSpriteCount);
+	for (auto& buffers : perSpriteBuffers) {
+		buffers = std::make_unique<PerSpriteBuffers>();
+	}
+	benchmark.Run("SpriteDraw/perSprite", kSpriteCount, [&]() {
+		for (uint32_t i = 0; i < kSpriteCount; ++i) {
+			const BenchSprite& sprite = sprites[i];
+			PerSpriteBuffers& buffers = *perSpriteBuffers[i];
+			Matrix4x4 world = MakeSpriteWorldMatrix(sprite);
+			for (uint32_t v = 0; v < 4; ++v) {
+				buffers.vertices[v].position = {sprite.quad.positions[v].x, sprite.quad.positions[v].y, 0.0f, 1.0f};
+				buffers.vertices[v].texcoord = sprite.quad.texcoords[v];
+				buffers.vertices[v].normal = {0.0f, 0.0f, -1.0f};
+			}
+			buffers.material.color = sprite.color;
+			buffers.transformationMatrix.WVP = Multiply(world, viewProjection);
+			buffers.transformationMatrix.World = world;
+			buffers.transformationMatrix.WorldInverseTranspose = ToMatrix4x4(MakeNormalMatrix(world));
+		}
+		DoNotOptimize(perSpriteBuffers[0]->transformationMatrix);
+	});
+
+	// SpriteBatch: 変換済みの頂点を1つの配列に詰める
+	std::vector<SpriteVertex> vertices(static_cast<size_t>(kSpriteCount) * SpriteBatchBuilder::kVertexCountPerSprite);
+	SpriteBatchBuilder builder;
+	builder.SetDestination(vertices.data(), kSpriteCount);
+	auto runBatch = [&](const std::vector<BenchSprite>& source) {
+		builder.Clear();
+		for (const BenchSprite& sprite : source) {
+			builder.Add(sprite.quad, MakeSpriteWorldMatrix(sprite), sprite.color, sprite.textureIndex, BlendMode::kNormal);
+		}
+		DoNotOptimize(vertices[0]);
+	};
+	benchmark.Run("SpriteDraw/batch/mixedTextures", kSpriteCount, [&]() { runBatch(sprites); });
+	size_t mixedDrawCalls = builder.GetRuns().size();
+	benchmark.Run("SpriteDraw/batch/groupedTextures", kSpriteCount, [&]() { runBatch(groupedSprites); });
+	size_t groupedDrawCalls = builder.GetRuns().size();
+
+	// インスタンシング: 1枚ごとに64バイトを1つ書き込むだけ(テクスチャが混ざっていてもまとめられる)
+	std::vector<SpriteInstance> instances(kSpriteCount);
+	SpriteInstanceBuilder instanceBuilder;
+	instanceBuilder.SetDestination(instances.data(), kSpriteCount);
+	benchmark.Run("SpriteDraw/instanced/mixedTextures", kSpriteCount, [&]() {
+		instanceBuilder.Clear();
+		for (const BenchSprite& sprite : sprites) {
+			instanceBuilder.Add(MakeSpriteInstance(sprite.quad, MakeSpriteWorldMatrix(sprite), sprite.color, sprite.textureIndex), BlendMode::kNormal);
+		}
+		DoNotOptimize(instances[0]);
+	});
+	size_t instancedDrawCalls = instanceBuilder.GetRanges().size();
+
+	// 計測しなかった場合(--filter)は表示しない
+	if (!benchmark.GetResults().empty() && benchmark.GetResults().back().name == "SpriteDraw/instanced/mixedTextures") {
+		std::printf("SpriteDraw draw calls (%u sprites, %u textures)\n", kSpriteCount, kTextureCount);
+		std::printf("  perSprite              : %u\n", kSpriteCount);
+		std::printf("  batch/mixedTextures    : %zu\n", mixedDrawCalls);
+		std::printf("  batch/groupedTextures  : %zu\n", groupedDrawCalls);
+		std::printf("  instanced/mixedTextures: %zu\n\n", instancedDrawCalls);
+	}
+}
+
+// World行列をまとめて計算しても、1つずつMakeAffineMatrixで求めたのと同じ値になるか調べる
+bool RunSpriteSystemCheck() {
+	// 4つずつまとめる端数が出る数にし、親ノードに取り付けたものも混ぜる
+	const uint32_t kCount = 1003;
+	std::mt19937 random(1729);
+	std::uniform_real_distribution<float> position(0.0f, 1280.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> size(-128.0f, 128.0f);
+	SceneGraph sceneGraph;
+	SceneNodeId parentNode = sceneGraph.CreateNode(kInvalidSceneNode, {
+	                                                                      {1.5f, 0.5f, 1.0f},
+	                                                                      {0.0f, 0.0f, 0.3f},
+	                                                                      {20.0f, -10.0f, 0.0f}
+    });
+	sceneGraph.Update();
+	SpriteSystem system;
+	std::vector<SpriteHandle> handles(kCount);
+	for (uint32_t i = 0; i < kCount; ++i) {
+		handles[i] = system.Create(0, {64.0f, 64.0f});
+		system.SetPosition(handles[i], {position(random), position(random)});
+		// 回転なしも混ぜる
+		system.SetRotation(handles[i], i % 7 == 0 ? 0.0f : angle(random));
+		system.SetSize(handles[i], {size(random), size(random)});
+		if (i % 5 == 0) {
+			system.SetParentNode(handles[i], &sceneGraph, parentNode);
+		}
+	}
+	auto isSameWorld = [&]() {
+		bool isSame = true;
+		for (SpriteHandle handle : handles) {
+			const Vector2& translate = system.GetPosition(handle);
+			const Vector2& scale = system.GetSize(handle);
+			Matrix4x4 expected = MakeAffineMatrix({scale.x, scale.y, 1.0f}, {0.0f, 0.0f, system.GetRotation(handle)}, {translate.x, translate.y, 0.0f});
+			if (system.GetParentNode(handle) != kInvalidSceneNode) {
+				expected = Multiply(expected, sceneGraph.GetWorldMatrix(parentNode));
+			}
+			const Matrix4x4& actual = system.GetWorldMatrices()[system.IndexOf(handle)];
+			for (uint32_t row = 0; row < 4; ++row) {
+				for (uint32_t column = 0; column < 4; ++column) {
+					isSame = isSame && actual.m[row][column] == expected.m[row][column];
+				}
+			}
+		}
+		return isSame;
+	};
+	system.Update();
+	bool passed = system.GetRebuildCount() == kCount && isSameWorld();
+
+	// 一部だけ変えて、飛び飛びの位置を計算し直す
+	std::vector<uint32_t> indices;
+	for (uint32_t i = 0; i < kCount; i += 3) {
+		system.SetRotation(handles[i], angle(random));
+		system.SetPosition(handles[i], {position(random), position(random)});
+		indices.push_back(system.IndexOf(handles[i]));
+	}
+	system.ResetRebuildCount();
+	system.Update(indices.data(), indices.size());
+	passed = passed && system.GetRebuildCount() == indices.size() && isSameWorld();
+
+	std::printf("sprite system world matrices %s\n\n", passed ? "" : "FAILED");
+	return passed;
+}
+
+// スプライトの状態の持ち方(1枚ずつnewしたポインタの配列とSpriteSystemの比較)
+// 全スプライトを動かし、範囲を求めてWorld行列を計算し直す(毎フレームの処理)
+// どちらも同じ計算をする(座標を動かし、同じ式で範囲を求め、座標が変わったもののWorld行列だけ求める。四角形は変わらないので求めない)
+// SpriteSystemは座標をまとめて書き込み、配列を前から順に読んで、回転のsin/cosを4つずつ求める
+void RunSpriteSystemBenchmarks(Benchmark& benchmark) {
+	std::mt19937 random(6174);
+	std::vector<BenchSprite> sprites = MakeSprites(random, false);
+
+	// ポインタの配列: 確保した順と並びがずれるようにシャッフルしておく
+	std::vector<std::unique_ptr<HeapSprite>> heapStorage(kSpriteCount);
+	for (uint32_t i = 0; i < kSpriteCount; ++i) {
+		heapStorage[i] = std::make_unique<HeapSprite>();
+		HeapSprite& sprite = *heapStorage[i];
+		sprite.position = sprites[i].position;
+		sprite.rotation = sprites[i].rotation;
+		sprite.size = sprites[i].size;
+		sprite.anchorPoint = {0.5f, 0.5f};
+		sprite.quad = sprites[i].quad;
+	}
+	std::vector<HeapSprite*> heapSprites(kSpriteCount);
+	for (uint32_t i = 0; i < kSpriteCount; ++i) {
+		heapSprites[i] = heapStorage[i].get();
+	}
+	std::shuffle(heapSprites.begin(), heapSprites.end(), random);
+	std::vector<Rect2D> bounds(kSpriteCount);
+	benchmark.Run("SpriteUpdate/pointers", kSpriteCount, [&]() {
+		for (HeapSprite* sprite : heapSprites) {
+			sprite->position.x += 0.1f;
+			sprite->dirtyFlags = 1;
+		}
+		for (uint32_t i = 0; i < kSpriteCount; ++i) {
+			bounds[i] = ComputeHeapSpriteBounds(*heapSprites[i]);
+		}
+		for (HeapSprite* sprite : heapSprites) {
+			if (sprite->dirtyFlags) {
+				sprite->worldMatrix = MakeAffineMatrix({sprite->size.x, sprite->size.y, 1.0f}, {0.0f, 0.0f, sprite->rotation}, {sprite->position.x, sprite->position.y, 0.0f});
+				sprite->dirtyFlags = 0;
+			}
+		}
+		DoNotOptimize(bounds[0]);
+	});
+
+	// SpriteSystem: 項目ごとの配列を前から順に読む
+	SpriteSystem system;
+	std::vector<SpriteHandle> handles(kSpriteCount);
+	for (uint32_t i = 0; i < kSpriteCount; ++i) {
+		handles[i] = system.Create(sprites[i].textureIndex, {256.0f, 256.0f});
+		system.SetPosition(handles[i], sprites[i].position);
+		system.SetRotation(handles[i], sprites[i].rotation);
+		system.SetSize(handles[i], sprites[i].size);
+		system.SetAnchorPoint(handles[i], {0.5f, 0.5f});
+	}
+	system.Update();
+	// ゲーム側も座標を成分ごとの配列で持ち、まとめて書き込む
+	std::vector<float> positionX(kSpriteCount), positionY(kSpriteCount);
+	for (uint32_t i = 0; i < kSpriteCount; ++i) {
+		positionX[i] = sprites[i].position.x;
+		positionY[i] = sprites[i].position.y;
+	}
+	std::vector<uint32_t> deadIndices;
+	benchmark.Run("SpriteUpdate/system", kSpriteCount, [&]() {
+		for (uint32_t i = 0; i < kSpriteCount; ++i) {
+			positionX[i] += 0.1f;
+		}
+		system.SetPositions(handles.data(), kSpriteCount, positionX.data(), positionY.data(), deadIndices);
+		system.ComputeBoundingRects(bounds.data());
+		system.Update();
+		DoNotOptimize(bounds[0]);
+	});
+
+	// 作成と削除を繰り返す(空きスロットの使い回しと、削除で後ろから詰める分)
+	const uint32_t kChurnCount = 1000;
+	benchmark.Run("SpriteSystem/createDestroy", kChurnCount, [&]() {
+		for (uint32_t i = 0; i < kChurnCount; ++i) {
+			uint32_t at = i * 7 % kSpriteCount;
+			system.Destroy(handles[at]);
+			handles[at] = system.Create(i % kTextureCount, {256.0f, 256.0f});
+		}
+		DoNotOptimize(handles[0]);
+	});
+}
@@ -0,0 +1,214 @@
+#include "2d/BitmapFont.h"
+#include "2d/SpriteBatchBuilder.h"
+#include "2d/TextBuilder.h"
+#include "Benchmark.h"
+#include "base/Math.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 計測する文字列数(HUDの行数)
+const uint32_t kLineCount = 200;
+
+// 手で組み立てたフォント(英数字は0ページ目、かなは1ページ目)
+// 四角形はベースラインから上に12ピクセル、送り幅は大文字12・小文字と記号10・空白6
+BitmapFont MakeFont() {
+	BitmapFont font;
+	font.SetLineMetrics(16.0f, 20.0f);
+	for (uint32_t codepoint = 0x21; codepoint <= 0x7E; ++codepoint) {
+		float u = static_cast<float>(codepoint) / 128.0f;
+		float advance = codepoint >= 'A' && codepoint <= 'Z' ? 12.0f : 10.0f;
+		font.AddGlyph(codepoint, {{1.0f, -12.0f}, {10.0f, 12.0f}, advance, 0, {u, 0.0f, u + 0.005f, 0.01f}});
+	}
+	font.AddGlyph(' ', {{0.0f, 0.0f}, {0.0f, 0.0f}, 6.0f, 0, {}});
+	for (uint32_t codepoint = 0x3041; codepoint <= 0x3096; ++codepoint) {
+		float u = static_cast<float>(codepoint - 0x3040) / 128.0f;
+		font.AddGlyph(codepoint, {{0.0f, -14.0f}, {16.0f, 16.0f}, 16.0f, 1, {u, 0.5f, u + 0.005f, 0.51f}});
+	}
+	return font;
+}
+
+// 手元にあるTrueTypeフォントを探す(なければ空)
+std::string FindSystemFont() {
+	const char* candidates[] = {
+	    "C:/Windows/Fonts/msgothic.ttc",
+	    "C:/Windows/Fonts/arial.ttf",
+	    "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+	};
+	for (const char* path : candidates) {
+		if (std::filesystem::exists(path)) {
+			return path;
+		}
+	}
+	return {};
+}
+
+bool IsVertex(const SpriteVertex& vertex, float x, float y, float u, float v) {
+	return vertex.position.x == x && vertex.position.y == y && vertex.texcoord.x == u && vertex.texcoord.y == v;
+}
+
+} // namespace
+
+// UTF-8の読み方、文字の並べ方とページ分け、キャッシュの使い方を調べる
+bool RunTextCheck() {
+	// UTF-8(1〜4バイト、壊れたバイト)
+	const char utf8[] = "a\xE3\x81\x82\xE6\xBC\xA2\xF0\x9F\x98\x80\x80\xE3\x81";
+	const uint32_t expectedCodepoints[] = {'a', 0x3042, 0x6F22, 0x1F600, 0xFFFD, 0xFFFD, 0xFFFD};
+	bool passed = true;
+	const char* it = utf8;
+	const char* end = utf8 + sizeof(utf8) - 1;
+	for (uint32_t expected : expectedCodepoints) {
+		passed = passed && it != end && DecodeUtf8(it, end) == expected;
+	}
+	passed = passed && it == end;
+
+	// 並べ方(2倍の大きさ。ページ順に詰まり、改行で行頭に戻る。フォントにない文字は'?'になる)
+	BitmapFont font = MakeFont();
+	std::vector<SpriteVertex> vertices;
+	std::vector<uint32_t> pageOffsets;
+	const Vector4 kWhite = {1.0f, 1.0f, 1.0f, 1.0f};
+	TextBuilder::Layout(font, "Aあ A\n\xE6\xBC\xA2", {100.0f, 50.0f}, 2.0f, kWhite, vertices, pageOffsets);
+	passed = passed && pageOffsets == std::vector<uint32_t>{0, 3, 4} && vertices.size() == 16;
+	if (passed) {
+		const float uA = 'A' / 128.0f;
+		const float uQuestion = '?' / 128.0f;
+		// 1文字目のA: 左上(102, 50 + 32 - 24)、大きさ(20, 24) 左下・左上・右下・右上
+		passed = IsVertex(vertices[0], 102.0f, 82.0f, uA, 0.01f) && IsVertex(vertices[1], 102.0f, 58.0f, uA, 0.0f) && IsVertex(vertices[3], 122.0f, 58.0f, uA + 0.005f, 0.0f);
+		// 2つ目のA: ペンは A(12) + あ(16) + 空白(6) = 34 の2倍進んでいる
+		passed = passed && vertices[4].position.x == 170.0f;
+		// 2行目の'?': ベースラインは行の高さ20の2倍下
+		passed = passed && vertices[8].position.x == 102.0f && vertices[8].position.y == 122.0f && vertices[9].texcoord.x == uQuestion;
+		// 1ページ目のあ
+		passed = passed && vertices[12].position.x == 124.0f && vertices[13].position.y == 54.0f;
+	}
+
+	// キャッシュ(同じ文字列は並べ直さずコピーするだけ。使われなかったものは次のBeginで捨てる)
+	TextBuilder text(font);
+	text.Begin();
+	text.Add("Aあ A\n\xE6\xBC\xA2", {100.0f, 50.0f}, 2.0f, kWhite);
+	text.Add("Aあ A\n\xE6\xBC\xA2", {100.0f, 50.0f}, 2.0f, kWhite);
+	passed = passed && text.GetLayoutCount() == 1 && text.GetGlyphCount(0) == 6 && text.GetGlyphCount(1) == 2;
+	passed = passed && std::equal(vertices.begin(), vertices.begin() + 12, text.GetVertices(0), [](const SpriteVertex& a, const SpriteVertex& b) {
+		return a.position == b.position && a.texcoord == b.texcoord && a.color == b.color;
+	});
+	text.ResetLayoutCount();
+	text.Begin();
+	text.Add("Aあ A\n\xE6\xBC\xA2", {100.0f, 50.0f}, 2.0f, kWhite);
+	text.Add("B", {0.0f, 0.0f}, 1.0f, kWhite);
+	passed = passed && text.GetLayoutCount() == 1 && text.GetCacheSize() == 2;
+	text.Begin();
+	text.Add("B", {0.0f, 0.0f}, 1.0f, kWhite);
+	text.Begin();
+	passed = passed && text.GetCacheSize() == 1 && text.GetGlyphCount() == 0;
+	// 位置だけ違う文字列(スクロールなど)は並べ直さず、キャッシュをずらしてコピーする
+	text.ResetLayoutCount();
+	for (uint32_t frame = 0; frame < 3; ++frame) {
+		text.Begin();
+		text.Add("B", {10.0f * static_cast<float>(frame), 5.0f}, 1.0f, kWhite);
+		text.Add("B", {-3.0f, 7.0f * static_cast<float>(frame)}, 1.0f, kWhite);
+		const SpriteVertex* scrolled = text.GetVertices(0);
+		// Bは位置から左上(1, 16 - 12)ずれていて、大きさ(10, 12) 1つ目の左上と2つ目の右下を見る
+		const float uB = 'B' / 128.0f;
+		passed = passed && IsVertex(scrolled[1], 1.0f + 10.0f * static_cast<float>(frame), 9.0f, uB, 0.0f);
+		passed = passed && IsVertex(scrolled[6], 8.0f, 16.0f + 7.0f * static_cast<float>(frame), uB + 0.005f, 0.01f);
+	}
+	passed = passed && text.GetLayoutCount() == 1 && text.GetCacheSize() == 1;
+	text.Begin();
+	text.Begin();
+
+	// ページごとに1つのラン
+	text.Add("Aあ A\n\xE6\xBC\xA2", {100.0f, 50.0f}, 2.0f, kWhite);
+	std::vector<SpriteVertex> batchVertices(16 * SpriteBatchBuilder::kVertexCountPerSprite);
+	SpriteBatchBuilder builder;
+	builder.SetDestination(batchVertices.data(), 16);
+	for (uint32_t page = 0; page < text.GetPageCount(); ++page) {
+		passed = passed && builder.Add(text.GetVertices(page), text.GetGlyphCount(page), 10 + page, BlendMode::kNormal);
+	}
+	passed = passed && builder.GetRuns().size() == 2 && builder.GetRuns()[1].firstSprite == 3 && builder.GetRuns()[1].textureIndex == 11;
+	passed = passed && batchVertices[12].position.x == vertices[12].position.x;
+
+	// TrueTypeから焼き込む(フォントが見つかったときだけ)
+	std::string fontPath = FindSystemFont();
+	if (!fontPath.empty()) {
+		std::ifstream file(fontPath, std::ios::binary);
+		std::vector<uint8_t> fontData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		BitmapFont truetype;
+		passed = passed && truetype.Build(fontData, {BitmapFont::kBasicLatin}, "\xE3\x81\x82", {});
+		const Glyph* glyph = truetype.FindGlyph('A');
+		passed = passed && truetype.GetPageCount() >= 1 && glyph != nullptr && glyph->size.x > 0.0f && glyph->offset.y < 0.0f;
+		passed = passed && truetype.FindGlyph(' ') != nullptr && truetype.FindGlyph(' ')->size.x == 0.0f && truetype.GetAscent() > 0.0f;
+		if (passed) {
+			// 文字の中ほどのアルファが入っている
+			const AtlasPage& page = truetype.GetAtlas().GetPages()[glyph->page];
+			uint32_t coveredCount = 0;
+			uint32_t x0 = static_cast<uint32_t>(glyph->uvRect.x * static_cast<float>(page.width));
+			uint32_t y0 = static_cast<uint32_t>(glyph->uvRect.y * static_cast<float>(page.height));
+			for (uint32_t y = 0; y < static_cast<uint32_t>(glyph->size.y); ++y) {
+				for (uint32_t x = 0; x < static_cast<uint32_t>(glyph->size.x); ++x) {
+					coveredCount += page.pixels[((y0 + y) * page.width + x0 + x) * TextureAtlas::kBytesPerPixel + 3] > 128 ? 1 : 0;
+				}
+			}
+			passed = coveredCount > 0;
+		}
+	}
+
+	std::printf("text layout (truetype: %s) %s\n\n", fontPath.empty() ? "skipped" : fontPath.c_str(), passed ? "" : "FAILED");
+	return passed;
+}
+
+// HUDの文字列を毎フレーム積む(毎回並べ直す場合と、TextBuilderのキャッシュからコピーする場合・スクロールする場合の比較)
+void RunTextBenchmarks(Benchmark& benchmark) {
+	BitmapFont font = MakeFont();
+	std::vector<std::string> lines(kLineCount);
+	uint32_t glyphCount = 0;
+	for (uint32_t i = 0; i < kLineCount; ++i) {
+		lines[i] = "Score " + std::to_string(i * 1237) + " \xE3\x81\x99\xE3\x81\x93\xE3\x81\x82 Lv." + std::to_string(i % 99);
+		for (const char* it = lines[i].data(); it != lines[i].data() + lines[i].size();) {
+			glyphCount += DecodeUtf8(it, lines[i].data() + lines[i].size()) != ' ' ? 1 : 0;
+		}
+	}
+	const Vector4 kWhite = {1.0f, 1.0f, 1.0f, 1.0f};
+
+	std::vector<SpriteVertex> scratchVertices;
+	std::vector<uint32_t> scratchOffsets;
+	std::vector<std::vector<SpriteVertex>> pages(font.GetPageCount());
+	benchmark.Run("Text/layoutEveryFrame", glyphCount, [&]() {
+		for (std::vector<SpriteVertex>& page : pages) {
+			page.clear();
+		}
+		for (uint32_t i = 0; i < kLineCount; ++i) {
+			TextBuilder::Layout(font, lines[i], {16.0f, 20.0f * static_cast<float>(i)}, 1.0f, kWhite, scratchVertices, scratchOffsets);
+			for (uint32_t page = 0; page < font.GetPageCount(); ++page) {
+				pages[page].insert(
+				    pages[page].end(), scratchVertices.begin() + scratchOffsets[page] * SpriteBatchBuilder::kVertexCountPerSprite,
+				    scratchVertices.begin() + scratchOffsets[page + 1] * SpriteBatchBuilder::kVertexCountPerSprite);
+			}
+		}
+		DoNotOptimize(pages[0][0]);
+	});
+
+	TextBuilder text(font);
+	benchmark.Run("Text/cached", glyphCount, [&]() {
+		text.Begin();
+		for (uint32_t i = 0; i < kLineCount; ++i) {
+			text.Add(lines[i], {16.0f, 20.0f * static_cast<float>(i)}, 1.0f, kWhite);
+		}
+		DoNotOptimize(text.GetVertices(0)[0]);
+	});
+
+	// 毎フレーム位置が変わる(スクロールする)場合もキャッシュからコピーするだけ
+	float scroll = 0.0f;
+	benchmark.Run("Text/cachedScrolling", glyphCount, [&]() {
+		text.Begin();
+		scroll += 1.0f;
+		for (uint32_t i = 0; i < kLineCount; ++i) {
+			text.Add(lines[i], {16.0f, 20.0f * static_cast<float>(i) - scroll}, 1.0f, kWhite);
+		}
+		DoNotOptimize(text.GetVertices(0)[0]);
+	});
+}
@@ -0,0 +1,134 @@
+#include "Benchmark.h"
+#include "base/TextureAtlas.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 大きさと中身がばらばらの画像を作る
+std::vector<AtlasImage> MakeImages(std::mt19937& random, uint32_t count, uint32_t maxSize) {
+	std::uniform_int_distribution<uint32_t> size(1, maxSize);
+	std::uniform_int_distribution<uint32_t> byte(0, 255);
+	std::vector<AtlasImage> images(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		AtlasImage& image = images[i];
+		image.name = "image" + std::to_string(i);
+		image.width = size(random);
+		image.height = size(random);
+		image.pixels.resize(static_cast<size_t>(image.width) * image.height * TextureAtlas::kBytesPerPixel);
+		for (uint8_t& pixel : image.pixels) {
+			pixel = static_cast<uint8_t>(byte(random));
+		}
+	}
+	return images;
+}
+
+// ページの(x, y)のピクセル
+const uint8_t* PagePixel(const AtlasPage& page, uint32_t x, uint32_t y) { return page.pixels.data() + (static_cast<size_t>(y) * page.width + x) * TextureAtlas::kBytesPerPixel; }
+
+// 画像がそのまま書き込まれ、gutterが一番近い端のピクセルになっているか
+bool CheckRegions(const TextureAtlas& atlas, const std::vector<AtlasImage>& images, const TextureAtlas::Settings& settings) {
+	bool passed = atlas.GetRegionCount() == images.size();
+	for (const AtlasImage& image : images) {
+		const AtlasRegion* region = atlas.FindRegion(image.name);
+		if (region == nullptr || region->width != image.width || region->height != image.height) {
+			return false;
+		}
+		const AtlasPage& page = atlas.GetPages()[region->page];
+		int gutter = static_cast<int>(settings.gutter);
+		for (int y = -gutter; y < static_cast<int>(image.height) + gutter; ++y) {
+			for (int x = -gutter; x < static_cast<int>(image.width) + gutter; ++x) {
+				uint32_t sourceX = static_cast<uint32_t>(std::clamp(x, 0, static_cast<int>(image.width) - 1));
+				uint32_t sourceY = static_cast<uint32_t>(std::clamp(y, 0, static_cast<int>(image.height) - 1));
+				const uint8_t* expected = image.pixels.data() + (static_cast<size_t>(sourceY) * image.width + sourceX) * TextureAtlas::kBytesPerPixel;
+				const uint8_t* actual = PagePixel(page, static_cast<uint32_t>(static_cast<int>(region->x) + x), static_cast<uint32_t>(static_cast<int>(region->y) + y));
+				passed = passed && std::memcmp(expected, actual, TextureAtlas::kBytesPerPixel) == 0;
+			}
+		}
+		float width = static_cast<float>(page.width), height = static_cast<float>(page.height);
+		passed = passed && region->uvRect.x == static_cast<float>(region->x) / width && region->uvRect.w == static_cast<float>(region->y + region->height) / height;
+	}
+
+	// gutterとpaddingを含めた範囲が重なっていない
+	for (size_t i = 0; i < images.size(); ++i) {
+		const AtlasRegion& a = *atlas.FindRegion(images[i].name);
+		for (size_t j = i + 1; j < images.size(); ++j) {
+			const AtlasRegion& b = *atlas.FindRegion(images[j].name);
+			uint32_t margin = settings.gutter * 2 + settings.padding;
+			bool isOverlapped = a.page == b.page && a.x < b.x + b.width + margin && b.x < a.x + a.width + margin && a.y < b.y + b.height + margin &&
+			                    b.y < a.y + a.height + margin;
+			passed = passed && !isOverlapped;
+		}
+	}
+	return passed;
+}
+
+// キャッシュの置き場所
+std::string GetCachePath() { return (std::filesystem::temp_directory_path() / "texture_atlas_benchmark.cache").string(); }
+
+} // namespace
+
+// アトラスの詰め方とキャッシュを調べる
+bool RunTextureAtlasCheck() {
+	std::mt19937 random(1729);
+	std::vector<AtlasImage> images = MakeImages(random, 120, 48);
+	// 小さいページにして複数ページに分かれるようにする
+	TextureAtlas::Settings settings;
+	settings.pageSize = 256;
+	settings.gutter = 2;
+	settings.padding = 1;
+
+	TextureAtlas atlas;
+	bool passed = atlas.Build(images, settings) && atlas.GetPages().size() > 1 && CheckRegions(atlas, images, settings);
+
+	// 書き出したものを読み込むと同じになり、keyが違えば読み込まない
+	uint64_t key = TextureAtlas::ComputeKey(images, settings);
+	std::string cachePath = GetCachePath();
+	TextureAtlas loaded;
+	passed = passed && atlas.SaveCache(cachePath, key) && !loaded.LoadCache(cachePath, key + 1) && loaded.LoadCache(cachePath, key);
+	passed = passed && loaded.GetPages().size() == atlas.GetPages().size() && CheckRegions(loaded, images, settings);
+	for (size_t i = 0; passed && i < atlas.GetPages().size(); ++i) {
+		passed = atlas.GetPages()[i].pixels == loaded.GetPages()[i].pixels;
+	}
+	// 画像が変わればkeyも変わる
+	images[0].pixels[0] ^= 1;
+	passed = passed && TextureAtlas::ComputeKey(images, settings) != key;
+
+	// ページに入らない画像は詰められない
+	std::vector<AtlasImage> tooLarge = MakeImages(random, 1, 1);
+	tooLarge[0].width = settings.pageSize;
+	tooLarge[0].pixels.resize(static_cast<size_t>(tooLarge[0].width) * tooLarge[0].height * TextureAtlas::kBytesPerPixel);
+	passed = passed && !TextureAtlas().Build(tooLarge, settings);
+
+	std::filesystem::remove(cachePath);
+	std::printf("texture atlas (%zu pages) %s\n\n", atlas.GetPages().size(), passed ? "" : "FAILED");
+	return passed;
+}
+
+// アトラスを詰める時間と、キャッシュから読み込む時間の比較
+void RunTextureAtlasBenchmarks(Benchmark& benchmark) {
+	std::mt19937 random(2187);
+	std::vector<AtlasImage> images = MakeImages(random, 256, 96);
+	TextureAtlas::Settings settings;
+	const uint32_t imageCount = static_cast<uint32_t>(images.size());
+
+	TextureAtlas atlas;
+	benchmark.Run("TextureAtlas/build", imageCount, [&]() {
+		atlas.Build(images, settings);
+		DoNotOptimize(atlas.GetPages()[0].pixels[0]);
+	});
+
+	std::string cachePath = GetCachePath();
+	uint64_t key = TextureAtlas::ComputeKey(images, settings);
+	atlas.SaveCache(cachePath, key);
+	TextureAtlas loaded;
+	benchmark.Run("TextureAtlas/loadCache", imageCount, [&]() {
+		loaded.LoadCache(cachePath, key);
+		DoNotOptimize(loaded.GetPages()[0].pixels[0]);
+	});
+	std::filesystem::remove(cachePath);
+}
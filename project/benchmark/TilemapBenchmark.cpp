@@ -0,0 +1,199 @@
+#include "2d/SpriteBatchBuilder.h"
+#include "2d/SpriteSystem.h"
+#include "2d/Tilemap.h"
+#include "2d/TilemapChunkCache.h"
+#include "Benchmark.h"
+#include "base/Culling.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 計測するマップのタイル数と1タイルの大きさ
+const uint32_t kMapSize = 512;
+const float kTileSize = 32.0f;
+// 画面の大きさとスクロールの速さ(1フレームのピクセル数)
+const float kViewWidth = 1280.0f;
+const float kViewHeight = 720.0f;
+const float kScrollSpeed = 4.0f;
+// 同時に映るチャンク数の上限(1280x720なら最大3x2。スクロールして戻るときのために余分に持つ)
+const uint32_t kSlotCount = 16;
+
+// タイルセット(256x256のテクスチャの左上128x128を8x8に分けたもの)
+const SpriteTextureRegion kTileset = {4, {256.0f, 256.0f}, {0.0f, 0.0f}, {128.0f, 128.0f}};
+
+bool IsVertex(const SpriteVertex& vertex, float x, float y, float u, float v) {
+	return vertex.position.x == x && vertex.position.y == y && vertex.texcoord.x == u && vertex.texcoord.y == v;
+}
+
+// frame目の画面の範囲(右下に向かってスクロールし、端まで行ったら戻る)
+Rect2D MakeViewport(uint32_t frame) {
+	float range = kTileSize * static_cast<float>(kMapSize) - kViewWidth;
+	float offset = static_cast<float>(frame) * kScrollSpeed;
+	offset = static_cast<float>(static_cast<uint32_t>(offset) % static_cast<uint32_t>(range));
+	return {offset, offset * 0.5f, offset + kViewWidth, offset * 0.5f + kViewHeight};
+}
+
+} // namespace
+
+// チャンクの頂点・カリング・作り直すチャンクの選び方を調べる
+bool RunTilemapCheck() {
+	// 70x40タイル(チャンクは3x2。右端と下端のチャンクは半端)
+	Tilemap tilemap(70, 40, {16.0f, 16.0f}, kTileset, 8, 8);
+	bool passed = tilemap.GetChunkColumns() == 3 && tilemap.GetChunkRows() == 2 && tilemap.GetChunkTileCount(0) == 0;
+	uint32_t revision = tilemap.GetChunkRevision(0);
+	tilemap.SetTile(1, 2, 10);
+	tilemap.SetTile(1, 2, 10);
+	tilemap.SetTile(0, 0, 1);
+	tilemap.SetTile(69, 39, 64);
+	passed = passed && tilemap.GetChunkTileCount(0) == 2 && tilemap.GetChunkRevision(0) == revision + 2 && tilemap.GetChunkTileCount(5) == 1;
+	tilemap.SetTile(0, 0, kEmptyTile);
+	passed = passed && tilemap.GetChunkTileCount(0) == 1 && tilemap.GetChunkRevision(0) == revision + 3;
+
+	// 空でないタイルだけが左上から順に並ぶ(10番は2行目の2列目。1セルは16x16ピクセル)
+	std::vector<SpriteVertex> vertices(TilemapChunkCache::kVertexCountPerSlot);
+	passed = passed && tilemap.BuildChunk(0, vertices.data()) == 1;
+	passed = passed && IsVertex(vertices[0], 16.0f, 48.0f, 16.0f / 256.0f, 32.0f / 256.0f) && IsVertex(vertices[3], 32.0f, 32.0f, 32.0f / 256.0f, 16.0f / 256.0f);
+	passed = passed && tilemap.BuildChunk(5, vertices.data()) == 1 && IsVertex(vertices[1], 69.0f * 16.0f, 39.0f * 16.0f, 112.0f / 256.0f, 112.0f / 256.0f);
+	// 座標を動かすと全チャンクが作り直しになる
+	tilemap.SetPosition({100.0f, 0.0f});
+	passed = passed && tilemap.GetChunkRevision(5) == 3 && tilemap.BuildChunk(0, vertices.data()) == 1 && vertices[0].position.x == 116.0f;
+	tilemap.SetPosition({0.0f, 0.0f});
+
+	// カリング(1チャンクは512x512ピクセル。空のチャンクは入らない)
+	for (uint32_t y = 0; y < 40; ++y) {
+		tilemap.SetTile(40, y, 3);
+	}
+	uint32_t chunks[6] = {};
+	passed = passed && tilemap.CullChunks({0.0f, 0.0f, 100.0f, 100.0f}, chunks) == 1 && chunks[0] == 0;
+	passed = passed && tilemap.CullChunks({600.0f, 0.0f, 1200.0f, 1000.0f}, chunks) == 3 && chunks[0] == 1 && chunks[1] == 4 && chunks[2] == 5;
+	passed = passed && tilemap.CullChunks({-500.0f, -500.0f, -10.0f, 1000.0f}, chunks) == 0;
+	passed = passed && tilemap.CullChunks({2000.0f, 0.0f, 3000.0f, 1000.0f}, chunks) == 0;
+
+	// 初めて映ったチャンクと、中身が変わったチャンクだけ作り直す
+	std::vector<SpriteVertex> slots(static_cast<size_t>(TilemapChunkCache::kVertexCountPerSlot) * 3);
+	TilemapChunkCache cache;
+	cache.SetDestination(slots.data(), 3);
+	size_t count = tilemap.CullChunks({0.0f, 0.0f, 1000.0f, 1000.0f}, chunks);
+	cache.Prepare(tilemap, chunks, count);
+	passed = passed && count == 3 && cache.GetRebuildCount() == 3 && cache.GetDraws().size() == 3;
+	cache.ResetRebuildCount();
+	cache.Prepare(tilemap, chunks, count);
+	passed = passed && cache.GetRebuildCount() == 0;
+	tilemap.SetTile(45, 35, 2);
+	cache.Prepare(tilemap, chunks, count);
+	passed = passed && cache.GetRebuildCount() == 1;
+	if (passed) {
+		// スロットの頂点はBuildChunkと同じ
+		const TilemapChunkCache::ChunkDraw& draw = cache.GetDraws()[2];
+		uint32_t quadCount = tilemap.BuildChunk(chunks[2], vertices.data());
+		const SpriteVertex* slotVertices = slots.data() + static_cast<size_t>(draw.slot) * TilemapChunkCache::kVertexCountPerSlot;
+		passed = draw.quadCount == quadCount && IsVertex(slotVertices[4 * quadCount - 1], vertices[4 * quadCount - 1].position.x, vertices[4 * quadCount - 1].position.y,
+		                                                   vertices[4 * quadCount - 1].texcoord.x, vertices[4 * quadCount - 1].texcoord.y);
+	}
+	// スロットが足りなければ、今のフレームで使わない一番古いものを使い回す(戻ってきたら作り直す)
+	cache.ResetRebuildCount();
+	tilemap.SetTile(69, 0, 5);
+	uint32_t scrolled[] = {1, 2, 4};
+	cache.Prepare(tilemap, scrolled, 3);
+	passed = passed && cache.GetRebuildCount() == 1;
+	cache.Prepare(tilemap, chunks, count);
+	passed = passed && cache.GetRebuildCount() == 2;
+	// スロットより多く映っていたら、入りきる分だけ描いて残りは数える(空いていないスロットに書き込まない)
+	uint32_t manyChunks[] = {0, 1, 2, 4, 5};
+	cache.Prepare(tilemap, manyChunks, 5);
+	passed = passed && cache.GetDraws().size() == 3 && cache.GetSkippedCount() == 2;
+	cache.Prepare(tilemap, chunks, count);
+	passed = passed && cache.GetDraws().size() == 3 && cache.GetSkippedCount() == 0;
+
+	std::printf("tilemap chunks %s\n\n", passed ? "" : "FAILED");
+	return passed;
+}
+
+// マップを毎フレームスクロールして描くタイルを積む
+// (タイルを1枚ずつスプライトにする場合、チャンクを毎フレーム作る場合、作ったチャンクを使い回す場合の比較)
+void RunTilemapBenchmarks(Benchmark& benchmark) {
+	Tilemap tilemap(kMapSize, kMapSize, {kTileSize, kTileSize}, kTileset, 8, 8);
+	std::mt19937 random(5);
+	for (uint32_t y = 0; y < kMapSize; ++y) {
+		for (uint32_t x = 0; x < kMapSize; ++x) {
+			// 1割は空
+			tilemap.SetTile(x, y, random() % 10 == 0 ? kEmptyTile : static_cast<TileId>(random() % 64 + 1));
+		}
+	}
+	size_t visibleTileCount = static_cast<size_t>(kViewWidth / kTileSize + 1.0f) * static_cast<size_t>(kViewHeight / kTileSize + 1.0f);
+	uint32_t frame = 0;
+	// 毎フレーム画面内のタイルを1つ書き換える
+	auto editTile = [&](const Rect2D& viewport) {
+		uint32_t x = static_cast<uint32_t>(viewport.left / kTileSize) + frame % 16;
+		uint32_t y = static_cast<uint32_t>(viewport.top / kTileSize) + frame % 8;
+		tilemap.SetTile(x, y, static_cast<TileId>(frame % 64 + 1));
+	};
+
+	// タイルを1枚ずつスプライトにする: 全タイルの範囲からカリングして積む
+	SpriteSystem system;
+	for (uint32_t y = 0; y < kMapSize; ++y) {
+		for (uint32_t x = 0; x < kMapSize; ++x) {
+			TileId tile = tilemap.GetTile(x, y);
+			if (tile == kEmptyTile) {
+				continue;
+			}
+			SpriteTextureRegion region = kTileset;
+			region.origin = {16.0f * static_cast<float>((tile - 1) % 8), 16.0f * static_cast<float>((tile - 1) / 8)};
+			region.size = {16.0f, 16.0f};
+			SpriteHandle sprite = system.Create(region);
+			system.SetPosition(sprite, {kTileSize * static_cast<float>(x), kTileSize * static_cast<float>(y)});
+			system.SetSize(sprite, {kTileSize, kTileSize});
+		}
+	}
+	system.Update();
+	std::vector<Rect2D> bounds(system.GetCount());
+	std::vector<uint32_t> visibleSprites(system.GetCount());
+	std::vector<SpriteVertex> spriteVertices(static_cast<size_t>(system.GetCount()) * SpriteBatchBuilder::kVertexCountPerSprite);
+	SpriteBatchBuilder builder;
+	builder.SetDestination(spriteVertices.data(), system.GetCount());
+	benchmark.Run("Tilemap/perTileSprites", visibleTileCount, [&]() {
+		Rect2D viewport = MakeViewport(++frame);
+		system.ComputeBoundingRects(bounds.data());
+		size_t visibleCount = CullRects(viewport, bounds.data(), bounds.size(), visibleSprites.data());
+		builder.Clear();
+		builder.Add(system, visibleSprites.data(), visibleCount);
+		DoNotOptimize(spriteVertices[0]);
+	});
+
+	// チャンクを毎フレーム作る
+	std::vector<uint32_t> chunks(tilemap.GetChunkCount());
+	std::vector<SpriteVertex> slots(static_cast<size_t>(TilemapChunkCache::kVertexCountPerSlot) * kSlotCount);
+	benchmark.Run("Tilemap/rebuildChunks", visibleTileCount, [&]() {
+		Rect2D viewport = MakeViewport(++frame);
+		editTile(viewport);
+		size_t count = tilemap.CullChunks(viewport, chunks.data());
+		for (size_t i = 0; i < count; ++i) {
+			tilemap.BuildChunk(chunks[i], slots.data() + i * TilemapChunkCache::kVertexCountPerSlot);
+		}
+		DoNotOptimize(slots[0]);
+	});
+
+	// 作ったチャンクを使い回す(映り始めたチャンクと書き換えたチャンクだけ作る)
+	TilemapChunkCache cache;
+	cache.SetDestination(slots.data(), kSlotCount);
+	uint32_t cachedFrameCount = 0;
+	size_t drawCount = 0;
+	benchmark.Run("Tilemap/cachedChunks", visibleTileCount, [&]() {
+		Rect2D viewport = MakeViewport(++frame);
+		editTile(viewport);
+		size_t count = tilemap.CullChunks(viewport, chunks.data());
+		cache.Prepare(tilemap, chunks.data(), count);
+		drawCount = cache.GetDraws().size();
+		++cachedFrameCount;
+		DoNotOptimize(slots[0]);
+	});
+
+	// 計測しなかった場合(--filter)は表示しない
+	if (cachedFrameCount != 0) {
+		std::printf("Tilemap (%ux%u tiles, %u chunks, 1 tile edited per frame)\n", kMapSize, kMapSize, tilemap.GetChunkCount());
+		std::printf("  draw calls      : %zu (Sprite::Draw per tile) -> %zu (per chunk)\n", visibleTileCount, drawCount);
+		std::printf("  chunks rebuilt  : %.2f per frame\n\n", static_cast<double>(cache.GetRebuildCount()) / cachedFrameCount);
+	}
+}
@@ -0,0 +1,109 @@
+#include "Benchmark.h"
+#include "base/FastTrig.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 精度を調べる範囲と許容誤差
+struct AccuracyCase {
+	const char* name;
+	bool precise;
+	float range;
+	double maxAbsError;
+};
+
+const AccuracyCase kAccuracyCases[] = {
+    {"SinCos     |x|<=pi  ", true, 3.14159265f, 2.0e-7},
+    {"SinCos     |x|<8192 ", true, 8192.0f, 2.0e-7},
+    {"SinCosFast |x|<=pi  ", false, 3.14159265f, 2.0e-6},
+    {"SinCosFast |x|<100  ", false, 100.0f, 1.0e-5},
+};
+
+// 調べる点の数
+const int kAccuracySteps = 1 << 21;
+
+// ULPを数える値の下限
+const double kUlpMinValue = 1.0 / 1024.0;
+
+// 値付近の1ULPの大きさ
+double Ulp(double value) {
+	float f = static_cast<float>(std::fabs(value));
+	return static_cast<double>(std::nextafter(f, std::numeric_limits<float>::infinity()) - f);
+}
+
+} // namespace
+
+// sin/cosの誤差をdoubleのstd::sin/cosと比べる
+bool RunTrigAccuracyCheck() {
+	bool passed = true;
+	std::printf("%-22s %14s %14s\n", "accuracy", "maxAbsError", "maxUlp");
+	for (const AccuracyCase& accuracyCase : kAccuracyCases) {
+		double maxAbsError = 0.0;
+		double maxUlp = 0.0;
+		for (int i = -kAccuracySteps; i <= kAccuracySteps; ++i) {
+			float x = accuracyCase.range * static_cast<float>(static_cast<double>(i) / kAccuracySteps);
+			float s, c;
+			if (accuracyCase.precise) {
+				SinCos(x, s, c);
+			} else {
+				SinCosFast(x, s, c);
+			}
+			double referenceSin = std::sin(static_cast<double>(x));
+			double referenceCos = std::cos(static_cast<double>(x));
+			double errorSin = std::fabs(static_cast<double>(s) - referenceSin);
+			double errorCos = std::fabs(static_cast<double>(c) - referenceCos);
+			maxAbsError = std::max({maxAbsError, errorSin, errorCos});
+			// 0付近は絶対誤差で見るので、ULPは|y|が十分大きいところだけ
+			if (std::fabs(referenceSin) >= kUlpMinValue) {
+				maxUlp = std::max(maxUlp, errorSin / Ulp(referenceSin));
+			}
+			if (std::fabs(referenceCos) >= kUlpMinValue) {
+				maxUlp = std::max(maxUlp, errorCos / Ulp(referenceCos));
+			}
+		}
+		bool ok = maxAbsError <= accuracyCase.maxAbsError;
+		passed = passed && ok;
+		std::printf("%-22s %14.3e %14.1f %s\n", accuracyCase.name, maxAbsError, maxUlp, ok ? "" : "FAILED");
+	}
+	std::printf("\n");
+	return passed;
+}
+
+// sin/cosの速度をlibmと比べる
+void RunTrigBenchmarks(Benchmark& benchmark) {
+	const size_t kCount = 4096;
+	std::mt19937 random(2319);
+	std::uniform_real_distribution<float> distribution(-3.14159265f, 3.14159265f);
+	std::vector<float> x(kCount), sinValues(kCount), cosValues(kCount);
+	for (float& value : x) {
+		value = distribution(random);
+	}
+
+	benchmark.Run("SinCos/std", kCount, [&]() {
+		for (size_t i = 0; i < kCount; ++i) {
+			sinValues[i] = std::sin(x[i]);
+			cosValues[i] = std::cos(x[i]);
+		}
+		DoNotOptimize(sinValues[0]);
+		DoNotOptimize(cosValues[0]);
+	});
+	benchmark.Run("SinCos/scalar", kCount, [&]() {
+		for (size_t i = 0; i < kCount; ++i) {
+			SinCos(x[i], sinValues[i], cosValues[i]);
+		}
+		DoNotOptimize(sinValues[0]);
+	});
+	benchmark.Run("SinCos/batch", kCount, [&]() {
+		SinCosBatch(x.data(), sinValues.data(), cosValues.data(), kCount);
+		DoNotOptimize(sinValues[0]);
+	});
+	benchmark.Run("SinCosFast/batch", kCount, [&]() {
+		SinCosFastBatch(x.data(), sinValues.data(), cosValues.data(), kCount);
+		DoNotOptimize(sinValues[0]);
+	});
+}
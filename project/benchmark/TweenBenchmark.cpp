@@ -0,0 +1,177 @@
+#include "2d/SpriteSystem.h"
+#include "2d/TweenSystem.h"
+#include "Benchmark.h"
+#include "base/Easing.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 計測するTween数(項目ごとに同じ数)
+const uint32_t kTweenCountPerProperty = 10000;
+const uint32_t kTweenCount = kTweenCountPerProperty * static_cast<uint32_t>(TweenProperty::kCount);
+// 1フレームの経過時間
+const float kDeltaTime = 1.0f / 60.0f;
+
+// 以前のように1つずつ持ち、毎回イージングを計算するTween
+struct ScalarTween {
+	SpriteHandle target;
+	TweenProperty property;
+	float start[4];
+	float end[4];
+	float elapsed;
+	float duration;
+	EasingType easing;
+};
+
+// 往復させたときの0〜1の時間
+float YoyoTime(float elapsed, float duration) {
+	float u = std::fmod(elapsed / duration, 2.0f);
+	return u <= 1.0f ? u : 2.0f - u;
+}
+
+bool IsNear(float a, float b, float tolerance) { return std::fabs(a - b) <= tolerance; }
+
+} // namespace
+
+// 焼き込んだイージングの誤差と、Tweenの進み方を調べる
+bool RunTweenCheck() {
+	// 表と直接計算の差
+	const EasingTable& table = EasingTable::GetInstance();
+	float maxError = 0.0f;
+	bool passed = true;
+	for (uint32_t type = 0; type < static_cast<uint32_t>(EasingType::kCount); ++type) {
+		EasingType easing = static_cast<EasingType>(type);
+		passed = passed && IsNear(Ease(easing, 0.0f), 0.0f, 1.0e-6f) && IsNear(Ease(easing, 1.0f), 1.0f, 1.0e-6f);
+		for (uint32_t i = 0; i <= 10000; ++i) {
+			float t = static_cast<float>(i) / 10000.0f;
+			maxError = std::max(maxError, std::fabs(table.Evaluate(easing, t) - Ease(easing, t)));
+		}
+	}
+	passed = passed && maxError < 5.0e-3f;
+
+	SpriteSystem system;
+	TweenSystem tween;
+	SpriteHandle sprite = system.Create(0, {64.0f, 64.0f});
+
+	// kOnceは終わりの値で止まって取り除かれる
+	tween.TweenPosition(system, sprite, {100.0f, 50.0f}, {1.0f, EasingType::kLinear, TweenLoopMode::kOnce});
+	tween.Update(0.25f, system);
+	passed = passed && IsNear(system.GetPosition(sprite).x, 25.0f, 1.0e-3f) && IsNear(system.GetPosition(sprite).y, 12.5f, 1.0e-3f);
+	tween.Update(1.0f, system);
+	passed = passed && IsNear(system.GetPosition(sprite).x, 100.0f, 1.0e-4f) && tween.GetCount() == 0;
+
+	// 遅延中は始まりの値のまま
+	tween.TweenRotation(system, sprite, 1.0f, {1.0f, EasingType::kLinear, TweenLoopMode::kLoop, 0.5f});
+	tween.Update(0.25f, system);
+	passed = passed && system.GetRotation(sprite) == 0.0f;
+	// kLoopは始まりに戻って繰り返す(遅延の残り0.25秒 + 1.25秒)
+	tween.Update(1.5f, system);
+	passed = passed && IsNear(system.GetRotation(sprite), 0.25f, 1.0e-3f) && tween.IsTweening(sprite, TweenProperty::kRotation);
+
+	// kYoyoは逆向きに戻る
+	tween.TweenSize(system, sprite, {128.0f, 32.0f}, {1.0f, EasingType::kLinear, TweenLoopMode::kYoyo});
+	tween.Update(1.5f, system);
+	passed = passed && IsNear(system.GetSize(sprite).x, 96.0f, 1.0e-2f) && IsNear(system.GetSize(sprite).y, 48.0f, 1.0e-2f);
+
+	// 同じ項目は置き換え、止めたら今の値のまま
+	tween.TweenSize(system, sprite, {10.0f, 10.0f}, {1.0f, EasingType::kLinear, TweenLoopMode::kOnce});
+	passed = passed && tween.GetCount(TweenProperty::kSize) == 1;
+	tween.Cancel(sprite, TweenProperty::kSize);
+	tween.Update(0.5f, system);
+	passed = passed && IsNear(system.GetSize(sprite).x, 96.0f, 1.0e-2f) && !tween.IsTweening(sprite, TweenProperty::kSize);
+
+	// 削除したスプライトのTweenはUpdateで取り除く
+	system.Destroy(sprite);
+	tween.Update(kDeltaTime, system);
+	passed = passed && tween.GetCount() == 0;
+
+	// 4つずつの計算と端数の計算が、1つずつ直接計算したものと同じになる
+	std::vector<SpriteHandle> sprites(103);
+	for (uint32_t i = 0; i < sprites.size(); ++i) {
+		sprites[i] = system.Create(0, {64.0f, 64.0f});
+		EasingType easing = static_cast<EasingType>(i % static_cast<uint32_t>(EasingType::kCount));
+		tween.TweenColor(system, sprites[i], {0.0f, 0.5f, static_cast<float>(i) / 103.0f, 0.0f}, {2.0f, easing, TweenLoopMode::kOnce});
+	}
+	tween.Update(0.7f, system);
+	for (uint32_t i = 0; i < sprites.size(); ++i) {
+		float eased = Ease(static_cast<EasingType>(i % static_cast<uint32_t>(EasingType::kCount)), 0.35f);
+		const Vector4& color = system.GetColor(sprites[i]);
+		passed = passed && IsNear(color.x, 1.0f - eased, 2.0e-3f) && IsNear(color.y, 1.0f - 0.5f * eased, 2.0e-3f) && IsNear(color.w, 1.0f - eased, 2.0e-3f);
+	}
+
+	std::printf("tween (easing table maxError %.3e) %s\n\n", maxError, passed ? "" : "FAILED");
+	return passed;
+}
+
+// Tweenの計算(1つずつ持って毎回イージングを計算する場合と、TweenSystemの比較)
+// どちらも往復させ続け、毎フレーム全スプライトに書き込む
+void RunTweenBenchmarks(Benchmark& benchmark) {
+	std::mt19937 random(1597);
+	std::uniform_real_distribution<float> value(0.0f, 512.0f);
+	std::uniform_real_distribution<float> duration(0.5f, 3.0f);
+
+	SpriteSystem system;
+	TweenSystem tween;
+	std::vector<ScalarTween> scalarTweens(kTweenCount);
+	for (uint32_t i = 0; i < kTweenCount; ++i) {
+		// 項目ごとに別のスプライトにする(1つのスプライトに4項目)
+		uint32_t spriteIndex = i / static_cast<uint32_t>(TweenProperty::kCount);
+		if (spriteIndex >= system.GetCount()) {
+			system.Create(0, {64.0f, 64.0f});
+		}
+		SpriteHandle sprite = system.GetHandle(spriteIndex);
+		TweenProperty property = static_cast<TweenProperty>(i % static_cast<uint32_t>(TweenProperty::kCount));
+		TweenSystem::Settings settings = {duration(random), static_cast<EasingType>(i % static_cast<uint32_t>(EasingType::kCount)), TweenLoopMode::kYoyo};
+		float end[4] = {value(random), value(random), value(random), value(random)};
+		switch (property) {
+		case TweenProperty::kPosition:
+			tween.TweenPosition(system, sprite, {end[0], end[1]}, settings);
+			break;
+		case TweenProperty::kRotation:
+			tween.TweenRotation(system, sprite, end[0], settings);
+			break;
+		case TweenProperty::kSize:
+			tween.TweenSize(system, sprite, {end[0], end[1]}, settings);
+			break;
+		default:
+			tween.TweenColor(system, sprite, {end[0], end[1], end[2], end[3]}, settings);
+			break;
+		}
+		scalarTweens[i] = {sprite, property, {0.0f, 0.0f, 0.0f, 0.0f}, {end[0], end[1], end[2], end[3]}, 0.0f, settings.duration, settings.easing};
+	}
+
+	benchmark.Run("Tween/scalar", kTweenCount, [&]() {
+		for (ScalarTween& scalar : scalarTweens) {
+			scalar.elapsed += kDeltaTime;
+			float eased = Ease(scalar.easing, YoyoTime(scalar.elapsed, scalar.duration));
+			float v[4];
+			for (int c = 0; c < 4; ++c) {
+				v[c] = scalar.start[c] + (scalar.end[c] - scalar.start[c]) * eased;
+			}
+			switch (scalar.property) {
+			case TweenProperty::kPosition:
+				system.SetPosition(scalar.target, {v[0], v[1]});
+				break;
+			case TweenProperty::kRotation:
+				system.SetRotation(scalar.target, v[0]);
+				break;
+			case TweenProperty::kSize:
+				system.SetSize(scalar.target, {v[0], v[1]});
+				break;
+			default:
+				system.SetColor(scalar.target, {v[0], v[1], v[2], v[3]});
+				break;
+			}
+		}
+		DoNotOptimize(system.GetColors()[0]);
+	});
+
+	benchmark.Run("Tween/system", kTweenCount, [&]() {
+		tween.Update(kDeltaTime, system);
+		DoNotOptimize(system.GetColors()[0]);
+	});
+}
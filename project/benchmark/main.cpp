@@ -0,0 +1,133 @@
+// エンジンの計算部分のマイクロベンチマーク
+// Windowsに依存しないので、Visual Studio以外でもビルドできる
+//
+// Linuxでのビルド例(projectディレクトリでbashから1行で実行。ソースはMathBenchmark.vcxprojと同じものを並べる):
+//   g++ -std=c++20 -O2 -pthread -Iengine -Iexternals benchmark/*.cpp
+//     engine/base/{Culling,Easing,FastTrig,Math,TextureAtlas,TransformBatch,VectorMath,WorkerPool}.cpp
+//     engine/2d/{BitmapFont,FlipbookSystem,NineSliceSprite,SpriteBatchBuilder,SpriteBroadphase,SpriteInstance}.cpp
+//     engine/2d/{SpriteRenderQueue,SpriteSystem,TextBuilder,Tilemap,TilemapChunkCache,TweenSystem}.cpp
+//     engine/scene/SceneGraph.cpp -o MathBenchmark
+//
+// 使い方:
+//   MathBenchmark [--json 出力ファイル] [--filter 名前の一部] [--samples 数] [--quick]
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+int main(int argc, char** argv) {
+	Benchmark::Settings settings;
+	std::string jsonPath;
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			jsonPath = argv[++i];
+		} else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			settings.filter = argv[++i];
+		} else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+			settings.sampleCount = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+		} else if (std::strcmp(argv[i], "--quick") == 0) {
+			// 動作確認用に短くする
+			settings.warmupMs = 1.0;
+			settings.sampleMs = 1.0;
+			settings.sampleCount = 5;
+		} else {
+			std::fprintf(stderr, "usage: %s [--json file] [--filter name] [--samples n] [--quick]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// 近似関数の精度が落ちていたら計測する意味がないので先に調べる
+	if (!RunMathCheck()) {
+		std::fprintf(stderr, "math check failed\n");
+		return 1;
+	}
+	if (!RunCullingCheck()) {
+		std::fprintf(stderr, "culling check failed\n");
+		return 1;
+	}
+	if (!RunTrigAccuracyCheck()) {
+		std::fprintf(stderr, "trig accuracy check failed\n");
+		return 1;
+	}
+	if (!RunSpriteInstanceCheck()) {
+		std::fprintf(stderr, "sprite instance check failed\n");
+		return 1;
+	}
+	if (!RunSpriteSystemCheck()) {
+		std::fprintf(stderr, "sprite system check failed\n");
+		return 1;
+	}
+	if (!RunTextureAtlasCheck()) {
+		std::fprintf(stderr, "texture atlas check failed\n");
+		return 1;
+	}
+	if (!RunParallelSpriteCheck()) {
+		std::fprintf(stderr, "parallel sprite check failed\n");
+		return 1;
+	}
+	if (!RunFlipbookCheck()) {
+		std::fprintf(stderr, "flipbook check failed\n");
+		return 1;
+	}
+	if (!RunTweenCheck()) {
+		std::fprintf(stderr, "tween check failed\n");
+		return 1;
+	}
+	if (!RunTextCheck()) {
+		std::fprintf(stderr, "text check failed\n");
+		return 1;
+	}
+	if (!RunNineSliceCheck()) {
+		std::fprintf(stderr, "nine-slice check failed\n");
+		return 1;
+	}
+	if (!RunRenderQueueCheck()) {
+		std::fprintf(stderr, "render queue check failed\n");
+		return 1;
+	}
+	if (!RunTilemapCheck()) {
+		std::fprintf(stderr, "tilemap check failed\n");
+		return 1;
+	}
+	if (!RunBroadphaseCheck()) {
+		std::fprintf(stderr, "broadphase check failed\n");
+		return 1;
+	}
+	if (!RunSceneGraphCheck()) {
+		std::fprintf(stderr, "scene graph check failed\n");
+		return 1;
+	}
+
+	Benchmark benchmark(settings);
+	RunMathBenchmarks(benchmark);
+	RunTrigBenchmarks(benchmark);
+	RunSpriteBenchmarks(benchmark);
+	RunSpriteSystemBenchmarks(benchmark);
+	RunTextureAtlasBenchmarks(benchmark);
+	RunParallelSpriteBenchmarks(benchmark);
+	RunFlipbookBenchmarks(benchmark);
+	RunTweenBenchmarks(benchmark);
+	RunTextBenchmarks(benchmark);
+	RunNineSliceBenchmarks(benchmark);
+	RunRenderQueueBenchmarks(benchmark);
+	RunTilemapBenchmarks(benchmark);
+	RunBroadphaseBenchmarks(benchmark);
+	RunSceneGraphBenchmarks(benchmark);
+
+	benchmark.PrintTable();
+
+	// JSONで出力(回帰の比較用)
+	if (!jsonPath.empty()) {
+		std::ofstream file(jsonPath);
+		if (!file) {
+			std::fprintf(stderr, "failed to open %s\n", jsonPath.c_str());
+			return 1;
+		}
+		file << benchmark.ToJson();
+	}
+	return 0;
+}
@@ -0,0 +1,181 @@
+#include "BitmapFont.h"
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+// imguiのものはimgui_draw.cppの中だけで使えるようにstaticになっているので、こちらでも実装を置く
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imgui/imstb_truetype.h"
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace {
+
+// 壊れたUTF-8の代わりの文字
+const uint32_t kReplacementCodepoint = 0xFFFD;
+
+} // namespace
+
+// ASCIIの表を空にしておく
+BitmapFont::BitmapFont() { std::fill(std::begin(asciiGlyphs_), std::end(asciiGlyphs_), kNoGlyph); }
+
+// TrueTypeのデータから焼き込む
+bool BitmapFont::Build(const std::vector<uint8_t>& fontData, const std::vector<CodepointRange>& ranges, std::string_view text, const Settings& settings) {
+	*this = BitmapFont();
+
+	stbtt_fontinfo info;
+	int fontOffset = stbtt_GetFontOffsetForIndex(fontData.data(), static_cast<int>(settings.fontIndex));
+	if (fontOffset < 0 || !stbtt_InitFont(&info, fontData.data(), fontOffset)) {
+		return false;
+	}
+	float scale = stbtt_ScaleForPixelHeight(&info, settings.pixelHeight);
+	int ascent = 0, descent = 0, lineGap = 0;
+	stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+	SetLineMetrics(static_cast<float>(ascent) * scale, static_cast<float>(ascent - descent + lineGap) * scale);
+
+	// 焼き込む文字(範囲と文字列から集めて重複を除く)
+	std::vector<uint32_t> codepoints;
+	for (const CodepointRange& range : ranges) {
+		for (uint32_t codepoint = range.first; codepoint <= range.last; ++codepoint) {
+			codepoints.push_back(codepoint);
+		}
+	}
+	for (const char* it = text.data(); it != text.data() + text.size();) {
+		codepoints.push_back(DecodeUtf8(it, text.data() + text.size()));
+	}
+	codepoints.push_back(kFallbackCodepoint);
+	std::sort(codepoints.begin(), codepoints.end());
+	codepoints.erase(std::unique(codepoints.begin(), codepoints.end()), codepoints.end());
+
+	// 1文字ずつ描いてアトラスの入力にする(白で、濃さはアルファに入れる)
+	std::vector<AtlasImage> images;
+	std::vector<uint32_t> imageCodepoints;
+	std::vector<uint8_t> coverage;
+	for (uint32_t codepoint : codepoints) {
+		int glyphIndex = stbtt_FindGlyphIndex(&info, static_cast<int>(codepoint));
+		if (glyphIndex == 0) {
+			continue;
+		}
+		int advance = 0, leftSideBearing = 0;
+		stbtt_GetGlyphHMetrics(&info, glyphIndex, &advance, &leftSideBearing);
+		int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+		stbtt_GetGlyphBitmapBox(&info, glyphIndex, scale, scale, &x0, &y0, &x1, &y1);
+
+		Glyph glyph;
+		glyph.advance = static_cast<float>(advance) * scale;
+		if (x1 > x0 && y1 > y0) {
+			glyph.offset = {static_cast<float>(x0), static_cast<float>(y0)};
+			glyph.size = {static_cast<float>(x1 - x0), static_cast<float>(y1 - y0)};
+
+			AtlasImage& image = images.emplace_back();
+			image.name = std::to_string(codepoint);
+			image.width = static_cast<uint32_t>(x1 - x0);
+			image.height = static_cast<uint32_t>(y1 - y0);
+			coverage.assign(static_cast<size_t>(image.width) * image.height, 0);
+			stbtt_MakeGlyphBitmap(&info, coverage.data(), x1 - x0, y1 - y0, x1 - x0, scale, scale, glyphIndex);
+			image.pixels.resize(coverage.size() * TextureAtlas::kBytesPerPixel);
+			for (size_t i = 0; i < coverage.size(); ++i) {
+				uint8_t* pixel = image.pixels.data() + i * TextureAtlas::kBytesPerPixel;
+				pixel[0] = 255;
+				pixel[1] = 255;
+				pixel[2] = 255;
+				pixel[3] = coverage[i];
+			}
+			imageCodepoints.push_back(codepoint);
+		}
+		AddGlyph(codepoint, glyph);
+	}
+
+	if (!atlas_.Build(images, settings.atlas)) {
+		return false;
+	}
+	pageCount_ = static_cast<uint32_t>(atlas_.GetPages().size());
+
+	// 詰めた場所を文字に書き込む
+	for (size_t i = 0; i < images.size(); ++i) {
+		const AtlasRegion* region = atlas_.FindRegion(images[i].name);
+		assert(region != nullptr);
+		Glyph& glyph = glyphs_[FindExact(imageCodepoints[i]) - glyphs_.data()];
+		glyph.page = region->page;
+		glyph.uvRect = region->uvRect;
+	}
+	return true;
+}
+
+// 行の高さ
+void BitmapFont::SetLineMetrics(float ascent, float lineHeight) {
+	ascent_ = ascent;
+	lineHeight_ = lineHeight;
+}
+
+// 文字の追加(同じ文字なら上書き)
+void BitmapFont::AddGlyph(uint32_t codepoint, const Glyph& glyph) {
+	pageCount_ = std::max(pageCount_, glyph.page + 1);
+	const Glyph* existing = FindExact(codepoint);
+	if (existing != nullptr) {
+		glyphs_[existing - glyphs_.data()] = glyph;
+		return;
+	}
+	uint32_t index = static_cast<uint32_t>(glyphs_.size());
+	glyphs_.push_back(glyph);
+	if (codepoint < kAsciiCount) {
+		asciiGlyphs_[codepoint] = index;
+	} else {
+		glyphIndices_[codepoint] = index;
+	}
+}
+
+// 文字を探す
+const Glyph* BitmapFont::FindGlyph(uint32_t codepoint) const {
+	const Glyph* glyph = FindExact(codepoint);
+	return glyph != nullptr ? glyph : FindExact(kFallbackCodepoint);
+}
+
+// 登録済みの文字を探す
+const Glyph* BitmapFont::FindExact(uint32_t codepoint) const {
+	if (codepoint < kAsciiCount) {
+		uint32_t index = asciiGlyphs_[codepoint];
+		return index != kNoGlyph ? &glyphs_[index] : nullptr;
+	}
+	auto it = glyphIndices_.find(codepoint);
+	return it != glyphIndices_.end() ? &glyphs_[it->second] : nullptr;
+}
+
+// UTF-8を1文字読む
+uint32_t DecodeUtf8(const char*& it, const char* end) {
+	uint8_t lead = static_cast<uint8_t>(*it++);
+	if (lead < 0x80) {
+		return lead;
+	}
+	// 続くバイト数と、先頭のバイトに入っているビット
+	uint32_t continuationCount = 0;
+	uint32_t codepoint = 0;
+	if ((lead & 0xE0) == 0xC0) {
+		continuationCount = 1;
+		codepoint = lead & 0x1Fu;
+	} else if ((lead & 0xF0) == 0xE0) {
+		continuationCount = 2;
+		codepoint = lead & 0x0Fu;
+	} else if ((lead & 0xF8) == 0xF0) {
+		continuationCount = 3;
+		codepoint = lead & 0x07u;
+	} else {
+		return kReplacementCodepoint;
+	}
+	if (static_cast<size_t>(end - it) < continuationCount) {
+		return kReplacementCodepoint;
+	}
+	for (uint32_t i = 0; i < continuationCount; ++i) {
+		uint8_t next = static_cast<uint8_t>(it[i]);
+		if ((next & 0xC0) != 0x80) {
+			return kReplacementCodepoint;
+		}
+		codepoint = (codepoint << 6) | (next & 0x3Fu);
+	}
+	it += continuationCount;
+	return codepoint;
+}
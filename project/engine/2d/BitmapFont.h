@@ -0,0 +1,88 @@
+#pragma once
+#include "base/MathTypes.h"
+#include "base/TextureAtlas.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 文字コードの範囲(両端を含む)
+struct CodepointRange {
+	uint32_t first;
+	uint32_t last;
+};
+
+// 1文字分の画像の場所と並べ方
+struct Glyph {
+	// ペンの位置(ベースライン上)から四角形の左上までのずれと、四角形の大きさ(ピクセル。空白は0)
+	Vector2 offset = {0.0f, 0.0f};
+	Vector2 size = {0.0f, 0.0f};
+	// 次の文字までの送り幅
+	float advance = 0.0f;
+	// アトラスのページ番号と、左上・右下のUV
+	uint32_t page = 0;
+	Vector4 uvRect = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+// ビットマップフォント(DirectXに依存しない部分)
+// TrueTypeの文字をimstb_truetypeで1文字ずつ描き、TextureAtlasで数枚のページに詰める
+// 漢字は全部焼き込むとページが大量に要るので、範囲ではなく使う文字を文字列で渡す
+class BitmapFont {
+public:
+	struct Settings {
+		// 文字の高さ(ピクセル。ascentからdescentまで)
+		float pixelHeight = 32.0f;
+		// ttcの中のフォント番号
+		uint32_t fontIndex = 0;
+		// ページの設定(ミップマップを使うのでgutterを空ける)
+		TextureAtlas::Settings atlas = {1024, 2, 1};
+	};
+
+	// よく使う範囲
+	static constexpr CodepointRange kBasicLatin = {0x20, 0x7E};
+	static constexpr CodepointRange kJapanesePunctuation = {0x3000, 0x303F};
+	static constexpr CodepointRange kHiraganaKatakana = {0x3040, 0x30FF};
+	static constexpr CodepointRange kFullwidthForms = {0xFF00, 0xFFEF};
+	// フォントにない文字の代わりに使う文字
+	static constexpr uint32_t kFallbackCodepoint = '?';
+
+	BitmapFont();
+
+	// TrueType(ttf・ttc)のデータからrangesの文字とtextに含まれる文字を焼き込む
+	// フォントが読めない・ページに入らない文字があればfalse。フォントにない文字は飛ばす
+	bool Build(const std::vector<uint8_t>& fontData, const std::vector<CodepointRange>& ranges, std::string_view text, const Settings& settings);
+
+	// 手で組み立てる(自前で描いた画像のフォント用。ページの画像は持たない)
+	void SetLineMetrics(float ascent, float lineHeight);
+	void AddGlyph(uint32_t codepoint, const Glyph& glyph);
+
+	// 文字を探す(なければ代わりの文字、それもなければnullptr)
+	const Glyph* FindGlyph(uint32_t codepoint) const;
+	// 行の先頭からベースラインまでの高さと、次の行までの高さ
+	float GetAscent() const { return ascent_; }
+	float GetLineHeight() const { return lineHeight_; }
+	// 文字数
+	size_t GetGlyphCount() const { return glyphs_.size(); }
+	// ページ数(Buildしたならページの画像はGetAtlas().GetPages())
+	uint32_t GetPageCount() const { return pageCount_; }
+	const TextureAtlas& GetAtlas() const { return atlas_; }
+
+private:
+	// ASCIIは表で直接引く
+	static constexpr uint32_t kAsciiCount = 128;
+	static constexpr uint32_t kNoGlyph = UINT32_MAX;
+
+	// 登録済みの文字を探す(なければnullptr)
+	const Glyph* FindExact(uint32_t codepoint) const;
+
+	float ascent_ = 0.0f;
+	float lineHeight_ = 0.0f;
+	uint32_t pageCount_ = 0;
+	std::vector<Glyph> glyphs_;
+	uint32_t asciiGlyphs_[kAsciiCount] = {};
+	std::unordered_map<uint32_t, uint32_t> glyphIndices_;
+	TextureAtlas atlas_;
+};
+
+// UTF-8を1文字読んでitを進める(壊れたバイトはU+FFFDとして1バイト進む)
+uint32_t DecodeUtf8(const char*& it, const char* end);
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+
+// スプライトのブレンドモード
+enum class BlendMode : uint8_t {
+	kNone,   // ブレンドしない
+	kNormal, // アルファブレンド
+	kAdd,    // 加算
+	kCount,
+};
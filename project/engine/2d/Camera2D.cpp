@@ -0,0 +1,90 @@
+#include "Camera2D.h"
+#include <algorithm>
+#include <cfloat>
+
+uint32_t Camera2D::matrixRebuildCount_ = 0;
+
+// 初期化
+void Camera2D::Initialize(float width, float height) {
+	width_ = width;
+	height_ = height;
+	isViewDirty_ = true;
+	isProjectionDirty_ = true;
+	Update();
+}
+
+// 座標のsetter
+void Camera2D::SetPosition(const Vector2& position) {
+	if (position == position_) {
+		return;
+	}
+	position_ = position;
+	isViewDirty_ = true;
+}
+
+// 回転のsetter
+void Camera2D::SetRotation(float rotation) {
+	if (rotation == rotation_) {
+		return;
+	}
+	rotation_ = rotation;
+	isViewDirty_ = true;
+}
+
+// 表示範囲のsetter
+void Camera2D::SetViewSize(float width, float height) {
+	if (width == width_ && height == height_) {
+		return;
+	}
+	width_ = width;
+	height_ = height;
+	isProjectionDirty_ = true;
+}
+
+// 更新処理
+void Camera2D::Update() {
+	if (!isViewDirty_ && !isProjectionDirty_) {
+		return;
+	}
+
+	// ビュー行列はカメラのアフィン変換の逆変換
+	if (isViewDirty_) {
+		AffineTransform cameraTransform = MakeAffineTransform({1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, rotation_}, {position_.x, position_.y, 0.0f});
+		worldMatrix_ = ToMatrix4x4(cameraTransform);
+		viewMatrix_ = ToMatrix4x4(Inverse(cameraTransform));
+		++matrixRebuildCount_;
+	}
+
+	// 平行投影行列
+	if (isProjectionDirty_) {
+		projectionMatrix_ = MakeOrthographicMatrix(0.0f, 0.0f, width_, height_, nearClip_, farClip_);
+		inverseProjectionMatrix_ = Inverse(projectionMatrix_);
+		++matrixRebuildCount_;
+	}
+
+	// (V*P)^-1 = P^-1 * V^-1 で、V^-1はカメラのワールド行列
+	viewProjectionMatrix_ = Multiply(viewMatrix_, projectionMatrix_);
+	inverseViewProjectionMatrix_ = Multiply(inverseProjectionMatrix_, worldMatrix_);
+	++matrixRebuildCount_;
+	++viewProjectionGeneration_;
+
+	// 表示範囲の4隅をワールド座標に戻して、それを囲む矩形を求める
+	const Vector2 corners[4] = {
+	    {0.0f,   0.0f   },
+	    {width_, 0.0f   },
+	    {0.0f,   height_},
+	    {width_, height_},
+	};
+	viewRect_ = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+	for (const Vector2& corner : corners) {
+		float x = corner.x * worldMatrix_.m[0][0] + corner.y * worldMatrix_.m[1][0] + worldMatrix_.m[3][0];
+		float y = corner.x * worldMatrix_.m[0][1] + corner.y * worldMatrix_.m[1][1] + worldMatrix_.m[3][1];
+		viewRect_.left = std::min(viewRect_.left, x);
+		viewRect_.top = std::min(viewRect_.top, y);
+		viewRect_.right = std::max(viewRect_.right, x);
+		viewRect_.bottom = std::max(viewRect_.bottom, y);
+	}
+
+	isViewDirty_ = false;
+	isProjectionDirty_ = false;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "base/Math.h"
+#include "base/MathTypes.h"
+#include "base/Culling.h"
+#include <cstdint>
+
+// スプライト用の2Dカメラ(平行投影)
+// 入力が変わったときだけビュー・プロジェクション行列を作り直す
+class Camera2D {
+public:
+	// 初期化
+	void Initialize(float width, float height);
+
+	// 更新処理(変更があった行列だけ作り直す)
+	void Update();
+
+	// 座標のgetter
+	const Vector2& GetPosition() const { return position_; }
+	// 座標のsetter
+	void SetPosition(const Vector2& position);
+
+	// 回転のgetter
+	float GetRotation() const { return rotation_; }
+	// 回転のsetter
+	void SetRotation(float rotation);
+
+	// 表示範囲のsetter
+	void SetViewSize(float width, float height);
+
+	// 表示範囲のgetter
+	float GetViewWidth() const { return width_; }
+	float GetViewHeight() const { return height_; }
+
+	// 行列のgetter(Update後の値)
+	const Matrix4x4& GetViewMatrix() const { return viewMatrix_; }
+	const Matrix4x4& GetProjectionMatrix() const { return projectionMatrix_; }
+	const Matrix4x4& GetViewProjectionMatrix() const { return viewProjectionMatrix_; }
+	const Matrix4x4& GetInverseViewProjectionMatrix() const { return inverseViewProjectionMatrix_; }
+	// ViewProjectionMatrixを作り直すたびに増える番号(前回の値と比べて変わったかを調べる)
+	uint32_t GetViewProjectionGeneration() const { return viewProjectionGeneration_; }
+
+	// 表示範囲の矩形のgetter(回転している場合はそれを囲む矩形)
+	const Rect2D& GetViewRect() const { return viewRect_; }
+
+	// このフレームで行列を作り直した回数(全カメラ合計)
+	static uint32_t GetMatrixRebuildCount() { return matrixRebuildCount_; }
+	// 行列を作り直した回数のリセット(フレームの最初に呼ぶ)
+	static void ResetMatrixRebuildCount() { matrixRebuildCount_ = 0; }
+
+private:
+	// 座標(画面左上)
+	Vector2 position_ = {0.0f, 0.0f};
+	// 回転
+	float rotation_ = 0.0f;
+	// 表示範囲
+	float width_ = 1280.0f;
+	float height_ = 720.0f;
+	// クリップ距離
+	float nearClip_ = 0.0f;
+	float farClip_ = 100.0f;
+
+	// 変更フラグ
+	bool isViewDirty_ = true;
+	bool isProjectionDirty_ = true;
+
+	// キャッシュした行列
+	Matrix4x4 worldMatrix_ = kIdentity4x4;
+	Matrix4x4 viewMatrix_ = kIdentity4x4;
+	Matrix4x4 projectionMatrix_ = kIdentity4x4;
+	Matrix4x4 inverseProjectionMatrix_ = kIdentity4x4;
+	Matrix4x4 viewProjectionMatrix_ = kIdentity4x4;
+	Matrix4x4 inverseViewProjectionMatrix_ = kIdentity4x4;
+	uint32_t viewProjectionGeneration_ = 0;
+	// 表示範囲の矩形
+	Rect2D viewRect_ = {0.0f, 0.0f, 1280.0f, 720.0f};
+
+	// 行列を作り直した回数
+	static uint32_t matrixRebuildCount_;
+};
@@ -0,0 +1,194 @@
+#include "FlipbookSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// コマを並べたクリップの登録
+FlipbookClipId FlipbookSystem::CreateClip(const SpriteTextureRegion* frames, uint32_t frameCount, float framesPerSecond) {
+	assert(frameCount > 0);
+	assert(framesPerSecond > 0.0f);
+	FlipbookClipId clip = static_cast<FlipbookClipId>(clipFirstFrames_.size());
+	clipFirstFrames_.push_back(static_cast<uint32_t>(frameTable_.size()));
+	clipFrameCounts_.push_back(frameCount);
+	clipFramesPerSecond_.push_back(framesPerSecond);
+	frameTable_.insert(frameTable_.end(), frames, frames + frameCount);
+	return clip;
+}
+
+// 格子状に並んだシートからクリップを作る
+FlipbookClipId FlipbookSystem::CreateGridClip(const SpriteTextureRegion& sheet, uint32_t columns, uint32_t rows, uint32_t frameCount, float framesPerSecond) {
+	assert(columns > 0 && rows > 0);
+	assert(frameCount <= columns * rows);
+	Vector2 cellSize = {sheet.size.x / static_cast<float>(columns), sheet.size.y / static_cast<float>(rows)};
+	std::vector<SpriteTextureRegion> frames(frameCount);
+	for (uint32_t i = 0; i < frameCount; ++i) {
+		SpriteTextureRegion& frame = frames[i];
+		frame.textureIndex = sheet.textureIndex;
+		frame.textureSize = sheet.textureSize;
+		frame.origin = {sheet.origin.x + cellSize.x * static_cast<float>(i % columns), sheet.origin.y + cellSize.y * static_cast<float>(i / columns)};
+		frame.size = cellSize;
+	}
+	return CreateClip(frames.data(), frameCount, framesPerSecond);
+}
+
+// クリップのコマの画像の範囲
+const SpriteTextureRegion& FlipbookSystem::GetClipFrame(FlipbookClipId clip, uint32_t frame) const {
+	assert(frame < clipFrameCounts_[clip]);
+	return frameTable_[clipFirstFrames_[clip] + frame];
+}
+
+// 再生する
+void FlipbookSystem::Play(SpriteHandle sprite, FlipbookClipId clip, FlipbookPlayMode mode, float speed) {
+	assert(clip < clipFirstFrames_.size());
+	uint32_t index = FindAnimation(sprite);
+	if (index == kNoIndex) {
+		// 後ろに追加する
+		index = static_cast<uint32_t>(sprites_.size());
+		if (sprite.index >= spriteAnimations_.size()) {
+			spriteAnimations_.resize(sprite.index + 1, kNoIndex);
+		}
+		// 削除済みのスプライトが残っていれば先に取り除く(同じスロットを使い回している)
+		if (spriteAnimations_[sprite.index] != kNoIndex) {
+			RemoveAt(spriteAnimations_[sprite.index]);
+			index = static_cast<uint32_t>(sprites_.size());
+		}
+		spriteAnimations_[sprite.index] = index;
+		sprites_.push_back(sprite);
+		clips_.push_back(clip);
+		modes_.push_back(mode);
+		speeds_.push_back(speed);
+		times_.push_back(0.0f);
+		frames_.push_back(kNoFrame);
+		return;
+	}
+	clips_[index] = clip;
+	modes_[index] = mode;
+	speeds_[index] = speed;
+	times_[index] = 0.0f;
+	frames_[index] = kNoFrame;
+}
+
+// 止める
+void FlipbookSystem::Stop(SpriteHandle sprite) {
+	uint32_t index = FindAnimation(sprite);
+	if (index != kNoIndex) {
+		RemoveAt(index);
+	}
+}
+
+// kOnceで最後のコマまで再生し終わったか
+bool FlipbookSystem::IsFinished(SpriteHandle sprite) const {
+	uint32_t index = FindAnimation(sprite);
+	assert(index != kNoIndex);
+	if (modes_[index] != FlipbookPlayMode::kOnce) {
+		return false;
+	}
+	// Advanceで止めた時間と同じ式で比べる(時間に速さを掛け直すと、丸めでコマ数に届かないことがある)
+	return times_[index] >= GetClipDuration(clips_[index]);
+}
+
+// 今のコマ
+uint32_t FlipbookSystem::GetFrame(SpriteHandle sprite) const {
+	uint32_t index = FindAnimation(sprite);
+	assert(index != kNoIndex);
+	// まだ書き込んでいなければ最初のコマ
+	return frames_[index] == kNoFrame ? 0 : frames_[index];
+}
+
+// 再生速度
+void FlipbookSystem::SetSpeed(SpriteHandle sprite, float speed) {
+	uint32_t index = FindAnimation(sprite);
+	assert(index != kNoIndex);
+	speeds_[index] = speed;
+}
+
+// 全アニメーションを進める
+void FlipbookSystem::Update(float deltaTime, SpriteSystem& system) {
+	uint32_t index = 0;
+	while (index < sprites_.size()) {
+		SpriteHandle sprite = sprites_[index];
+		if (!system.IsAlive(sprite)) {
+			// 最後の要素が移ってくるので、同じ位置をもう一度見る
+			RemoveAt(index);
+			continue;
+		}
+
+		// コマが変わったときだけ書き込む
+		uint32_t frame = Advance(index, deltaTime);
+		if (frame != frames_[index]) {
+			frames_[index] = frame;
+			system.SetTextureRegion(sprite, frameTable_[clipFirstFrames_[clips_[index]] + frame]);
+			++frameChangeCount_;
+		}
+		++index;
+	}
+}
+
+// スプライトのアニメーションの配列の位置
+uint32_t FlipbookSystem::FindAnimation(SpriteHandle sprite) const {
+	if (sprite.index >= spriteAnimations_.size()) {
+		return kNoIndex;
+	}
+	uint32_t index = spriteAnimations_[sprite.index];
+	// 同じスロットを使い回した別のスプライトなら再生していない
+	if (index == kNoIndex || sprites_[index] != sprite) {
+		return kNoIndex;
+	}
+	return index;
+}
+
+// 1つ分を進めて、表示するコマを求める
+uint32_t FlipbookSystem::Advance(uint32_t index, float deltaTime) {
+	FlipbookClipId clip = clips_[index];
+	uint32_t frameCount = clipFrameCounts_[clip];
+	float framesPerSecond = clipFramesPerSecond_[clip];
+	float& time = times_[index];
+	time += deltaTime * speeds_[index];
+
+	// 1周のコマ数(往復は両端を1回ずつにするので2 * frameCount - 2)
+	uint32_t cycleFrameCount = frameCount;
+	switch (modes_[index]) {
+	case FlipbookPlayMode::kLoop:
+		break;
+	case FlipbookPlayMode::kPingPong:
+		cycleFrameCount = std::max(frameCount * 2, 3u) - 2;
+		break;
+	case FlipbookPlayMode::kOnce:
+		// 最後まで行ったら止める(それ以上時間を進めない)
+		time = std::clamp(time, 0.0f, GetClipDuration(clip));
+		return std::min(static_cast<uint32_t>(time * framesPerSecond), frameCount - 1);
+	}
+
+	// 1周の長さで折り返す(長く再生しても時間の精度が落ちない)
+	float cycleTime = static_cast<float>(cycleFrameCount) / framesPerSecond;
+	if (time >= cycleTime || time < 0.0f) {
+		time -= std::floor(time / cycleTime) * cycleTime;
+	}
+	uint32_t cycleFrame = std::min(static_cast<uint32_t>(time * framesPerSecond), cycleFrameCount - 1);
+	// 往復の後半は逆順
+	return cycleFrame < frameCount ? cycleFrame : cycleFrameCount - cycleFrame;
+}
+
+// クリップを1回再生する長さ
+float FlipbookSystem::GetClipDuration(FlipbookClipId clip) const { return static_cast<float>(clipFrameCounts_[clip]) / clipFramesPerSecond_[clip]; }
+
+// 1つ分を取り除く
+void FlipbookSystem::RemoveAt(uint32_t index) {
+	uint32_t last = static_cast<uint32_t>(sprites_.size()) - 1;
+	spriteAnimations_[sprites_[index].index] = kNoIndex;
+	if (index != last) {
+		sprites_[index] = sprites_[last];
+		clips_[index] = clips_[last];
+		modes_[index] = modes_[last];
+		speeds_[index] = speeds_[last];
+		times_[index] = times_[last];
+		frames_[index] = frames_[last];
+		spriteAnimations_[sprites_[index].index] = index;
+	}
+	sprites_.pop_back();
+	clips_.pop_back();
+	modes_.pop_back();
+	speeds_.pop_back();
+	times_.pop_back();
+	frames_.pop_back();
+}
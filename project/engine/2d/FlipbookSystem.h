@@ -0,0 +1,93 @@
+#pragma once
+#include "SpriteSystem.h"
+#include <cstdint>
+#include <vector>
+
+// パラパラアニメの再生方法
+enum class FlipbookPlayMode : uint8_t {
+	// 最後のコマの次は最初のコマに戻る
+	kLoop,
+	// 最後のコマまで行ったら逆順に戻る(両端のコマは続けて2回出さない)
+	kPingPong,
+	// 最後のコマで止まる
+	kOnce,
+};
+
+// クリップの番号
+using FlipbookClipId = uint32_t;
+
+// スプライトのパラパラアニメ(DirectXに依存しない部分)
+// クリップはコマごとの画像の範囲を登録時に1つの表に並べておき、再生中は番号で引くだけにする
+// 再生中のアニメーションは項目ごとの配列にまとめ、Updateで同じ経過時間でまとめて進める
+// コマが変わったスプライトだけ画像の範囲を書き込むので、変わらないスプライトは四角形を計算し直さない
+class FlipbookSystem {
+public:
+	// コマを並べたクリップの登録(framesの順に再生する)
+	FlipbookClipId CreateClip(const SpriteTextureRegion* frames, uint32_t frameCount, float framesPerSecond);
+	// 格子状に並んだシートからクリップを作る(sheetの中を左上から横、縦の順にframeCount個)
+	FlipbookClipId CreateGridClip(const SpriteTextureRegion& sheet, uint32_t columns, uint32_t rows, uint32_t frameCount, float framesPerSecond);
+	// クリップのコマ数
+	uint32_t GetClipFrameCount(FlipbookClipId clip) const { return clipFrameCounts_[clip]; }
+	// クリップのコマの画像の範囲
+	const SpriteTextureRegion& GetClipFrame(FlipbookClipId clip, uint32_t frame) const;
+
+	// 再生する(再生中なら最初からやり直す)。最初のコマは次のUpdateで書き込む
+	void Play(SpriteHandle sprite, FlipbookClipId clip, FlipbookPlayMode mode, float speed = 1.0f);
+	// 止める(今のコマのまま残る)
+	void Stop(SpriteHandle sprite);
+	// 再生中か(kOnceで最後まで再生しても、Stopするまでは再生中)
+	bool IsPlaying(SpriteHandle sprite) const { return FindAnimation(sprite) != kNoIndex; }
+	// kOnceで最後のコマまで再生し終わったか
+	bool IsFinished(SpriteHandle sprite) const;
+	// 今のコマ
+	uint32_t GetFrame(SpriteHandle sprite) const;
+	// 再生速度(1で等速、負なら逆再生)
+	void SetSpeed(SpriteHandle sprite, float speed);
+
+	// 全アニメーションをdeltaTime秒進め、コマが変わったスプライトだけ画像の範囲を書き込む
+	// 削除済みのスプライトのアニメーションはここで取り除く(毎フレームのメモリ確保はしない)
+	void Update(float deltaTime, SpriteSystem& system);
+
+	// 再生中のアニメーション数
+	uint32_t GetCount() const { return static_cast<uint32_t>(sprites_.size()); }
+	// Updateでコマを書き込んだ数
+	uint32_t GetFrameChangeCount() const { return frameChangeCount_; }
+	// コマを書き込んだ数のリセット(フレームの最初に呼ぶ)
+	void ResetFrameChangeCount() { frameChangeCount_ = 0; }
+
+private:
+	// アニメーションがないことを表す配列の位置
+	static constexpr uint32_t kNoIndex = UINT32_MAX;
+	// まだ書き込んでいないコマ
+	static constexpr uint32_t kNoFrame = UINT32_MAX;
+
+	// スプライトのアニメーションの配列の位置(なければkNoIndex)
+	uint32_t FindAnimation(SpriteHandle sprite) const;
+	// クリップを1回再生する長さ(秒。kOnceはここで止める)
+	float GetClipDuration(FlipbookClipId clip) const;
+	// 1つ分を進めて、表示するコマを求める
+	uint32_t Advance(uint32_t index, float deltaTime);
+	// 1つ分を取り除く(最後の要素を空いた位置に移す)
+	void RemoveAt(uint32_t index);
+
+	// クリップ(コマの表はframeTable_のclipFirstFrames_から並ぶ)
+	std::vector<SpriteTextureRegion> frameTable_;
+	std::vector<uint32_t> clipFirstFrames_;
+	std::vector<uint32_t> clipFrameCounts_;
+	std::vector<float> clipFramesPerSecond_;
+
+	// 再生中のアニメーション(隙間なく詰める)
+	std::vector<SpriteHandle> sprites_;
+	std::vector<FlipbookClipId> clips_;
+	std::vector<FlipbookPlayMode> modes_;
+	std::vector<float> speeds_;
+	// 再生位置(秒。ループする再生方法では1周の長さで折り返す)
+	std::vector<float> times_;
+	// 書き込み済みのコマ
+	std::vector<uint32_t> frames_;
+
+	// スプライトのスロット番号からアニメーションの配列の位置を引く
+	std::vector<uint32_t> spriteAnimations_;
+
+	uint32_t frameChangeCount_ = 0;
+};
@@ -0,0 +1,81 @@
+#include "InstancedSpriteBatch.h"
+#include "Sprite.h"
+#include "SpriteCommon.h"
+#include "SpriteSystem.h"
+#include "base/TextureManager.h"
+#include <cassert>
+
+// 初期化
+void InstancedSpriteBatch::Initialize(SpriteCommon* spriteCommon, uint32_t maxSprites) {
+	assert(maxSprites > 0);
+	spriteCommon_ = spriteCommon;
+	DirectXCommon* dXCommon = spriteCommon_->GetDXCommon();
+
+	// インスタンスのバッファ(Mapしたままにして毎フレーム書き込む)
+	instanceResource_ = dXCommon->CreateBufferResource(sizeof(SpriteInstance) * maxSprites);
+	assert(instanceResource_ != nullptr);
+	instanceResource_->Map(0, nullptr, reinterpret_cast<void**>(&instanceData_));
+
+	// インデックスバッファ(四角形1枚分。頂点番号からVertexShaderで角を求める)
+	indexResource_ = dXCommon->CreateBufferResource(sizeof(uint32_t) * SpriteBatchBuilder::kIndexCountPerSprite);
+	assert(indexResource_ != nullptr);
+	uint32_t* indexData = nullptr;
+	indexResource_->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+	SpriteBatchBuilder::WriteQuadIndices(indexData, 1);
+	indexResource_->Unmap(0, nullptr);
+	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+	indexBufferView_.SizeInBytes = sizeof(uint32_t) * SpriteBatchBuilder::kIndexCountPerSprite;
+	indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
+
+	// ViewProjection行列
+	viewProjectionResource_ = dXCommon->CreateBufferResource(sizeof(Matrix4x4));
+	assert(viewProjectionResource_ != nullptr);
+	viewProjectionResource_->Map(0, nullptr, reinterpret_cast<void**>(&viewProjectionData_));
+	*viewProjectionData_ = kIdentity4x4;
+
+	builder_.SetDestination(instanceData_, maxSprites);
+}
+
+// 積み始める
+void InstancedSpriteBatch::Begin() {
+	builder_.Clear();
+	drawCallCount_ = 0;
+}
+
+// スプライトを積む
+void InstancedSpriteBatch::Add(const Sprite& sprite) {
+	bool isAdded = builder_.Add(MakeSpriteInstance(sprite.GetQuad(), sprite.GetWorldMatrix(), sprite.GetColor(), sprite.GetTextureIndex()), sprite.GetBlendMode());
+	// 足りなければInitializeのmaxSpritesを増やす
+	assert(isAdded);
+	(void)isAdded;
+}
+
+void InstancedSpriteBatch::Add(const SpriteSystem& system, const uint32_t* indices, size_t count, WorkerPool* workerPool) {
+	bool isAdded = builder_.Add(system, indices, count, workerPool);
+	// 足りなければInitializeのmaxSpritesを増やす
+	assert(isAdded);
+	(void)isAdded;
+}
+
+// 積んだスプライトを描画する
+void InstancedSpriteBatch::End() {
+	if (builder_.GetInstanceCount() == 0) {
+		return;
+	}
+
+	*viewProjectionData_ = spriteCommon_->GetViewProjectionMatrix();
+
+	ID3D12GraphicsCommandList* commandList = spriteCommon_->GetDXCommon()->GetCommandList();
+	// 範囲は積んだ順(描く順番)に並んでいるので、前から順に描く
+	for (const SpriteInstanceBuilder::Range& range : builder_.GetRanges()) {
+		// ルートシグネイチャを設定し直すとルートパラメータも設定し直しになるので、範囲ごとに全部積む
+		spriteCommon_->SetInstancedPipelineState(range.blendMode);
+		commandList->IASetIndexBuffer(&indexBufferView_);
+		commandList->SetGraphicsRootConstantBufferView(0, viewProjectionResource_->GetGPUVirtualAddress());
+		commandList->SetGraphicsRoot32BitConstant(1, range.firstInstance, 0);
+		commandList->SetGraphicsRootShaderResourceView(2, instanceResource_->GetGPUVirtualAddress());
+		commandList->SetGraphicsRootDescriptorTable(3, TextureManager::GetInstance()->GetSrvHandleGPUTop());
+		commandList->DrawIndexedInstanced(SpriteBatchBuilder::kIndexCountPerSprite, range.instanceCount, 0, 0, 0);
+		++drawCallCount_;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "SpriteInstance.h"
+#include "base/DirectXCommon.h"
+#include <d3d12.h>
+#include <wrl.h>
+
+// 前方宣言
+class SpriteCommon;
+class Sprite;
+class SpriteSystem;
+class WorkerPool;
+
+// スプライトをインスタンシングでまとめて描画する
+// 1枚ごとにSpriteInstance(64バイト)を1つ書き込むだけで、頂点はVertexShaderで作る
+// テクスチャはシェーダーでテクスチャ番号から引くので、同じブレンドモードが続く範囲ごとにDrawIndexedInstanced(6, N)を1回積む
+// 積んだ順に描くので、描く順番を決めたいときはSpriteRenderQueueで並べた順に積む
+//
+// インスタンスのバッファはMapしたままにしておく(PostDrawでGPUを待つので、1フレーム分あれば上書きしても問題ない)
+class InstancedSpriteBatch {
+public:
+	// 初期化(maxSpritesは1フレームに描ける最大枚数)
+	void Initialize(SpriteCommon* spriteCommon, uint32_t maxSprites);
+
+	// 積み始める(フレームの始めに呼ぶ)
+	void Begin();
+	// スプライトを積む(Update後のWorld行列・四角形を使う)
+	void Add(const Sprite& sprite);
+	// SpriteSystemのindicesの位置のスプライトをまとめて積む(配列から直接読む。workerPoolがあれば分けて書き込む)
+	void Add(const SpriteSystem& system, const uint32_t* indices, size_t count, WorkerPool* workerPool = nullptr);
+	// 積んだスプライトを描画する
+	void End();
+
+	// 直前のEndで積んだDrawCall数
+	uint32_t GetDrawCallCount() const { return drawCallCount_; }
+	// 直前のEndで描いたスプライト数
+	uint32_t GetSpriteCount() const { return builder_.GetInstanceCount(); }
+
+private:
+	SpriteCommon* spriteCommon_ = nullptr;
+
+	// インスタンス・インデックス・ViewProjection行列のリソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> instanceResource_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> viewProjectionResource_;
+	SpriteInstance* instanceData_ = nullptr;
+	Matrix4x4* viewProjectionData_ = nullptr;
+	D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+
+	SpriteInstanceBuilder builder_;
+	uint32_t drawCallCount_ = 0;
+};
@@ -0,0 +1,117 @@
+#include "NineSliceSprite.h"
+#include "base/Math.h"
+#include <algorithm>
+
+namespace {
+
+// 1辺の頂点数
+const uint32_t kGridSize = 4;
+
+// 1方向の4つの区切り(両端と枠の内側)を求める
+// 大きさが枠の幅の合計より小さければ、枠を同じ割合で縮める
+void ComputeEdges(float start, float length, float insetStart, float insetEnd, float outEdges[kGridSize]) {
+	float insetSum = insetStart + insetEnd;
+	float shrink = insetSum > length && insetSum > 0.0f ? length / insetSum : 1.0f;
+	outEdges[0] = start;
+	outEdges[1] = start + insetStart * shrink;
+	outEdges[2] = start + length - insetEnd * shrink;
+	outEdges[3] = start + length;
+}
+
+} // namespace
+
+NineSliceSprite::NineSliceSprite(const SpriteTextureRegion& region, const NineSliceInsets& insets) : region_(region), insets_(insets), size_(region.size) {}
+
+// 座標のsetter
+void NineSliceSprite::SetPosition(const Vector2& position) {
+	if (position_ == position) {
+		return;
+	}
+	position_ = position;
+	isDirty_ = true;
+}
+
+// 大きさのsetter
+void NineSliceSprite::SetSize(const Vector2& size) {
+	if (size_ == size) {
+		return;
+	}
+	size_ = size;
+	isDirty_ = true;
+}
+
+// 色のsetter
+void NineSliceSprite::SetColor(const Vector4& color) {
+	if (color_ == color) {
+		return;
+	}
+	color_ = color;
+	isDirty_ = true;
+}
+
+// 画像の範囲と枠の幅のsetter
+void NineSliceSprite::SetTextureRegion(const SpriteTextureRegion& region, const NineSliceInsets& insets) {
+	region_ = region;
+	insets_ = insets;
+	isDirty_ = true;
+}
+
+// 頂点を作り直す
+bool NineSliceSprite::Update() {
+	if (!isDirty_) {
+		return false;
+	}
+	isDirty_ = false;
+
+	// 画面上の区切り(枠は縮めることがある)
+	float xs[kGridSize];
+	float ys[kGridSize];
+	ComputeEdges(position_.x, size_.x, insets_.left, insets_.right, xs);
+	ComputeEdges(position_.y, size_.y, insets_.top, insets_.bottom, ys);
+
+	// UVの区切り(画像の中の枠の位置は縮めない)
+	const Vector2& textureSize = region_.textureSize;
+	float us[kGridSize] = {
+	    region_.origin.x / textureSize.x,
+	    (region_.origin.x + insets_.left) / textureSize.x,
+	    (region_.origin.x + region_.size.x - insets_.right) / textureSize.x,
+	    (region_.origin.x + region_.size.x) / textureSize.x,
+	};
+	float vs[kGridSize] = {
+	    region_.origin.y / textureSize.y,
+	    (region_.origin.y + insets_.top) / textureSize.y,
+	    (region_.origin.y + region_.size.y - insets_.bottom) / textureSize.y,
+	    (region_.origin.y + region_.size.y) / textureSize.y,
+	};
+
+	for (uint32_t row = 0; row < kGridSize; ++row) {
+		for (uint32_t column = 0; column < kGridSize; ++column) {
+			vertices_[row * kGridSize + column] = {{xs[column], ys[row], 0.0f, 1.0f}, {us[column], vs[row]}, color_};
+		}
+	}
+	return true;
+}
+
+// インデックスを書き込む
+void NineSliceSprite::WriteIndices(uint32_t* indices, uint32_t panelCount) {
+	for (uint32_t i = 0; i < panelCount; ++i) {
+		uint32_t base = i * kVertexCount;
+		uint32_t* out = indices + static_cast<size_t>(i) * kIndexCount;
+		// 3x3のマスを四角形と同じ順番(左下・左上・右下、左上・右上・右下)で2枚の三角形にする
+		for (uint32_t row = 0; row < kGridSize - 1; ++row) {
+			for (uint32_t column = 0; column < kGridSize - 1; ++column) {
+				uint32_t leftTop = base + row * kGridSize + column;
+				uint32_t rightTop = leftTop + 1;
+				uint32_t leftBottom = leftTop + kGridSize;
+				uint32_t rightBottom = leftBottom + 1;
+				out[0] = leftBottom;
+				out[1] = leftTop;
+				out[2] = rightBottom;
+				out[3] = leftTop;
+				out[4] = rightTop;
+				out[5] = rightBottom;
+				out += SpriteBatchBuilder::kIndexCountPerSprite;
+			}
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "BlendMode.h"
+#include "SpriteBatchBuilder.h"
+#include "SpriteSystem.h"
+#include "base/MathTypes.h"
+#include <cstdint>
+
+// 9分割の枠の幅(画像の端からのピクセル数)
+struct NineSliceInsets {
+	float left = 0.0f;
+	float top = 0.0f;
+	float right = 0.0f;
+	float bottom = 0.0f;
+};
+
+// 9分割スプライト(DirectXに依存しない部分)
+// 画像を枠の幅で3x3に分け、四隅は大きさを変えずに辺と中央だけを伸ばす(UIのパネル用)
+// 9枚のスプライトにはせず、16頂点・54インデックスの1つのメッシュとしてSpriteBatchの頂点の列に書き込む
+// 頂点は座標・大きさ・色・画像が変わったときだけUpdateで作り直す
+class NineSliceSprite {
+public:
+	static const uint32_t kVertexCount = 16;
+	static const uint32_t kIndexCount = 54;
+
+	// 大きさは画像の大きさで始める
+	NineSliceSprite(const SpriteTextureRegion& region, const NineSliceInsets& insets);
+
+	// 左上の座標
+	const Vector2& GetPosition() const { return position_; }
+	void SetPosition(const Vector2& position);
+	// 大きさ(枠の幅の合計より小さければ、その向きの枠を同じ割合で縮める)
+	const Vector2& GetSize() const { return size_; }
+	void SetSize(const Vector2& size);
+	// 色
+	const Vector4& GetColor() const { return color_; }
+	void SetColor(const Vector4& color);
+	// ブレンドモード(頂点は変わらない)
+	BlendMode GetBlendMode() const { return blendMode_; }
+	void SetBlendMode(BlendMode blendMode) { blendMode_ = blendMode; }
+	// 使う画像の範囲と枠の幅
+	void SetTextureRegion(const SpriteTextureRegion& region, const NineSliceInsets& insets);
+	uint32_t GetTextureIndex() const { return region_.textureIndex; }
+
+	// 変更があれば頂点を作り直す(作り直したらtrue)
+	bool Update();
+	// Update後の頂点(変換済み。左上から横に4つずつ4行)
+	const SpriteVertex* GetVertices() const { return vertices_; }
+
+	// 9分割スプライトpanelCount個分のインデックスを書き込む(頂点は16個ずつ並んでいるとする。初期化時に1回だけ)
+	static void WriteIndices(uint32_t* indices, uint32_t panelCount);
+
+private:
+	SpriteTextureRegion region_;
+	NineSliceInsets insets_;
+	Vector2 position_ = {0.0f, 0.0f};
+	Vector2 size_ = {0.0f, 0.0f};
+	Vector4 color_ = {1.0f, 1.0f, 1.0f, 1.0f};
+	BlendMode blendMode_ = BlendMode::kNormal;
+	bool isDirty_ = true;
+	SpriteVertex vertices_[kVertexCount] = {};
+};
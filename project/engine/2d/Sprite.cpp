@@ -1,5 +1,6 @@
 #include "Sprite.h"
 #include "SpriteCommon.h"
+#include "Camera2D.h"
 #include "base/Logger.h"
 #include "base/TextureManager.h"
 using namespace Logger;
@@ -7,6 +8,40 @@ using namespace Logger;
 void Sprite::Initialize(SpriteCommon* spriteCommon, std::string textureFilePath) {
 	this->spriteCommon_ = spriteCommon;
 
+	// スプライトの状態はSpriteSystemに作る(拡縮と切り出しサイズはテクスチャに合わせる)
+	system_ = spriteCommon_->GetSpriteSystem();
+	handle_ = spriteCommon_->CreateSprite(textureFilePath);
+
+	// SRV設定
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	//srvDesc.Format = metadata.format;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	//srvDesc.Texture2D.MipLevels = static_cast<UINT>(metadata.mipLevels);
+
+	// Sprite専用のSRV index を1つ決める
+	uint32_t textureIndex = 1;
+
+	// CPUハンドル（index分ずらす）
+	D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = spriteCommon_->GetDXCommon()->GetSRVCPUDescriptorHandle(textureIndex);
+
+	// ⑤ GPUハンドルを保存（最重要）
+	textureSrvHandleGPU_ = spriteCommon_->GetDXCommon()->GetSRVGPUDescriptorHandle(textureIndex);
+
+	// デバッグ保険
+	//assert(textureSrvHandleGPU_.ptr != 0);
+}
+
+// SpriteSystemのスプライトを削除する
+Sprite::~Sprite() {
+	if (system_ != nullptr) {
+		system_->Destroy(handle_);
+	}
+}
+
+// Draw用のGPUリソースを作る
+// SpriteBatchで描くスプライトは使わないので、1枚ずつ描くときだけ作る
+void Sprite::CreateGpuResources() {
 	// VertexResourceを作る
 	CreateVertexResource();
 	// VertexResourceにデータを書き込むためのアドレスを取得してvertexDataに割り当てる
@@ -22,15 +57,23 @@ void Sprite::Initialize(SpriteCommon* spriteCommon, std::string textureFilePath)
 	// IndexBufferViewを作成する(値を設定する)
 	CreateIndexBufferView();
 
+	// インデックスは変わらないので作ったときに1回だけ書き込む
+	indexData[0] = 0;
+	indexData[1] = 1;
+	indexData[2] = 2;
+	indexData[3] = 1;
+	indexData[4] = 3;
+	indexData[5] = 2;
+
 	// マテリアルリソースを作る
 	CreateMaterialResource();
 	// マテリアルリソースにデータを書き込むためのアドレスを取得してmaterialDataに割り当てる
 	MapMaterialResource();
 
 	// マテリアルデータの初期値を書き込む
-	materialData->color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+	materialData->color = GetColor();
 	materialData->enableLighting = false;
-	materialData->uvTransform = MakeIdentity4x4();
+	materialData->uvTransform = kIdentity4x4;
 
 	// 座標変換行列リソースを作る
 	CreateTransformationMatrixResource();
@@ -38,34 +81,14 @@ void Sprite::Initialize(SpriteCommon* spriteCommon, std::string textureFilePath)
 	MapTransformationMatrixResource();
 
 	// 単位行列を書き込んでおく
-	transformationMatrixData->WVP = MakeIdentity4x4();
-	transformationMatrixData->World = MakeIdentity4x4();
-
-	textureIndex_ = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
-	// SRV設定
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-	//srvDesc.Format = metadata.format;
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	//srvDesc.Texture2D.MipLevels = static_cast<UINT>(metadata.mipLevels);
-
-	// Sprite専用のSRV index を1つ決める
-	uint32_t textureIndex = 1;
-
-	// CPUハンドル（index分ずらす）
-	D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = spriteCommon_->GetDXCommon()->GetSRVCPUDescriptorHandle(textureIndex);
-
-	// ⑤ GPUハンドルを保存（最重要）
-	textureSrvHandleGPU_ = spriteCommon_->GetDXCommon()->GetSRVGPUDescriptorHandle(textureIndex);
-
-	// デバッグ保険
-	//assert(textureSrvHandleGPU_.ptr != 0);
-
-	// 単位行列を書き込んでおく
-	textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
-
-	// テクスチャサイズをイメージに合わせる
-	AdjustTextureSize();
+	transformationMatrixData->WVP = kIdentity4x4;
+	transformationMatrixData->World = kIdentity4x4;
+	transformationMatrixData->WorldInverseTranspose = kIdentity4x4;
+
+	// 作ったばかりなので全部書き込む
+	uploadedRevision_ = system_->GetRevision(handle_) - 1;
+	uploadedColor_ = GetColor();
+	viewProjection_ = nullptr;
 }
 
 // VertexResourceを作る
@@ -138,101 +161,51 @@ void Sprite::MapTransformationMatrixResource() {
 
 // 更新処理
 void Sprite::Update() {
-	// アンカーポイント-反映処理-
-	float left = 0.0f - anchorPoint_.x;
-	float right = 1.0f - anchorPoint_.x;
-	float top = 0.0f - anchorPoint_.y;
-	float bottom = 1.0f - anchorPoint_.y;
-
-	const DirectX::TexMetadata& metadata = 
-		TextureManager::GetInstance()->GetMetadata(textureIndex_);
-	float tex_left = textureLeftTop_.x / metadata.width;
-	float tex_right = (textureLeftTop_.x + textureSize_.x) / metadata.width;
-	float tex_top = textureLeftTop_.y / metadata.height;
-	float tex_bottom = (textureLeftTop_.y + textureSize_.y) / metadata.height;
-
-
-	// 左右反転
-	if (isFlipX_) {
-		left = -left;
-		right = -right;
-		tex_left = -tex_left;
-		tex_right = -tex_right;
-	}
-	// 上下反転
-	if (isFlipY_) {
-		top = -top;
-		bottom = -bottom;
-		tex_top = -tex_top;
-		tex_bottom = -tex_bottom;
-	}
-
-
+	uint32_t index = system_->IndexOf(handle_);
+	system_->Update(&index, 1);
+}
 
+// 描画処理
+void Sprite::Draw() {
+	if (vertexResource_ == nullptr) {
+		CreateGpuResources();
+	}
 
-	// 頂点リソースにデータを書き込む(4点分)
-	// 拡縮-反映処理-
-	// 左下
-	vertexData[0].position = {left, bottom, 0.0f, 1.0f};
-	vertexData[0].texcoord = {tex_left, tex_bottom};
-	vertexData[0].normal = {0.0f, 0.0f, -1.0f};
-	// 左上
-	vertexData[1].position = {left, top, 0.0f, 1.0f};
-	vertexData[1].texcoord = {tex_left, tex_top};
-	vertexData[1].normal = {0.0f, 0.0f, -1.0f};
-
-	// 右下
-	vertexData[2].position = {right, bottom, 0.0f, 1.0f};
-	vertexData[2].texcoord = {tex_right, tex_bottom};
-	vertexData[2].normal = {0.0f, 0.0f, -1.0f};
-
-	// 右上
-	vertexData[3].position = {right, top, 0.0f, 1.0f};
-	vertexData[3].texcoord = {tex_right, tex_top};
-	vertexData[3].normal = {0.0f, 0.0f, -1.0f};
-
-	// インデックスリソースにデータを書き込む(6点分)
-	for (uint32_t lat = 0; lat < kSubdivision; ++lat) {
-		for (uint32_t lon = 0; lon < kSubdivision; ++lon) {
-			indexData[0] = 0;
-			indexData[1] = 1;
-			indexData[2] = 2;
-			indexData[3] = 1;
-			indexData[4] = 3;
-			indexData[5] = 2;
+	// カメラが動いていればWVPを書き込み直す(カメラの行列はキャッシュ済みのものを使う)
+	const Matrix4x4& viewProjectionMatrix = spriteCommon_->GetViewProjectionMatrix();
+	uint32_t viewProjectionGeneration = spriteCommon_->GetViewProjectionGeneration();
+	bool isViewProjectionChanged = &viewProjectionMatrix != viewProjection_ || viewProjectionGeneration != viewProjectionGeneration_;
+	viewProjection_ = &viewProjectionMatrix;
+	viewProjectionGeneration_ = viewProjectionGeneration;
+
+	// Updateで計算し直したものだけバッファに書き込む
+	uint32_t revision = system_->GetRevision(handle_);
+	bool isRebuilt = revision != uploadedRevision_;
+	uploadedRevision_ = revision;
+	if (isRebuilt) {
+		const SpriteQuad& quad = GetQuad();
+		for (uint32_t i = 0; i < kVertexCount; ++i) {
+			vertexData[i].position = {quad.positions[i].x, quad.positions[i].y, 0.0f, 1.0f};
+			vertexData[i].texcoord = quad.texcoords[i];
+			vertexData[i].normal = {0.0f, 0.0f, -1.0f};
 		}
 	}
-	// Transform情報を作る
-	Transform transform{
-	    {1.0f, 1.0f, 1.0f},
-        {0.0f, 0.0f, 0.0f},
-        {0.0f, 0.0f, 0.0f}
-    };
-
-	// 座標-反映処理-
-	transform.translate = {position_.x, position_.y, 0.0f};
-	// 回転-反映処理-
-	transform.rotate = {0.0f, 0.0f, rotation_};
-	// 拡縮-反映処理-
-	transform.scale = {size_.x, size_.y, 1.0f};
-
-	// TransformからWorldMatrixを作る
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-	
-	// ViewMatrixを作って単位行列を代入
-	Matrix4x4 viewMatrix = MakeIdentity4x4();
-
-	// ProjectionMatrixを作って平行投影行列を書き込む
-	Matrix4x4 projectionMatrix = MakeOrthographicMatrix(0.0f, 0.0f, float(WindowsAPI::kClientWidth), float(WindowsAPI::kClientHeight), 0.0f, 100.0f);
-
-	transformationMatrixData->WVP = Multiply(worldMatrix, Multiply(viewMatrix, projectionMatrix));
-	transformationMatrixData->World = worldMatrix;
-
-
-}
+	const Vector4& color = GetColor();
+	if (color != uploadedColor_) {
+		uploadedColor_ = color;
+		materialData->color = color;
+	}
+	if (isRebuilt || isViewProjectionChanged) {
+		const Matrix4x4& worldMatrix = GetWorldMatrix();
+		transformationMatrixData->WVP = Multiply(worldMatrix, viewProjectionMatrix);
+		transformationMatrixData->World = worldMatrix;
+		// 拡縮が縦横で違えば法線は逆転置行列で変換する(同じならWorldをそのまま使い、逆行列を求めない)
+		uint8_t isUniformScale = system_->IsUniformScale(handle_) ? 1 : 0;
+		Matrix3x3 normalMatrix;
+		MakeNormalMatrixBatch(&worldMatrix, &isUniformScale, &normalMatrix, 1);
+		transformationMatrixData->WorldInverseTranspose = ToMatrix4x4(normalMatrix);
+	}
 
-// 描画処理
-void Sprite::Draw() {
 	// VertexBufferViewを設定
 	spriteCommon_->GetDXCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView_);
 	
@@ -246,7 +219,7 @@ void Sprite::Draw() {
 	spriteCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource_->GetGPUVirtualAddress());
 
 	// SRVのDescriptorTableの先頭を設定
-	spriteCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex_));
+	spriteCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(GetTextureIndex()));
 
 	// 描画(DrawCall)
 	spriteCommon_->GetDXCommon()->GetCommandList()->DrawIndexedInstanced(kIndexCount, 1, 0, 0, 0);
@@ -258,24 +231,22 @@ void Sprite::Draw() {
 void Sprite::spriteImGui(int index) {
 	ImGui::PushID(index);
 
-	ImGui::Checkbox("IsFlipX", &isFlipX_);
-	ImGui::Checkbox("IsFlipY", &isFlipY_);
+	// 変更があったときだけ計算し直すのでsetterを通す
+	bool isFlipX = GetIsFlipX();
+	if (ImGui::Checkbox("IsFlipX", &isFlipX)) {
+		SetIsFlipX(isFlipX);
+	}
+	bool isFlipY = GetIsFlipY();
+	if (ImGui::Checkbox("IsFlipY", &isFlipY)) {
+		SetIsFlipY(isFlipY);
+	}
 
 	// テクスチャ切り取りサイズ
-	ImGui::DragFloat2("TextureCutSize", &textureSize_.x, 1.0f, 0.0f, 4096.0f);
+	Vector2 textureSize = GetTextureCutSize();
+	if (ImGui::DragFloat2("TextureCutSize", &textureSize.x, 1.0f, 0.0f, 4096.0f)) {
+		SetTextureCutSize(textureSize);
+	}
 
 
 	ImGui::PopID();
 }
-
-// テクスチャサイズをイメージに合わせる
-void Sprite::AdjustTextureSize() {
-	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetadata(textureIndex_);
-	textureSize_.x = static_cast<float>(metadata.width);
-	textureSize_.y = static_cast<float>(metadata.height);
-
-	// 画像サイズをテクスチャサイズに合わせる
-	size_ = textureSize_;
-
-}
-
@@ -4,6 +4,9 @@
 #include <wrl.h>  
 #include <d3d12.h> 
 #include "base/DirectXCommon.h"
+#include "base/Culling.h"
+#include "scene/SceneGraph.h"
+#include "SpriteSystem.h"
 
 
 // 前方宣言
@@ -27,85 +30,109 @@ public:
 	struct TransformationMatrix {
 		Matrix4x4 WVP;
 		Matrix4x4 World;
+		Matrix4x4 WorldInverseTranspose;
 	};
 
 	static const uint32_t kVertexCount = 4;
 	static const uint32_t kIndexCount = 6;
-	static const uint32_t kSubdivision = 32;
 
-	// 初期化
+	Sprite() = default;
+	// SpriteSystemのスプライトを削除する(SpriteCommonより先に解放する)
+	~Sprite();
+	// ハンドルを2つで持つと二重に削除するのでコピーしない
+	Sprite(const Sprite&) = delete;
+	Sprite& operator=(const Sprite&) = delete;
+
+	// 初期化(SpriteCommonのSpriteSystemにスプライトを作る)
 	void Initialize(SpriteCommon* spriteCommon, std::string textureFilePath);
 
-	// 更新処理
+	// 更新処理(変更があったものだけ計算し直す)
+	// まとめて計算するときはSpriteSystem::Updateを使う
 	void Update();
 
-	// 描画処理
+	// 描画処理(1枚ずつDrawCallを積む。まとめて描くときはSpriteBatch::Addを使う)
+	// GPUリソースは初めて呼んだときに作り、変更があったバッファだけ書き込む
 	void Draw();
 
+	// SpriteSystem上のハンドル
+	SpriteHandle GetHandle() const { return handle_; }
+
 	// 座標のgetter
-	const Vector2& GetPosition() const { return position_; }
+	const Vector2& GetPosition() const { return system_->GetPosition(handle_); }
 	// 座標のsetter
-	void SetPosition(const Vector2& position) { this->position_ = position; }
+	void SetPosition(const Vector2& position) { system_->SetPosition(handle_, position); }
 
 	// 回転のgetter
-	float GetRotation() const { return rotation_; }
+	float GetRotation() const { return system_->GetRotation(handle_); }
 	// 回転のsetter
-	void SetRotation(float rotation) { this->rotation_ = rotation; }
+	void SetRotation(float rotation) { system_->SetRotation(handle_, rotation); }
 
 	// 色のgetter
-	const Vector4& GetColor() const { return materialData->color; }
+	const Vector4& GetColor() const { return system_->GetColor(handle_); }
 	// 色のsetter
-	void SetColor(const Vector4& color) { materialData->color = color; }
+	void SetColor(const Vector4& color) { system_->SetColor(handle_, color); }
+
+	// ブレンドモードのgetter
+	BlendMode GetBlendMode() const { return system_->GetBlendMode(handle_); }
+	// ブレンドモードのsetter(SpriteBatchで描くときだけ有効)
+	void SetBlendMode(BlendMode blendMode) { system_->SetBlendMode(handle_, blendMode); }
+
+	// テクスチャ番号のgetter
+	uint32_t GetTextureIndex() const { return system_->GetTextureIndex(handle_); }
+	// Update後のWorld行列
+	const Matrix4x4& GetWorldMatrix() const { return system_->GetWorldMatrices()[system_->IndexOf(handle_)]; }
+	// Update後の四角形(ローカル座標とUV)
+	const SpriteQuad& GetQuad() const { return system_->GetQuads()[system_->IndexOf(handle_)]; }
 
 	// 拡縮のgetter
-	const Vector2& GetSize() const { return size_; }
+	const Vector2& GetSize() const { return system_->GetSize(handle_); }
 	// 拡縮のsetter
-	void SetSize(const Vector2& size) { this->size_ = size; }
+	void SetSize(const Vector2& size) { system_->SetSize(handle_, size); }
 
 	// テクスチャ変更
 	//void cahngeTexture(std::string textureFilePath);
 
 	// アンカーポイントのgetter
-	const Vector2& GetAnchorPoint() const { return anchorPoint_; }
+	const Vector2& GetAnchorPoint() const { return system_->GetAnchorPoint(handle_); }
 	// アンカーポイントのsetter
-	void SetAnchorPoint(const Vector2& anchorPoint) { this->anchorPoint_ = anchorPoint; }
-
-	
-	// フリップ
-	bool isFlipX_ = false;
-	bool isFlipY_ = false;
-
+	void SetAnchorPoint(const Vector2& anchorPoint) { system_->SetAnchorPoint(handle_, anchorPoint); }
 
 	// フリップXのgetter
-	bool GetIsFlipX() const { return isFlipX_; }
+	bool GetIsFlipX() const { return system_->GetIsFlipX(handle_); }
 	// フリップXのsetter
-	void SetIsFlipX(bool isFlipX) { this->isFlipX_ = isFlipX; }
+	void SetIsFlipX(bool isFlipX) { system_->SetIsFlipX(handle_, isFlipX); }
 
 	// フリップYのgetter
-	bool GetIsFlipY() const { return isFlipY_; }
+	bool GetIsFlipY() const { return system_->GetIsFlipY(handle_); }
 	// フリップYのsetter
-	void SetIsFlipY(bool isFlipY) { this->isFlipY_ = isFlipY; }
+	void SetIsFlipY(bool isFlipY) { system_->SetIsFlipY(handle_, isFlipY); }
 
 	// ImGui表示
 	void spriteImGui(int index);
 
-	// テクスチャ左上座標
-	Vector2 textureLeftTop_ = {0.0f, 0.0f};
-	// テクスチャ切り出しサイズ
-	Vector2 textureSize_ = {100.0f, 100.0f};
+	// 画面上で占める範囲(カリング用。回転している場合は回転しても収まる範囲)
+	Rect2D GetBoundingRect() const { return system_->GetBoundingRect(handle_); }
 
+	// シーングラフのノードに取り付ける(ノードのWorld行列を親として掛ける)
+	// nodeがkInvalidSceneNodeなら取り外す
+	void SetParentNode(const SceneGraph* sceneGraph, SceneNodeId node) { system_->SetParentNode(handle_, sceneGraph, node); }
+	// 親ノードのgetter
+	SceneNodeId GetParentNode() const { return system_->GetParentNode(handle_); }
 
 	// テクスチャ範囲指定のgetter
-	const Vector2& GetTextureLeftTop() const { return textureLeftTop_; }
+	const Vector2& GetTextureLeftTop() const { return system_->GetTextureLeftTop(handle_); }
 	// テクスチャ範囲指定のsetter
-	void SetTextureLeftTop(const Vector2& textureLeftTop) { this->textureLeftTop_ = textureLeftTop; }
+	void SetTextureLeftTop(const Vector2& textureLeftTop) { system_->SetTextureLeftTop(handle_, textureLeftTop); }
 
 	// テクスチャ切り出しサイズのgetter
-	const Vector2& GetTextureCutSize() const { return textureSize_; }
+	const Vector2& GetTextureCutSize() const { return system_->GetTextureCutSize(handle_); }
 	// テクスチャ切り出しサイズのsetter
-	void SetTextureCutSize(const Vector2& textureCutSize) { this->textureSize_ = textureCutSize; }
+	void SetTextureCutSize(const Vector2& textureCutSize) { system_->SetTextureCutSize(handle_, textureCutSize); }
 
 private:
+	// Draw用のGPUリソースを作る
+	void CreateGpuResources();
+
 	// VertexResourceを作る
 	void CreateVertexResource();
 	// VertexResourceにデータを書き込む
@@ -154,19 +181,14 @@ private:
 
 	D3D12_GPU_DESCRIPTOR_HANDLE textureSrvHandleGPU_{};
 
-	// 移動
-	Vector2 position_ = {0.0f, 0.0f};
-	// 回転
-	float rotation_ = 0.0f;
-	// 拡縮
-	Vector2 size_ = {640.0f, 360.0f};
-
-	// テクスチャ番号
-	uint32_t textureIndex_ = 0;
-
-	// アンカーポイント
-	Vector2 anchorPoint_ = {0.0f, 0.0f};
+	// スプライトの状態はSpriteSystemが持つ
+	SpriteSystem* system_ = nullptr;
+	SpriteHandle handle_;
 
-	// テクスチャサイズをイメージに合わせる
-	void AdjustTextureSize();
+	// 最後にバッファに書き込んだときの値(変わったものだけ書き込み直す)
+	uint32_t uploadedRevision_ = 0;
+	Vector4 uploadedColor_ = {1.0f, 1.0f, 1.0f, 1.0f};
+	// 最後にWVPを計算したときのViewProjectionMatrix
+	const Matrix4x4* viewProjection_ = nullptr;
+	uint32_t viewProjectionGeneration_ = 0;
 };
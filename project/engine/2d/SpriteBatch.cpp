@@ -0,0 +1,118 @@
+#include "SpriteBatch.h"
+#include "NineSliceSprite.h"
+#include "Sprite.h"
+#include "SpriteCommon.h"
+#include "SpriteSystem.h"
+#include "TextBuilder.h"
+#include "base/TextureManager.h"
+#include <cassert>
+
+// 初期化
+void SpriteBatch::Initialize(SpriteCommon* spriteCommon, uint32_t maxSprites) {
+	assert(maxSprites > 0);
+	spriteCommon_ = spriteCommon;
+	DirectXCommon* dXCommon = spriteCommon_->GetDXCommon();
+
+	// 頂点バッファ(Mapしたままにして毎フレーム書き込む)
+	size_t vertexBufferSize = sizeof(SpriteVertex) * SpriteBatchBuilder::kVertexCountPerSprite * maxSprites;
+	vertexResource_ = dXCommon->CreateBufferResource(vertexBufferSize);
+	assert(vertexResource_ != nullptr);
+	vertexResource_->Map(0, nullptr, reinterpret_cast<void**>(&vertexData_));
+	vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
+	vertexBufferView_.SizeInBytes = static_cast<UINT>(vertexBufferSize);
+	vertexBufferView_.StrideInBytes = sizeof(SpriteVertex);
+
+	// インデックスバッファ(四角形の並びは変わらないので1回だけ書き込む)
+	// 四角形の後ろに9分割スプライトの並びを置く(9分割スプライトは頂点の位置をずらして同じ範囲を使い回す)
+	uint32_t maxNineSlices = (maxSprites + SpriteBatchBuilder::kSpriteCountPerNineSlice - 1) / SpriteBatchBuilder::kSpriteCountPerNineSlice;
+	nineSliceFirstIndex_ = SpriteBatchBuilder::kIndexCountPerSprite * maxSprites;
+	size_t indexBufferSize = sizeof(uint32_t) * (nineSliceFirstIndex_ + NineSliceSprite::kIndexCount * maxNineSlices);
+	indexResource_ = dXCommon->CreateBufferResource(indexBufferSize);
+	assert(indexResource_ != nullptr);
+	uint32_t* indexData = nullptr;
+	indexResource_->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+	SpriteBatchBuilder::WriteQuadIndices(indexData, maxSprites);
+	NineSliceSprite::WriteIndices(indexData + nineSliceFirstIndex_, maxNineSlices);
+	indexResource_->Unmap(0, nullptr);
+	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+	indexBufferView_.SizeInBytes = static_cast<UINT>(indexBufferSize);
+	indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
+
+	// ViewProjection行列(頂点はWorld変換済みなのでこれだけ掛ける)
+	viewProjectionResource_ = dXCommon->CreateBufferResource(sizeof(Matrix4x4));
+	assert(viewProjectionResource_ != nullptr);
+	viewProjectionResource_->Map(0, nullptr, reinterpret_cast<void**>(&viewProjectionData_));
+	*viewProjectionData_ = kIdentity4x4;
+
+	builder_.SetDestination(vertexData_, maxSprites);
+}
+
+// 積み始める
+void SpriteBatch::Begin() {
+	builder_.Clear();
+	drawCallCount_ = 0;
+}
+
+// スプライトを積む
+void SpriteBatch::Add(const Sprite& sprite) {
+	bool isAdded = builder_.Add(sprite.GetQuad(), sprite.GetWorldMatrix(), sprite.GetColor(), sprite.GetTextureIndex(), sprite.GetBlendMode());
+	// 足りなければInitializeのmaxSpritesを増やす
+	assert(isAdded);
+	(void)isAdded;
+}
+
+void SpriteBatch::Add(const SpriteSystem& system, const uint32_t* indices, size_t count, WorkerPool* workerPool) {
+	bool isAdded = builder_.Add(system, indices, count, workerPool);
+	// 足りなければInitializeのmaxSpritesを増やす
+	assert(isAdded);
+	(void)isAdded;
+}
+
+void SpriteBatch::Add(const NineSliceSprite& sprite) {
+	bool isAdded = builder_.Add(sprite);
+	// 足りなければInitializeのmaxSpritesを増やす
+	assert(isAdded);
+	(void)isAdded;
+}
+
+void SpriteBatch::Add(const TextBuilder& text, uint32_t firstTextureIndex) {
+	for (uint32_t page = 0; page < text.GetPageCount(); ++page) {
+		bool isAdded = builder_.Add(text.GetVertices(page), text.GetGlyphCount(page), firstTextureIndex + page, BlendMode::kNormal);
+		// 足りなければInitializeのmaxSpritesを増やす
+		assert(isAdded);
+		(void)isAdded;
+	}
+}
+
+// 積んだスプライトを描画する
+void SpriteBatch::End() {
+	if (builder_.GetSpriteCount() == 0) {
+		return;
+	}
+
+	*viewProjectionData_ = spriteCommon_->GetViewProjectionMatrix();
+
+	ID3D12GraphicsCommandList* commandList = spriteCommon_->GetDXCommon()->GetCommandList();
+
+	// ランごとに1回だけ描く。PSOはブレンドが変わったときだけ設定し直す
+	BlendMode currentBlendMode = BlendMode::kCount;
+	for (const SpriteBatchBuilder::Run& run : builder_.GetRuns()) {
+		if (run.blendMode != currentBlendMode) {
+			// ルートシグネイチャも設定し直すので、頂点・インデックス・ViewProjectionもここで設定する
+			spriteCommon_->SetBatchPipelineState(run.blendMode);
+			commandList->IASetVertexBuffers(0, 1, &vertexBufferView_);
+			commandList->IASetIndexBuffer(&indexBufferView_);
+			commandList->SetGraphicsRootConstantBufferView(0, viewProjectionResource_->GetGPUVirtualAddress());
+			currentBlendMode = run.blendMode;
+		}
+		commandList->SetGraphicsRootDescriptorTable(1, TextureManager::GetInstance()->GetSrvHandleGPU(run.textureIndex));
+		if (run.mesh == SpriteMesh::kNineSlice) {
+			// 9分割スプライトのインデックスは0番目の頂点から数えているので、頂点の位置をずらして描く
+			INT baseVertex = static_cast<INT>(run.firstSprite * SpriteBatchBuilder::kVertexCountPerSprite);
+			commandList->DrawIndexedInstanced(run.spriteCount * NineSliceSprite::kIndexCount, 1, nineSliceFirstIndex_, baseVertex, 0);
+		} else {
+			commandList->DrawIndexedInstanced(run.spriteCount * SpriteBatchBuilder::kIndexCountPerSprite, 1, run.firstSprite * SpriteBatchBuilder::kIndexCountPerSprite, 0, 0);
+		}
+		++drawCallCount_;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "SpriteBatchBuilder.h"
+#include "base/DirectXCommon.h"
+#include <d3d12.h>
+#include <wrl.h>
+
+// 前方宣言
+class NineSliceSprite;
+class SpriteCommon;
+class Sprite;
+class SpriteSystem;
+class TextBuilder;
+class WorkerPool;
+
+// スプライトをまとめて描画する
+// 毎フレーム見えているスプライトを積み、World変換済みの頂点を1つの頂点バッファに書き込む
+// 同じテクスチャ・ブレンドが続く範囲ごとに1回だけDrawCallを積む
+//
+// 頂点バッファはMapしたままにしておく(PostDrawでGPUを待つので、1フレーム分あれば上書きしても問題ない)
+// インデックスは四角形の並びで固定なので、初期化時に1回だけ書き込む
+class SpriteBatch {
+public:
+	// 初期化(maxSpritesは1フレームに描ける最大枚数。9分割スプライトは4枚と数える)
+	void Initialize(SpriteCommon* spriteCommon, uint32_t maxSprites);
+
+	// 積み始める(フレームの始めに呼ぶ)
+	void Begin();
+	// スプライトを積む(Update後のWorld行列・四角形を使う)
+	void Add(const Sprite& sprite);
+	// SpriteSystemのindicesの位置のスプライトをまとめて積む(配列から直接読む。workerPoolがあれば分けて書き込む)
+	void Add(const SpriteSystem& system, const uint32_t* indices, size_t count, WorkerPool* workerPool = nullptr);
+	// Update後の9分割スプライトを積む(16頂点を1つのメッシュとして書き込む)
+	void Add(const NineSliceSprite& sprite);
+	// TextBuilderに積んだ文字列を積む(ページごとに1つのラン。firstTextureIndexはフォントの0ページ目のテクスチャ番号)
+	void Add(const TextBuilder& text, uint32_t firstTextureIndex);
+	// 積んだスプライトを描画する
+	void End();
+
+	// 直前のEndで積んだDrawCall数
+	uint32_t GetDrawCallCount() const { return drawCallCount_; }
+	// 直前のEndで描いたスプライト数
+	uint32_t GetSpriteCount() const { return builder_.GetSpriteCount(); }
+
+private:
+	SpriteCommon* spriteCommon_ = nullptr;
+
+	// 頂点・インデックス・ViewProjection行列のリソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> viewProjectionResource_;
+	SpriteVertex* vertexData_ = nullptr;
+	Matrix4x4* viewProjectionData_ = nullptr;
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
+	D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+
+	SpriteBatchBuilder builder_;
+	// インデックスバッファの中の9分割スプライトの並びの先頭
+	uint32_t nineSliceFirstIndex_ = 0;
+	uint32_t drawCallCount_ = 0;
+};
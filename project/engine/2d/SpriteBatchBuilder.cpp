@@ -0,0 +1,146 @@
+#include "SpriteBatchBuilder.h"
+#include "NineSliceSprite.h"
+#include "SpriteSystem.h"
+#include "base/WorkerPool.h"
+#include <cstring>
+
+namespace {
+
+// ローカル座標(z = 0)をWorld行列で変換して1枚分の頂点を書き込む
+void WriteSpriteVertices(SpriteVertex* out, const SpriteQuad& quad, const Matrix4x4& worldMatrix, const Vector4& color) {
+	const Matrix4x4& m = worldMatrix;
+	for (uint32_t i = 0; i < SpriteBatchBuilder::kVertexCountPerSprite; ++i) {
+		float x = quad.positions[i].x;
+		float y = quad.positions[i].y;
+		out[i].position = {
+		    x * m.m[0][0] + y * m.m[1][0] + m.m[3][0],
+		    x * m.m[0][1] + y * m.m[1][1] + m.m[3][1],
+		    x * m.m[0][2] + y * m.m[1][2] + m.m[3][2],
+		    1.0f,
+		};
+		out[i].texcoord = quad.texcoords[i];
+		out[i].color = color;
+	}
+}
+
+} // namespace
+
+// 書き込み先の設定
+void SpriteBatchBuilder::SetDestination(SpriteVertex* vertices, uint32_t maxSprites) {
+	vertices_ = vertices;
+	maxSprites_ = maxSprites;
+	Clear();
+}
+
+// 積んだスプライトを空にする
+void SpriteBatchBuilder::Clear() {
+	spriteCount_ = 0;
+	runs_.clear();
+}
+
+// スプライトを1枚積む
+bool SpriteBatchBuilder::Add(const SpriteQuad& quad, const Matrix4x4& worldMatrix, const Vector4& color, uint32_t textureIndex, BlendMode blendMode) {
+	if (spriteCount_ >= maxSprites_) {
+		return false;
+	}
+
+	// 直前と同じテクスチャ・ブレンドなら同じランに入れる
+	if (!runs_.empty() && runs_.back().textureIndex == textureIndex && runs_.back().blendMode == blendMode && runs_.back().mesh == SpriteMesh::kQuad) {
+		++runs_.back().spriteCount;
+	} else {
+		runs_.push_back({textureIndex, blendMode, spriteCount_, 1});
+	}
+
+	WriteSpriteVertices(vertices_ + static_cast<size_t>(spriteCount_) * kVertexCountPerSprite, quad, worldMatrix, color);
+	++spriteCount_;
+	return true;
+}
+
+// 変換済みの頂点をそのまま積む
+bool SpriteBatchBuilder::Add(const SpriteVertex* vertices, uint32_t spriteCount, uint32_t textureIndex, BlendMode blendMode) {
+	if (spriteCount > maxSprites_ - spriteCount_) {
+		return false;
+	}
+	if (spriteCount == 0) {
+		return true;
+	}
+	if (!runs_.empty() && runs_.back().textureIndex == textureIndex && runs_.back().blendMode == blendMode && runs_.back().mesh == SpriteMesh::kQuad) {
+		runs_.back().spriteCount += spriteCount;
+	} else {
+		runs_.push_back({textureIndex, blendMode, spriteCount_, spriteCount});
+	}
+	std::memcpy(vertices_ + static_cast<size_t>(spriteCount_) * kVertexCountPerSprite, vertices, sizeof(SpriteVertex) * kVertexCountPerSprite * spriteCount);
+	spriteCount_ += spriteCount;
+	return true;
+}
+
+// 9分割スプライトを積む
+bool SpriteBatchBuilder::Add(const NineSliceSprite& sprite) {
+	static_assert(NineSliceSprite::kVertexCount == kSpriteCountPerNineSlice * kVertexCountPerSprite);
+	if (kSpriteCountPerNineSlice > maxSprites_ - spriteCount_) {
+		return false;
+	}
+	uint32_t textureIndex = sprite.GetTextureIndex();
+	BlendMode blendMode = sprite.GetBlendMode();
+	if (!runs_.empty() && runs_.back().textureIndex == textureIndex && runs_.back().blendMode == blendMode && runs_.back().mesh == SpriteMesh::kNineSlice) {
+		++runs_.back().spriteCount;
+	} else {
+		runs_.push_back({textureIndex, blendMode, spriteCount_, 1, SpriteMesh::kNineSlice});
+	}
+	std::memcpy(vertices_ + static_cast<size_t>(spriteCount_) * kVertexCountPerSprite, sprite.GetVertices(), sizeof(SpriteVertex) * NineSliceSprite::kVertexCount);
+	spriteCount_ += kSpriteCountPerNineSlice;
+	return true;
+}
+
+bool SpriteBatchBuilder::Add(const SpriteSystem& system, const uint32_t* indices, size_t count, WorkerPool* workerPool) {
+	if (count > maxSprites_ - spriteCount_) {
+		return false;
+	}
+	const SpriteQuad* quads = system.GetQuads();
+	const Matrix4x4* worldMatrices = system.GetWorldMatrices();
+	const Vector4* colors = system.GetColors();
+	const uint32_t* textureIndices = system.GetTextureIndices();
+	const BlendMode* blendModes = system.GetBlendModes();
+
+	// ランは前から順に決まるので先にこのスレッドでまとめる(テクスチャとブレンドを見るだけなので軽い)
+	uint32_t firstSprite = spriteCount_;
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t index = indices[i];
+		uint32_t textureIndex = textureIndices[index];
+		BlendMode blendMode = blendModes[index];
+		if (!runs_.empty() && runs_.back().textureIndex == textureIndex && runs_.back().blendMode == blendMode && runs_.back().mesh == SpriteMesh::kQuad) {
+			++runs_.back().spriteCount;
+		} else {
+			runs_.push_back({textureIndex, blendMode, firstSprite + static_cast<uint32_t>(i), 1});
+		}
+	}
+
+	// 頂点はi枚目をfirstSprite + iの位置に書くので、範囲ごとに書き込み先が重ならない
+	auto writeRange = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			uint32_t index = indices[i];
+			WriteSpriteVertices(vertices_ + (firstSprite + i) * kVertexCountPerSprite, quads[index], worldMatrices[index], colors[index]);
+		}
+	};
+	if (workerPool) {
+		workerPool->ParallelFor(count, kParallelChunkSize, writeRange);
+	} else {
+		writeRange(0, count);
+	}
+	spriteCount_ += static_cast<uint32_t>(count);
+	return true;
+}
+
+// 四角形spriteCount枚分のインデックスを書き込む
+void SpriteBatchBuilder::WriteQuadIndices(uint32_t* indices, uint32_t spriteCount) {
+	for (uint32_t i = 0; i < spriteCount; ++i) {
+		uint32_t base = i * kVertexCountPerSprite;
+		uint32_t* out = indices + static_cast<size_t>(i) * kIndexCountPerSprite;
+		out[0] = base + 0;
+		out[1] = base + 1;
+		out[2] = base + 2;
+		out[3] = base + 1;
+		out[4] = base + 3;
+		out[5] = base + 2;
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "BlendMode.h"
+#include "base/MathTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 前方宣言
+class NineSliceSprite;
+class SpriteSystem;
+class WorkerPool;
+
+// SpriteBatchのうち、DirectXに依存しない部分
+// 頂点を変換済みの状態で1つの配列に詰め、同じテクスチャ・ブレンドが続く範囲(ラン)をまとめる
+// (ベンチマークからも使えるように分けてある)
+
+// SpriteBatchの頂点(World変換済み)
+struct SpriteVertex {
+	Vector4 position;
+	Vector2 texcoord;
+	Vector4 color;
+};
+
+// 1枚分の四角形(ローカル座標とUV)
+// 頂点の順番はSpriteと同じ 左下・左上・右下・右上
+struct SpriteQuad {
+	Vector2 positions[4];
+	Vector2 texcoords[4];
+};
+
+// ランのメッシュの形(形ごとにインデックスバッファの別の範囲を使う)
+enum class SpriteMesh : uint8_t {
+	// 四角形(4頂点・6インデックス)
+	kQuad,
+	// 9分割スプライト(16頂点・54インデックス)
+	kNineSlice,
+};
+
+class SpriteBatchBuilder {
+public:
+	// 同じテクスチャ・ブレンド・メッシュの形が続く範囲(1回のDrawCallで描ける)
+	// firstSpriteは頂点4個を1枚と数えた位置。spriteCountはkNineSliceなら9分割スプライトの数
+	struct Run {
+		uint32_t textureIndex;
+		BlendMode blendMode;
+		uint32_t firstSprite;
+		uint32_t spriteCount;
+		SpriteMesh mesh = SpriteMesh::kQuad;
+	};
+
+	static const uint32_t kVertexCountPerSprite = 4;
+	static const uint32_t kIndexCountPerSprite = 6;
+	// 9分割スプライト1つが使う枚数(16頂点 = 4枚分)
+	static const uint32_t kSpriteCountPerNineSlice = 4;
+
+	// 書き込み先の設定(maxSprites * 4頂点分の領域が必要)
+	// GPUのアップロードヒープを直接渡せるように、書き込むだけで読み戻さない
+	void SetDestination(SpriteVertex* vertices, uint32_t maxSprites);
+
+	// 積んだスプライトを空にする
+	void Clear();
+
+	// スプライトを1枚積む(いっぱいならfalse)
+	bool Add(const SpriteQuad& quad, const Matrix4x4& worldMatrix, const Vector4& color, uint32_t textureIndex, BlendMode blendMode);
+	// SpriteSystemのindicesの位置のスプライトをまとめて積む(入りきらなければ何も積まずにfalse)
+	// workerPoolがあれば頂点をワーカースレッドで分けて書き込む
+	// 1枚ごとに書き込む位置が決まっているので、並びは1スレッドで積んだときと同じ
+	bool Add(const SpriteSystem& system, const uint32_t* indices, size_t count, WorkerPool* workerPool = nullptr);
+	// 変換済みの頂点をspriteCount枚分そのままコピーして積む(文字列など。入りきらなければ何も積まずにfalse)
+	bool Add(const SpriteVertex* vertices, uint32_t spriteCount, uint32_t textureIndex, BlendMode blendMode);
+	// Update後の9分割スプライトを積む(4枚分の場所を使う。いっぱいならfalse)
+	bool Add(const NineSliceSprite& sprite);
+
+	// ランのgetter
+	const std::vector<Run>& GetRuns() const { return runs_; }
+	// 積んだスプライト数(9分割スプライトは4枚と数える)
+	uint32_t GetSpriteCount() const { return spriteCount_; }
+	// 積める最大数
+	uint32_t GetMaxSprites() const { return maxSprites_; }
+
+	// 四角形spriteCount枚分のインデックスを書き込む(初期化時に1回だけ)
+	static void WriteQuadIndices(uint32_t* indices, uint32_t spriteCount);
+
+private:
+	// ワーカースレッドに分けるときの1回分の枚数
+	static constexpr size_t kParallelChunkSize = 2048;
+
+	SpriteVertex* vertices_ = nullptr;
+	uint32_t maxSprites_ = 0;
+	uint32_t spriteCount_ = 0;
+	std::vector<Run> runs_;
+};
@@ -0,0 +1,127 @@
+#include "SpriteBroadphase.h"
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <emmintrin.h>
+
+namespace {
+
+// 4つずつ比べる
+const size_t kLaneCount = 4;
+
+} // namespace
+
+// 範囲を読み直し、重なっている組を求める
+void SpriteBroadphase::Update(const SpriteSystem& system, WorkerPool* workerPool) {
+	uint32_t count = system.GetCount();
+	rects_.resize(count);
+	if (workerPool) {
+		system.ComputeBoundingRects(rects_.data(), *workerPool);
+	} else {
+		system.ComputeBoundingRects(rects_.data());
+	}
+
+	// 並びを保ったまま範囲を書き換え、削除されたスプライトを詰める
+	size_t aliveCount = 0;
+	for (const Body& body : bodies_) {
+		if (!system.IsAlive(body.handle)) {
+			slotGenerations_[body.handle.index] = 0;
+			continue;
+		}
+		const Rect2D& rect = rects_[system.IndexOf(body.handle)];
+		bodies_[aliveCount++] = {rect.left, rect.right, rect.top, rect.bottom, body.handle};
+	}
+	bodies_.resize(aliveCount);
+
+	// 入っていないスプライトを集める(スロットを使い回したものはgenerationが合わない)
+	addedBodies_.clear();
+	for (uint32_t index = 0; index < count; ++index) {
+		SpriteHandle handle = system.GetHandle(index);
+		if (handle.index >= slotGenerations_.size()) {
+			slotGenerations_.resize(handle.index + 1, 0);
+		}
+		if (slotGenerations_[handle.index] != handle.generation + 1) {
+			slotGenerations_[handle.index] = handle.generation + 1;
+			const Rect2D& rect = rects_[index];
+			addedBodies_.push_back({rect.left, rect.right, rect.top, rect.bottom, handle});
+		}
+	}
+
+	// 動いたスプライトを挿入ソートで並べ直してから、新しいスプライトを並べて差し込む
+	// (新しいものを後ろに足して挿入ソートすると、最初のフレームなどでまとめて増えたときに遅い)
+	SortBodies();
+	if (!addedBodies_.empty()) {
+		auto byLeft = [](const Body& a, const Body& b) { return a.left < b.left; };
+		std::sort(addedBodies_.begin(), addedBodies_.end(), byLeft);
+		size_t middle = bodies_.size();
+		bodies_.insert(bodies_.end(), addedBodies_.begin(), addedBodies_.end());
+		std::inplace_merge(bodies_.begin(), bodies_.begin() + middle, bodies_.end(), byLeft);
+	}
+
+	FindPairs();
+}
+
+// 左端の順に並べ直す
+void SpriteBroadphase::SortBodies() {
+	sortMoveCount_ = 0;
+	Body* bodies = bodies_.data();
+	size_t count = bodies_.size();
+	for (size_t i = 1; i < count; ++i) {
+		// 前のフレームからほとんど動かなければ、ここで比べるだけで終わる
+		if (bodies[i - 1].left <= bodies[i].left) {
+			continue;
+		}
+		Body body = bodies[i];
+		size_t j = i;
+		do {
+			bodies[j] = bodies[j - 1];
+			--j;
+		} while (j > 0 && bodies[j - 1].left > body.left);
+		bodies[j] = body;
+		sortMoveCount_ += i - j;
+	}
+}
+
+// 重なっている組を詰める
+void SpriteBroadphase::FindPairs() {
+	pairs_.clear();
+	const Body* bodies = bodies_.data();
+	size_t count = bodies_.size();
+
+	// 比べる側の範囲は4つずつ読めるように項目ごとの配列に並べる
+	// 後ろには左端が必ず右にはみ出す値を置いておき、端数を気にせず4つずつ読む
+	lefts_.resize(count + kLaneCount);
+	tops_.resize(count + kLaneCount);
+	bottoms_.resize(count + kLaneCount);
+	for (size_t i = 0; i < count; ++i) {
+		lefts_[i] = bodies[i].left;
+		tops_[i] = bodies[i].top;
+		bottoms_[i] = bodies[i].bottom;
+	}
+	std::fill(lefts_.begin() + count, lefts_.end(), FLT_MAX);
+	std::fill(tops_.begin() + count, tops_.end(), FLT_MAX);
+	std::fill(bottoms_.begin() + count, bottoms_.end(), -FLT_MAX);
+
+	for (size_t i = 0; i < count; ++i) {
+		const Body& body = bodies[i];
+		__m128 right = _mm_set1_ps(body.right);
+		__m128 top = _mm_set1_ps(body.top);
+		__m128 bottom = _mm_set1_ps(body.bottom);
+		// 左端の順に並んでいるので、左端がbodyの右端を越えたら後ろは全て重ならない
+		for (size_t j = i + 1;; j += kLaneCount) {
+			int xMask = _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(&lefts_[j]), right));
+			if (xMask == 0) {
+				break;
+			}
+			__m128 yOverlap = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&tops_[j]), bottom), _mm_cmpge_ps(_mm_loadu_ps(&bottoms_[j]), top));
+			int mask = xMask & _mm_movemask_ps(yOverlap);
+			while (mask != 0) {
+				pairs_.push_back({body.handle, bodies[j + std::countr_zero(static_cast<unsigned>(mask))].handle});
+				mask &= mask - 1;
+			}
+			if (xMask != (1 << kLaneCount) - 1) {
+				break;
+			}
+		}
+	}
+}
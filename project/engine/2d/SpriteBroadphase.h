@@ -0,0 +1,63 @@
+#pragma once
+#include "SpriteSystem.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 前方宣言
+class WorkerPool;
+
+// 範囲が重なっている2つのスプライト(当たり判定の候補)
+struct SpritePair {
+	SpriteHandle a;
+	SpriteHandle b;
+};
+
+// スプライトの当たり判定の候補探し(DirectXに依存しない部分)
+// 範囲はSpriteSystem::ComputeBoundingRects(座標・拡縮・アンカーポイント・回転・親ノードから求めた範囲)を使う
+// スプライトを範囲の左端(x)の順に並べておき、左から順に右端までのスプライトとだけ上下の範囲を比べる(sweep and prune。4つずつSSEで比べる)
+// 前のフレームの並びを残して挿入ソートで並べ直すので、少しずつ動くスプライトならほぼ1回読むだけで並ぶ
+// 重なっている組は毎フレーム1つの配列に詰め直す(配列は使い回すので、一番多かったフレームの後はメモリを確保しない)
+class SpriteBroadphase {
+public:
+	// systemの全スプライトの範囲を読み直し、重なっている組を求める
+	// 作成・削除されたスプライトはここで足し引きする。workerPoolがあれば範囲をワーカースレッドで分けて求める
+	void Update(const SpriteSystem& system, WorkerPool* workerPool = nullptr);
+
+	// 直前のUpdateで重なっていた組(縁が接しているものも含む。同じ組は1回だけ)
+	const std::vector<SpritePair>& GetPairs() const { return pairs_; }
+	// 入っているスプライト数
+	uint32_t GetCount() const { return static_cast<uint32_t>(bodies_.size()); }
+	// 直前のUpdateの挿入ソートで動かした回数(フレーム間でほとんど動かなければスプライト数よりずっと少ない)
+	uint64_t GetSortMoveCount() const { return sortMoveCount_; }
+
+private:
+	// 並べておく1つ分(比べるときに続けて読めるように範囲も一緒に並べる)
+	struct Body {
+		float left;
+		float right;
+		float top;
+		float bottom;
+		SpriteHandle handle;
+	};
+
+	// 左端の順に並べ直す(挿入ソート)
+	void SortBodies();
+	// 重なっている組を詰める
+	void FindPairs();
+
+	// 左端の順に並んだスプライト
+	std::vector<Body> bodies_;
+	// 新しく入ったスプライト(並べてからまとめて差し込む)
+	std::vector<Body> addedBodies_;
+	// 比べるときに4つずつ読む範囲(bodies_と同じ並び)
+	std::vector<float> lefts_;
+	std::vector<float> tops_;
+	std::vector<float> bottoms_;
+	// SpriteSystemの配列の位置ごとの範囲(作業用)
+	std::vector<Rect2D> rects_;
+	// スロットごとの入っているスプライトのgeneration + 1(入っていなければ0)
+	std::vector<uint32_t> slotGenerations_;
+	std::vector<SpritePair> pairs_;
+	uint64_t sortMoveCount_ = 0;
+};
@@ -1,8 +1,16 @@
 #include "SpriteCommon.h"  
 
+#include "Camera2D.h"
+#include "base/TextureManager.h"
+#include "base/Math.h"
 #include <base/Logger.h>
 using namespace Logger;
 
+namespace {
+// スプライト用の平行投影行列(画面サイズ固定なのでコンパイル時に計算する)
+constexpr Matrix4x4 kSpriteProjectionMatrix = MakeOrthographicMatrix(0.0f, 0.0f, float(WindowsAPI::kClientWidth), float(WindowsAPI::kClientHeight), 0.0f, 100.0f);
+} // namespace
+
 
 // 初期化  
 void SpriteCommon::Initialize(DirectXCommon* dXCommon) {  
@@ -13,6 +21,12 @@ void SpriteCommon::Initialize(DirectXCommon* dXCommon) {
 	InitializeRootSignature();
 	// グラフィックスパイプラインの生成
 	InitializeGraphicsPipeline();
+	// インスタンシング描画用
+	InitializeInstancedRootSignature();
+	InitializeInstancedGraphicsPipelines();
+	// まとめて描画する用
+	InitializeBatchRootSignature();
+	InitializeBatchGraphicsPipelines();
  
 }
 
@@ -30,6 +44,100 @@ void SpriteCommon::SetCommonPipelineState() {
 }
 
 
+// インスタンシング描画用の共通描画設定
+void SpriteCommon::SetInstancedPipelineState(BlendMode blendMode) {
+	assert(instancedRootSignature_ != nullptr);
+
+	ID3D12GraphicsCommandList* commandList = dXCommon_->GetCommandList();
+	commandList->SetGraphicsRootSignature(instancedRootSignature_.Get());
+	commandList->SetPipelineState(instancedPipelineStates_[static_cast<size_t>(blendMode)].Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+// まとめて描画する用の共通描画設定
+void SpriteCommon::SetBatchPipelineState(BlendMode blendMode) {
+	assert(batchRootSignature_ != nullptr);
+
+	ID3D12GraphicsCommandList* commandList = dXCommon_->GetCommandList();
+	commandList->SetGraphicsRootSignature(batchRootSignature_.Get());
+	commandList->SetPipelineState(batchPipelineStates_[static_cast<size_t>(blendMode)].Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+// ブレンドモードに合わせたBlendState
+D3D12_BLEND_DESC SpriteCommon::MakeBlendDesc(BlendMode blendMode) {
+	D3D12_BLEND_DESC blendDesc{};
+	D3D12_RENDER_TARGET_BLEND_DESC& renderTarget = blendDesc.RenderTarget[0];
+	// 全ての色要素を書き込む
+	renderTarget.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+	switch (blendMode) {
+	case BlendMode::kNormal:
+		// Src * SrcA + Dest * (1 - SrcA)
+		renderTarget.BlendEnable = true;
+		renderTarget.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		renderTarget.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+		renderTarget.BlendOp = D3D12_BLEND_OP_ADD;
+		break;
+	case BlendMode::kAdd:
+		// Src * SrcA + Dest
+		renderTarget.BlendEnable = true;
+		renderTarget.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		renderTarget.DestBlend = D3D12_BLEND_ONE;
+		renderTarget.BlendOp = D3D12_BLEND_OP_ADD;
+		break;
+	default:
+		break;
+	}
+	// アルファ値はそのまま書き込む
+	renderTarget.SrcBlendAlpha = D3D12_BLEND_ONE;
+	renderTarget.DestBlendAlpha = D3D12_BLEND_ZERO;
+	renderTarget.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	return blendDesc;
+}
+
+// ブレンドモードに合わせたDepthStencilState
+D3D12_DEPTH_STENCIL_DESC SpriteCommon::MakeDepthStencilDesc(BlendMode blendMode) {
+	D3D12_DEPTH_STENCIL_DESC depthStencilDesc{};
+	depthStencilDesc.DepthEnable = true;
+	// 半透明は奥から順に重ねるので、奥行きを書き込むと後から描く奥のものが消える(比べるだけにする)
+	depthStencilDesc.DepthWriteMask = blendMode == BlendMode::kNone ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
+	depthStencilDesc.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+	return depthStencilDesc;
+}
+
+// スプライト用のViewProjectionMatrix
+const Matrix4x4& SpriteCommon::GetViewProjectionMatrix() const {
+	// ViewMatrixは単位行列なので、カメラがなければ平行投影行列をそのまま使う
+	return defaultCamera_ ? defaultCamera_->GetViewProjectionMatrix() : kSpriteProjectionMatrix;
+}
+
+// ViewProjectionMatrixが変わるたびに増える番号
+uint32_t SpriteCommon::GetViewProjectionGeneration() const { return defaultCamera_ ? defaultCamera_->GetViewProjectionGeneration() : 0; }
+
+// 読み込み済みのテクスチャでスプライトを作る
+SpriteHandle SpriteCommon::CreateSprite(const std::string& textureFilePath) { return spriteSystem_.Create(FindTextureRegion(textureFilePath)); }
+
+// 読み込み済みのテクスチャの画像の範囲
+SpriteTextureRegion SpriteCommon::FindTextureRegion(const std::string& textureFilePath) const {
+	// アトラスに入っていれば、ページの中の画像の範囲を使う
+	uint32_t textureIndex = 0;
+	AtlasRegion region;
+	if (TextureManager::GetInstance()->FindAtlasRegion(textureFilePath, textureIndex, region)) {
+		const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetadata(textureIndex);
+		return {
+		    textureIndex,
+		    {static_cast<float>(metadata.width), static_cast<float>(metadata.height)},
+		    {static_cast<float>(region.x),       static_cast<float>(region.y)        },
+		    {static_cast<float>(region.width),   static_cast<float>(region.height)   },
+		};
+	}
+
+	textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
+	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetadata(textureIndex);
+	Vector2 textureSize = {static_cast<float>(metadata.width), static_cast<float>(metadata.height)};
+	return {textureIndex, textureSize, {0.0f, 0.0f}, textureSize};
+}
+
 // ルートシグネイチャの作成
 void SpriteCommon::InitializeRootSignature() {
 	D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
@@ -208,4 +316,216 @@ void SpriteCommon::InitializeGraphicsPipeline() {
 	HRESULT hr = dXCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&pipelineState_));
 	assert(SUCCEEDED(hr));
 
-}
\ No newline at end of file
+}
+
+// インスタンシング描画用のルートシグネイチャの作成
+void SpriteCommon::InitializeInstancedRootSignature() {
+	D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
+	// 頂点はインスタンスのデータから作るのでInputLayoutは使わない
+	descriptionRootSignature.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+	// TextureManagerのテクスチャ全部(テクスチャ番号がそのまま配列の番号になる)
+	D3D12_DESCRIPTOR_RANGE descriptorRange[1] = {};
+	descriptorRange[0].BaseShaderRegister = 0;
+	descriptorRange[0].NumDescriptors = TextureManager::GetMaxTextureCount();
+	descriptorRange[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	descriptorRange[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+	D3D12_ROOT_PARAMETER rootParameters[4] = {};
+	// ViewProjection行列(VertexShaderのb0)
+	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	rootParameters[0].Descriptor.ShaderRegister = 0;
+	// 範囲の先頭のインスタンス番号(VertexShaderのb1)
+	rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	rootParameters[1].Constants.ShaderRegister = 1;
+	rootParameters[1].Constants.Num32BitValues = 1;
+	// インスタンスのStructuredBuffer(VertexShaderのt0, space1)。デスクリプタヒープを使わずに直接渡す
+	rootParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	rootParameters[2].Descriptor.ShaderRegister = 0;
+	rootParameters[2].Descriptor.RegisterSpace = 1;
+	// テクスチャ(PixelShaderのt0~)
+	rootParameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	rootParameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootParameters[3].DescriptorTable.pDescriptorRanges = descriptorRange;
+	rootParameters[3].DescriptorTable.NumDescriptorRanges = _countof(descriptorRange);
+
+	// Samplerの設定(通常の描画と同じ)
+	D3D12_STATIC_SAMPLER_DESC staticSamplers[1] = {};
+	staticSamplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+	staticSamplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+	staticSamplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+	staticSamplers[0].ShaderRegister = 0;
+	staticSamplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	descriptionRootSignature.pStaticSamplers = staticSamplers;
+	descriptionRootSignature.NumStaticSamplers = _countof(staticSamplers);
+
+	descriptionRootSignature.pParameters = rootParameters;
+	descriptionRootSignature.NumParameters = _countof(rootParameters);
+
+	// シリアライズしてバイナリにする
+	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob = nullptr;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
+	HRESULT hr = D3D12SerializeRootSignature(&descriptionRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
+	if (FAILED(hr)) {
+		if (errorBlob) {
+			Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
+		}
+		assert(false);
+	}
+
+	// バイナリを元に生成
+	hr = dXCommon_->GetDevice()->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&instancedRootSignature_));
+	assert(SUCCEEDED(hr));
+}
+
+// インスタンシング描画用のグラフィックパイプラインの生成
+void SpriteCommon::InitializeInstancedGraphicsPipelines() {
+	assert(instancedRootSignature_ != nullptr);
+
+	// 両面表示
+	D3D12_RASTERIZER_DESC rasterizerDesc{};
+	rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+	rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
+
+	// Shaderをコンパイルする
+	Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dXCommon_->CompileShader(L"resources/shaders/SpriteInstanced.VS.hlsl", L"vs_6_0");
+	assert(vertexShaderBlob != nullptr);
+	Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob = dXCommon_->CompileShader(L"resources/shaders/SpriteInstanced.PS.hlsl", L"ps_6_0");
+	assert(pixelShaderBlob != nullptr);
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc{};
+	graphicsPipelineStateDesc.pRootSignature = instancedRootSignature_.Get();
+	// InputLayoutはなし
+	graphicsPipelineStateDesc.InputLayout = {nullptr, 0};
+	graphicsPipelineStateDesc.VS = {vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize()};
+	graphicsPipelineStateDesc.PS = {pixelShaderBlob->GetBufferPointer(), pixelShaderBlob->GetBufferSize()};
+	graphicsPipelineStateDesc.RasterizerState = rasterizerDesc;
+	graphicsPipelineStateDesc.NumRenderTargets = 1;
+	graphicsPipelineStateDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+	graphicsPipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	graphicsPipelineStateDesc.SampleDesc.Count = 1;
+	graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+	graphicsPipelineStateDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+
+	for (size_t i = 0; i < static_cast<size_t>(BlendMode::kCount); ++i) {
+		graphicsPipelineStateDesc.BlendState = MakeBlendDesc(static_cast<BlendMode>(i));
+		graphicsPipelineStateDesc.DepthStencilState = MakeDepthStencilDesc(static_cast<BlendMode>(i));
+		HRESULT hr = dXCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&instancedPipelineStates_[i]));
+		assert(SUCCEEDED(hr));
+	}
+}
+
+// まとめて描画する用のルートシグネイチャの作成
+void SpriteCommon::InitializeBatchRootSignature() {
+	D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
+	descriptionRootSignature.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+	// テクスチャ1枚
+	D3D12_DESCRIPTOR_RANGE descriptorRange[1] = {};
+	descriptorRange[0].BaseShaderRegister = 0;
+	descriptorRange[0].NumDescriptors = 1;
+	descriptorRange[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	descriptorRange[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+	D3D12_ROOT_PARAMETER rootParameters[2] = {};
+	// ViewProjection行列(VertexShaderのb0)
+	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	rootParameters[0].Descriptor.ShaderRegister = 0;
+	// テクスチャ(PixelShaderのt0)
+	rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootParameters[1].DescriptorTable.pDescriptorRanges = descriptorRange;
+	rootParameters[1].DescriptorTable.NumDescriptorRanges = _countof(descriptorRange);
+
+	// Samplerの設定(通常の描画と同じ)
+	D3D12_STATIC_SAMPLER_DESC staticSamplers[1] = {};
+	staticSamplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+	staticSamplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+	staticSamplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+	staticSamplers[0].ShaderRegister = 0;
+	staticSamplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	descriptionRootSignature.pStaticSamplers = staticSamplers;
+	descriptionRootSignature.NumStaticSamplers = _countof(staticSamplers);
+
+	descriptionRootSignature.pParameters = rootParameters;
+	descriptionRootSignature.NumParameters = _countof(rootParameters);
+
+	// シリアライズしてバイナリにする
+	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob = nullptr;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
+	HRESULT hr = D3D12SerializeRootSignature(&descriptionRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
+	if (FAILED(hr)) {
+		if (errorBlob) {
+			Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
+		}
+		assert(false);
+	}
+
+	// バイナリを元に生成
+	hr = dXCommon_->GetDevice()->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&batchRootSignature_));
+	assert(SUCCEEDED(hr));
+}
+
+// まとめて描画する用のグラフィックパイプラインの生成(ブレンドモードごと)
+void SpriteCommon::InitializeBatchGraphicsPipelines() {
+	assert(batchRootSignature_ != nullptr);
+
+	// InputLayout(SpriteVertexと同じ並び)
+	D3D12_INPUT_ELEMENT_DESC inputElementDescs[3] = {};
+	inputElementDescs[0].SemanticName = "POSITION";
+	inputElementDescs[0].SemanticIndex = 0;
+	inputElementDescs[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	inputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	inputElementDescs[1].SemanticName = "TEXCOORD";
+	inputElementDescs[1].SemanticIndex = 0;
+	inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	inputElementDescs[2].SemanticName = "COLOR";
+	inputElementDescs[2].SemanticIndex = 0;
+	inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc{};
+	inputLayoutDesc.pInputElementDescs = inputElementDescs;
+	inputLayoutDesc.NumElements = _countof(inputElementDescs);
+
+	// 両面表示
+	D3D12_RASTERIZER_DESC rasterizerDesc{};
+	rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+	rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
+
+	// Shaderをコンパイルする
+	Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dXCommon_->CompileShader(L"resources/shaders/Sprite.VS.hlsl", L"vs_6_0");
+	assert(vertexShaderBlob != nullptr);
+	Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob = dXCommon_->CompileShader(L"resources/shaders/Sprite.PS.hlsl", L"ps_6_0");
+	assert(pixelShaderBlob != nullptr);
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc{};
+	graphicsPipelineStateDesc.pRootSignature = batchRootSignature_.Get();
+	graphicsPipelineStateDesc.InputLayout = inputLayoutDesc;
+	graphicsPipelineStateDesc.VS = {vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize()};
+	graphicsPipelineStateDesc.PS = {pixelShaderBlob->GetBufferPointer(), pixelShaderBlob->GetBufferSize()};
+	graphicsPipelineStateDesc.RasterizerState = rasterizerDesc;
+	graphicsPipelineStateDesc.NumRenderTargets = 1;
+	graphicsPipelineStateDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+	graphicsPipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	graphicsPipelineStateDesc.SampleDesc.Count = 1;
+	graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+	graphicsPipelineStateDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+
+	for (size_t i = 0; i < static_cast<size_t>(BlendMode::kCount); ++i) {
+		graphicsPipelineStateDesc.BlendState = MakeBlendDesc(static_cast<BlendMode>(i));
+		graphicsPipelineStateDesc.DepthStencilState = MakeDepthStencilDesc(static_cast<BlendMode>(i));
+		HRESULT hr = dXCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&batchPipelineStates_[i]));
+		assert(SUCCEEDED(hr));
+	}
+}
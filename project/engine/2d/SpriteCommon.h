@@ -2,6 +2,12 @@
 #include <wrl.h>  
 #include <d3d12.h>  
 #include "base/DirectXCommon.h"
+#include "base/MathTypes.h"
+#include "BlendMode.h"
+#include "SpriteSystem.h"
+#include <string>
+
+class Camera2D;
 
 class SpriteCommon {  
 public:  
@@ -11,16 +17,62 @@ public:
    // 共通描画設定  
    void SetCommonPipelineState();  
 
+   // インスタンシング描画用の共通描画設定
+   // ルートパラメータ 0:ViewProjection(CBV) 1:範囲の先頭(定数) 2:インスタンス(SRV) 3:全テクスチャ(DescriptorTable)
+   void SetInstancedPipelineState(BlendMode blendMode);
+
+   // まとめて描画する(SpriteBatch・TilemapRenderer)用の共通描画設定
+   // 頂点はSpriteVertex(World変換済み)。ルートパラメータ 0:ViewProjection(CBV) 1:テクスチャ(DescriptorTable)
+   void SetBatchPipelineState(BlendMode blendMode);
+
+   // ブレンドモードに合わせたBlendState
+   static D3D12_BLEND_DESC MakeBlendDesc(BlendMode blendMode);
+   // ブレンドモードに合わせたDepthStencilState(半透明は奥行きを書き込まない)
+   static D3D12_DEPTH_STENCIL_DESC MakeDepthStencilDesc(BlendMode blendMode);
+
    // DirectXCommonのゲッター  
    DirectXCommon* GetDXCommon() const { return dXCommon_; }  
 
+   // デフォルトカメラのsetter
+   void SetDefaultCamera(Camera2D* camera) { defaultCamera_ = camera; }
+   // デフォルトカメラのgetter
+   Camera2D* GetDefaultCamera() const { return defaultCamera_; }
+
+   // スプライト用のViewProjectionMatrix
+   // カメラがあればキャッシュ済みの行列、なければ画面サイズの平行投影行列
+   const Matrix4x4& GetViewProjectionMatrix() const;
+   // ViewProjectionMatrixが変わるたびに増える番号(カメラがなければ0のまま)
+   uint32_t GetViewProjectionGeneration() const;
+
+   // スプライトの状態をまとめて持つシステムのgetter
+   SpriteSystem* GetSpriteSystem() { return &spriteSystem_; }
+   // 読み込み済みのテクスチャでスプライトを作る(拡縮と切り出しサイズは画像に合わせる)
+   // アトラスに入っている画像なら、アトラスのページの中の範囲を使う
+   SpriteHandle CreateSprite(const std::string& textureFilePath);
+   // 読み込み済みのテクスチャの画像の範囲(アトラスに入っていればページの中の範囲)
+   SpriteTextureRegion FindTextureRegion(const std::string& textureFilePath) const;
+
 private:  
    // ルートシグネイチャの作成  
    void InitializeRootSignature();  
    // グラフィックパイプラインの生成  
    void InitializeGraphicsPipeline();  
+   // インスタンシング描画用のルートシグネイチャの作成
+   void InitializeInstancedRootSignature();
+   // インスタンシング描画用のグラフィックパイプラインの生成(ブレンドモードごと)
+   void InitializeInstancedGraphicsPipelines();
+   // まとめて描画する用のルートシグネイチャの作成
+   void InitializeBatchRootSignature();
+   // まとめて描画する用のグラフィックパイプラインの生成(ブレンドモードごと)
+   void InitializeBatchGraphicsPipelines();
 
    DirectXCommon* dXCommon_;  
+   Camera2D* defaultCamera_ = nullptr;
+   SpriteSystem spriteSystem_;
    Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_; 
    Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState_;
+   Microsoft::WRL::ComPtr<ID3D12RootSignature> instancedRootSignature_;
+   Microsoft::WRL::ComPtr<ID3D12PipelineState> instancedPipelineStates_[static_cast<size_t>(BlendMode::kCount)];
+   Microsoft::WRL::ComPtr<ID3D12RootSignature> batchRootSignature_;
+   Microsoft::WRL::ComPtr<ID3D12PipelineState> batchPipelineStates_[static_cast<size_t>(BlendMode::kCount)];
 };
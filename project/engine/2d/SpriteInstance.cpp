@@ -0,0 +1,98 @@
+#include "SpriteInstance.h"
+#include "SpriteSystem.h"
+#include "base/WorkerPool.h"
+
+namespace {
+
+// ローカル座標(z = 0)をWorld行列で変換する
+inline Vector3 TransformCorner(const Vector2& p, const Matrix4x4& m) {
+	return {
+	    p.x * m.m[0][0] + p.y * m.m[1][0] + m.m[3][0],
+	    p.x * m.m[0][1] + p.y * m.m[1][1] + m.m[3][1],
+	    p.x * m.m[0][2] + p.y * m.m[1][2] + m.m[3][2],
+	};
+}
+
+} // namespace
+
+// Spriteの四角形とWorld行列から1枚分のデータを作る
+SpriteInstance MakeSpriteInstance(const SpriteQuad& quad, const Matrix4x4& worldMatrix, const Vector4& color, uint32_t textureIndex) {
+	// 頂点の順番は 左下・左上・右下・右上
+	Vector3 leftTop = TransformCorner(quad.positions[1], worldMatrix);
+	Vector3 rightTop = TransformCorner(quad.positions[3], worldMatrix);
+	Vector3 leftBottom = TransformCorner(quad.positions[0], worldMatrix);
+
+	SpriteInstance instance;
+	instance.axes = {rightTop.x - leftTop.x, rightTop.y - leftTop.y, leftBottom.x - leftTop.x, leftBottom.y - leftTop.y};
+	instance.translate = {leftTop.x, leftTop.y};
+	instance.depth = leftTop.z;
+	instance.textureIndex = textureIndex;
+	instance.uvRect = {quad.texcoords[1].x, quad.texcoords[1].y, quad.texcoords[2].x, quad.texcoords[2].y};
+	instance.color = color;
+	return instance;
+}
+
+// 書き込み先の設定
+void SpriteInstanceBuilder::SetDestination(SpriteInstance* instances, uint32_t maxInstances) {
+	destination_ = instances;
+	maxInstances_ = maxInstances;
+	Clear();
+}
+
+// 積んだインスタンスを空にする
+void SpriteInstanceBuilder::Clear() {
+	ranges_.clear();
+	instanceCount_ = 0;
+}
+
+// インスタンスを1つ積む
+bool SpriteInstanceBuilder::Add(const SpriteInstance& instance, BlendMode blendMode) {
+	if (instanceCount_ >= maxInstances_) {
+		return false;
+	}
+	AppendRange(blendMode, instanceCount_);
+	destination_[instanceCount_] = instance;
+	++instanceCount_;
+	return true;
+}
+
+bool SpriteInstanceBuilder::Add(const SpriteSystem& system, const uint32_t* indices, size_t count, WorkerPool* workerPool) {
+	if (count > maxInstances_ - instanceCount_) {
+		return false;
+	}
+	const SpriteQuad* quads = system.GetQuads();
+	const Matrix4x4* worldMatrices = system.GetWorldMatrices();
+	const Vector4* colors = system.GetColors();
+	const uint32_t* textureIndices = system.GetTextureIndices();
+	const BlendMode* blendModes = system.GetBlendModes();
+
+	// 範囲は前から順に決まるので先にこのスレッドでまとめる(ブレンドモードを見るだけなので軽い)
+	uint32_t firstInstance = instanceCount_;
+	for (size_t i = 0; i < count; ++i) {
+		AppendRange(blendModes[indices[i]], firstInstance + static_cast<uint32_t>(i));
+	}
+
+	// i番目はfirstInstance + iの位置に書くので、範囲ごとに書き込み先が重ならない
+	auto writeRange = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			uint32_t index = indices[i];
+			destination_[firstInstance + i] = MakeSpriteInstance(quads[index], worldMatrices[index], colors[index], textureIndices[index]);
+		}
+	};
+	if (workerPool) {
+		workerPool->ParallelFor(count, kParallelChunkSize, writeRange);
+	} else {
+		writeRange(0, count);
+	}
+	instanceCount_ += static_cast<uint32_t>(count);
+	return true;
+}
+
+// 1つ分の範囲を足す
+void SpriteInstanceBuilder::AppendRange(BlendMode blendMode, uint32_t instanceIndex) {
+	if (!ranges_.empty() && ranges_.back().blendMode == blendMode) {
+		++ranges_.back().instanceCount;
+	} else {
+		ranges_.push_back({blendMode, instanceIndex, 1});
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "BlendMode.h"
+#include "SpriteBatchBuilder.h"
+#include "base/MathTypes.h"
+#include <cstdint>
+#include <vector>
+
+// 前方宣言
+class SpriteSystem;
+class WorkerPool;
+
+// インスタンシング描画用のスプライト1枚分のデータ(DirectXに依存しない部分)
+// シェーダーではStructuredBufferとして読み、SV_InstanceIDで1枚分を取り出す
+// 頂点は単位正方形の角(0か1の組)から
+//   position = translate + corner.x * axisX + corner.y * axisY
+//   texcoord = lerp(uvRect.xy, uvRect.zw, corner)
+// で求める(左上が(0, 0)、右下が(1, 1))
+struct SpriteInstance {
+	// World変換済みの横方向(xy)と縦方向(zw)の辺
+	Vector4 axes;
+	// 左上の角のWorld座標
+	Vector2 translate;
+	float depth;
+	uint32_t textureIndex;
+	// 左上と右下のUV
+	Vector4 uvRect;
+	Vector4 color;
+};
+// シェーダー側(Sprite.Instanced.VS.hlsl)と並びを合わせる
+static_assert(sizeof(SpriteInstance) == 64);
+
+// Spriteの四角形とWorld行列から1枚分のデータを作る
+SpriteInstance MakeSpriteInstance(const SpriteQuad& quad, const Matrix4x4& worldMatrix, const Vector4& color, uint32_t textureIndex);
+
+// インスタンスを積んだ順に並べ、同じブレンドモードが続く範囲をまとめる
+// 描く順番は積んだ順のまま(SpriteRenderQueueで並べた順に積めば、レイヤーの順に描かれる)
+class SpriteInstanceBuilder {
+public:
+	// 同じブレンドモードが続く範囲(1回のDrawCallで描ける)
+	struct Range {
+		BlendMode blendMode;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+	};
+
+	// 書き込み先の設定(maxInstances個分の領域が必要)
+	// GPUのアップロードヒープを直接渡せるように、書き込むだけで読み戻さない
+	void SetDestination(SpriteInstance* instances, uint32_t maxInstances);
+
+	// 積んだインスタンスを空にする
+	void Clear();
+
+	// インスタンスを1つ積む(いっぱいならfalse)
+	bool Add(const SpriteInstance& instance, BlendMode blendMode);
+	// SpriteSystemのindicesの位置のスプライトをまとめて積む(入りきらなければ何も積まずにfalse)
+	// workerPoolがあればワーカースレッドで分けて書き込む
+	// 1つごとに書き込む位置が決まっているので、並びは1つずつAddしたときと同じ
+	bool Add(const SpriteSystem& system, const uint32_t* indices, size_t count, WorkerPool* workerPool = nullptr);
+
+	// 範囲のgetter
+	const std::vector<Range>& GetRanges() const { return ranges_; }
+	// 積んだインスタンス数
+	uint32_t GetInstanceCount() const { return instanceCount_; }
+
+private:
+	// ワーカースレッドに分けるときの1回分の数
+	static constexpr size_t kParallelChunkSize = 2048;
+
+	// 1つ分の範囲を足す(直前と同じブレンドモードなら同じ範囲に入れる)
+	void AppendRange(BlendMode blendMode, uint32_t instanceIndex);
+
+	SpriteInstance* destination_ = nullptr;
+	uint32_t maxInstances_ = 0;
+	uint32_t instanceCount_ = 0;
+	std::vector<Range> ranges_;
+};
@@ -0,0 +1,106 @@
+#include "SpriteRenderQueue.h"
+#include "SpriteSystem.h"
+#include <bit>
+#include <cassert>
+
+namespace {
+
+// floatのbitを、符号なし整数として比べたときに元の値と同じ大小になるように並べ替える
+// (正なら符号bitを立て、負なら全bitを反転する)
+uint32_t ToSortableBits(float value) {
+	uint32_t bits = std::bit_cast<uint32_t>(value);
+	return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+}
+
+} // namespace
+
+// keyを作る
+uint64_t SpriteRenderQueue::MakeKey(uint8_t layer, BlendMode blendMode, uint32_t textureIndex, float depth) {
+	static_assert(kLayerBits + kTranslucentBits + kBlendModeBits + kTextureIndexBits + kDepthBits == 64);
+	static_assert(static_cast<uint32_t>(BlendMode::kCount) <= (1u << kBlendModeBits));
+	assert(textureIndex < (1u << kTextureIndexBits));
+	// 奥ほど先に並ぶように、奥行きは大小を反転して入れる
+	uint64_t depthBits = ~ToSortableBits(depth);
+	bool translucent = blendMode != BlendMode::kNone;
+	uint64_t key = layer;
+	key = (key << kTranslucentBits) | (translucent ? 1u : 0u);
+	if (translucent) {
+		// 半透明は重なり方が変わらないように、奥行きをテクスチャより上の桁にする
+		key = (key << kDepthBits) | depthBits;
+		key = (key << kBlendModeBits) | static_cast<uint64_t>(blendMode);
+		key = (key << kTextureIndexBits) | textureIndex;
+	} else {
+		key = (key << kBlendModeBits) | static_cast<uint64_t>(blendMode);
+		key = (key << kTextureIndexBits) | textureIndex;
+		key = (key << kDepthBits) | depthBits;
+	}
+	return key;
+}
+
+// 積んだものを空にする
+void SpriteRenderQueue::Clear() {
+	keys_.clear();
+	values_.clear();
+}
+
+// SpriteSystemのスプライトを積む
+void SpriteRenderQueue::Push(const SpriteSystem& system, const uint32_t* indices, size_t count) {
+	const uint8_t* layers = system.GetLayers();
+	const BlendMode* blendModes = system.GetBlendModes();
+	const uint32_t* textureIndices = system.GetTextureIndices();
+	const float* depths = system.GetDepths();
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t index = indices[i];
+		Push(MakeKey(layers[index], blendModes[index], textureIndices[index], depths[index]), index);
+	}
+}
+
+// keyの小さい順に並べ替える
+void SpriteRenderQueue::Sort() {
+	size_t count = keys_.size();
+	sortPassCount_ = 0;
+	if (count < 2) {
+		return;
+	}
+	assert(count <= UINT32_MAX);
+	scratchKeys_.resize(count);
+	scratchValues_.resize(count);
+
+	// 全桁の数を1回読むだけで数える
+	uint32_t histograms[kPassCount][kRadixSize] = {};
+	for (uint64_t key : keys_) {
+		for (uint32_t pass = 0; pass < kPassCount; ++pass) {
+			++histograms[pass][(key >> (pass * kRadixBits)) & (kRadixSize - 1)];
+		}
+	}
+
+	// 下の桁から順に、数えた数から決めた位置へ前から順に移す(同じ値の桁の中では順番が変わらない)
+	for (uint32_t pass = 0; pass < kPassCount; ++pass) {
+		uint32_t* histogram = histograms[pass];
+		uint32_t shift = pass * kRadixBits;
+		// 全部同じ値の桁は並べ替えても変わらない(レイヤーやブレンドは同じことが多い)
+		if (histogram[(keys_[0] >> shift) & (kRadixSize - 1)] == count) {
+			continue;
+		}
+		uint32_t offset = 0;
+		for (uint32_t digit = 0; digit < kRadixSize; ++digit) {
+			uint32_t digitCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+		const uint64_t* sourceKeys = keys_.data();
+		const uint32_t* sourceValues = values_.data();
+		uint64_t* destinationKeys = scratchKeys_.data();
+		uint32_t* destinationValues = scratchValues_.data();
+		for (size_t i = 0; i < count; ++i) {
+			uint64_t key = sourceKeys[i];
+			uint32_t position = histogram[(key >> shift) & (kRadixSize - 1)]++;
+			destinationKeys[position] = key;
+			destinationValues[position] = sourceValues[i];
+		}
+		// 配列の中身は確保し直さずに入れ替える
+		keys_.swap(scratchKeys_);
+		values_.swap(scratchValues_);
+		++sortPassCount_;
+	}
+}
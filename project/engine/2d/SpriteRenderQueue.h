@@ -0,0 +1,64 @@
+#pragma once
+#include "BlendMode.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 前方宣言
+class SpriteSystem;
+
+// スプライトを描く順番に並べる(DirectXに依存しない部分)
+// 1枚ごとに64bitのkeyと値(SpriteSystemの配列の位置など)を積み、keyの小さい順に基数ソートする
+// keyは上の桁から レイヤー・半透明か で分け、同じレイヤーでは不透明(kNone)を先に、半透明を後に描く
+//  不透明: ブレンドモード・テクスチャ番号・奥行き の順。奥行きは深度テストに任せ、同じテクスチャを続けてDrawCallを減らす
+//  半透明: 奥行き・ブレンドモード・テクスチャ番号 の順。テクスチャやブレンドが違っても奥から手前に重なる
+//          (同じ奥行きのものだけが同じテクスチャ・ブレンドでまとまる)
+//
+// 基数ソートは8bitずつ下の桁から8回(全部同じ値の桁は飛ばす)。同じkey同士は積んだ順のまま(安定)
+// 作業用の配列は使い回すので、一番多く積んだフレームの後はメモリを確保しない
+class SpriteRenderQueue {
+public:
+	// keyの各項目のbit数
+	static const uint32_t kLayerBits = 8;
+	static const uint32_t kTranslucentBits = 1;
+	static const uint32_t kBlendModeBits = 2;
+	static const uint32_t kTextureIndexBits = 21;
+	static const uint32_t kDepthBits = 32;
+
+	// keyを作る(depthは大きいほど奥。半透明は同じレイヤーの中で奥から先に、不透明は同じテクスチャの中で奥から先に並ぶ)
+	static uint64_t MakeKey(uint8_t layer, BlendMode blendMode, uint32_t textureIndex, float depth);
+
+	// 積んだものを空にする(フレームの始めに呼ぶ)
+	void Clear();
+	// 1つ積む
+	void Push(uint64_t key, uint32_t value) {
+		keys_.push_back(key);
+		values_.push_back(value);
+	}
+	// SpriteSystemのindicesの位置のスプライトを積む(keyはスプライトのレイヤー・ブレンド・テクスチャ・奥行き、値は配列の位置)
+	void Push(const SpriteSystem& system, const uint32_t* indices, size_t count);
+
+	// keyの小さい順に並べ替える
+	void Sort();
+
+	// 積んだ数
+	uint32_t GetCount() const { return static_cast<uint32_t>(keys_.size()); }
+	// Sort後のkeyと値(同じ位置が同じもの)
+	const uint64_t* GetKeys() const { return keys_.data(); }
+	const uint32_t* GetValues() const { return values_.data(); }
+	// 直前のSortで並べ替えた桁数(全部同じ値の桁は飛ばすので8以下)
+	uint32_t GetSortPassCount() const { return sortPassCount_; }
+
+private:
+	// 1回で並べる桁のbit数と、桁の種類の数
+	static const uint32_t kRadixBits = 8;
+	static const uint32_t kRadixSize = 1 << kRadixBits;
+	static const uint32_t kPassCount = 64 / kRadixBits;
+
+	std::vector<uint64_t> keys_;
+	std::vector<uint32_t> values_;
+	// 並べ替えの作業用(1桁ごとにkeys_・values_と入れ替えて使う)
+	std::vector<uint64_t> scratchKeys_;
+	std::vector<uint32_t> scratchValues_;
+	uint32_t sortPassCount_ = 0;
+};
@@ -0,0 +1,511 @@
+#include "SpriteSystem.h"
+#include "base/FastTrig.h"
+#include "base/Math.h"
+#include "base/WorkerPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+// スプライトの作成
+SpriteHandle SpriteSystem::Create(uint32_t textureIndex, const Vector2& textureSize) { return Create({textureIndex, textureSize, {0.0f, 0.0f}, textureSize}); }
+
+SpriteHandle SpriteSystem::Create(const SpriteTextureRegion& region) {
+	uint32_t slot;
+	if (!freeSlots_.empty()) {
+		slot = freeSlots_.back();
+		freeSlots_.pop_back();
+	} else {
+		slot = static_cast<uint32_t>(slotIndices_.size());
+		slotIndices_.push_back(kNoIndex);
+		slotGenerations_.push_back(0);
+	}
+
+	// 後ろに追加する
+	uint32_t index = static_cast<uint32_t>(handles_.size());
+	slotIndices_[slot] = index;
+	SpriteHandle handle = {slot, slotGenerations_[slot]};
+
+	positions_.push_back({0.0f, 0.0f});
+	rotations_.push_back(0.0f);
+	// 拡縮と切り出しサイズは画像に合わせる
+	sizes_.push_back(region.size);
+	anchorPoints_.push_back({0.0f, 0.0f});
+	flipFlags_.push_back(0);
+	textureLeftTops_.push_back({0.0f, 0.0f});
+	textureCutSizes_.push_back(region.size);
+	textureSizes_.push_back(region.textureSize);
+	imageOrigins_.push_back(region.origin);
+	imageSizes_.push_back(region.size);
+	colors_.push_back({1.0f, 1.0f, 1.0f, 1.0f});
+	textureIndices_.push_back(region.textureIndex);
+	blendModes_.push_back(BlendMode::kNone);
+	layers_.push_back(0);
+	depths_.push_back(0.0f);
+	parentNodes_.push_back(kInvalidSceneNode);
+	parentWorldGenerations_.push_back(0);
+	dirtyFlags_.push_back(kDirtyQuad | kDirtyWorld);
+	quads_.push_back({});
+	worldMatrices_.push_back(kIdentity4x4);
+	revisions_.push_back(0);
+	handles_.push_back(handle);
+	return handle;
+}
+
+// スプライトの削除
+void SpriteSystem::Destroy(SpriteHandle handle) {
+	// 削除済みのハンドル(2回目の削除など)は、スロットを使い回した別のスプライトを消さないように何もしない
+	uint32_t index = FindIndex(handle);
+	if (index == kNoIndex) {
+		return;
+	}
+	uint32_t last = static_cast<uint32_t>(handles_.size()) - 1;
+
+	// 最後の要素を空いた位置に移して詰める
+	if (index != last) {
+		positions_[index] = positions_[last];
+		rotations_[index] = rotations_[last];
+		sizes_[index] = sizes_[last];
+		anchorPoints_[index] = anchorPoints_[last];
+		flipFlags_[index] = flipFlags_[last];
+		textureLeftTops_[index] = textureLeftTops_[last];
+		textureCutSizes_[index] = textureCutSizes_[last];
+		textureSizes_[index] = textureSizes_[last];
+		imageOrigins_[index] = imageOrigins_[last];
+		imageSizes_[index] = imageSizes_[last];
+		colors_[index] = colors_[last];
+		textureIndices_[index] = textureIndices_[last];
+		blendModes_[index] = blendModes_[last];
+		layers_[index] = layers_[last];
+		depths_[index] = depths_[last];
+		parentNodes_[index] = parentNodes_[last];
+		parentWorldGenerations_[index] = parentWorldGenerations_[last];
+		dirtyFlags_[index] = dirtyFlags_[last];
+		quads_[index] = quads_[last];
+		worldMatrices_[index] = worldMatrices_[last];
+		revisions_[index] = revisions_[last];
+		handles_[index] = handles_[last];
+		slotIndices_[handles_[index].index] = index;
+	}
+	positions_.pop_back();
+	rotations_.pop_back();
+	sizes_.pop_back();
+	anchorPoints_.pop_back();
+	flipFlags_.pop_back();
+	textureLeftTops_.pop_back();
+	textureCutSizes_.pop_back();
+	textureSizes_.pop_back();
+	imageOrigins_.pop_back();
+	imageSizes_.pop_back();
+	colors_.pop_back();
+	textureIndices_.pop_back();
+	blendModes_.pop_back();
+	layers_.pop_back();
+	depths_.pop_back();
+	parentNodes_.pop_back();
+	parentWorldGenerations_.pop_back();
+	dirtyFlags_.pop_back();
+	quads_.pop_back();
+	worldMatrices_.pop_back();
+	revisions_.pop_back();
+	handles_.pop_back();
+
+	// スロットを空けて、古いハンドルが使えないように番号を進める
+	slotIndices_[handle.index] = kNoIndex;
+	++slotGenerations_[handle.index];
+	freeSlots_.push_back(handle.index);
+}
+
+// ハンドルが生きているか
+bool SpriteSystem::IsAlive(SpriteHandle handle) const {
+	return handle.index < slotIndices_.size() && slotIndices_[handle.index] != kNoIndex && slotGenerations_[handle.index] == handle.generation;
+}
+
+// ハンドルから配列の位置を求める
+uint32_t SpriteSystem::IndexOf(SpriteHandle handle) const {
+	assert(IsAlive(handle));
+	return slotIndices_[handle.index];
+}
+
+// 座標のsetter
+void SpriteSystem::SetPosition(SpriteHandle handle, const Vector2& position) {
+	uint32_t index = IndexOf(handle);
+	if (positions_[index] == position) {
+		return;
+	}
+	positions_[index] = position;
+	dirtyFlags_[index] |= kDirtyWorld;
+}
+
+// 回転のsetter
+void SpriteSystem::SetRotation(SpriteHandle handle, float rotation) {
+	uint32_t index = IndexOf(handle);
+	if (rotations_[index] == rotation) {
+		return;
+	}
+	rotations_[index] = rotation;
+	dirtyFlags_[index] |= kDirtyWorld;
+}
+
+// 拡縮のsetter
+void SpriteSystem::SetSize(SpriteHandle handle, const Vector2& size) {
+	uint32_t index = IndexOf(handle);
+	if (sizes_[index] == size) {
+		return;
+	}
+	sizes_[index] = size;
+	dirtyFlags_[index] |= kDirtyWorld;
+}
+
+// 縦横の拡縮が同じか
+bool SpriteSystem::IsUniformScale(SpriteHandle handle) const {
+	uint32_t index = IndexOf(handle);
+	return std::fabs(sizes_[index].x) == std::fabs(sizes_[index].y) && parentNodes_[index] == kInvalidSceneNode;
+}
+
+// アンカーポイントのsetter
+void SpriteSystem::SetAnchorPoint(SpriteHandle handle, const Vector2& anchorPoint) {
+	uint32_t index = IndexOf(handle);
+	if (anchorPoints_[index] == anchorPoint) {
+		return;
+	}
+	anchorPoints_[index] = anchorPoint;
+	dirtyFlags_[index] |= kDirtyQuad;
+}
+
+// フリップのsetter
+void SpriteSystem::SetIsFlipX(SpriteHandle handle, bool isFlipX) { SetFlipFlag(handle, kFlipX, isFlipX); }
+void SpriteSystem::SetIsFlipY(SpriteHandle handle, bool isFlipY) { SetFlipFlag(handle, kFlipY, isFlipY); }
+
+void SpriteSystem::SetFlipFlag(SpriteHandle handle, uint8_t flag, bool isEnabled) {
+	uint32_t index = IndexOf(handle);
+	uint8_t flags = isEnabled ? static_cast<uint8_t>(flipFlags_[index] | flag) : static_cast<uint8_t>(flipFlags_[index] & ~flag);
+	if (flipFlags_[index] == flags) {
+		return;
+	}
+	flipFlags_[index] = flags;
+	dirtyFlags_[index] |= kDirtyQuad;
+}
+
+// テクスチャ範囲指定のsetter
+void SpriteSystem::SetTextureLeftTop(SpriteHandle handle, const Vector2& textureLeftTop) {
+	uint32_t index = IndexOf(handle);
+	if (textureLeftTops_[index] == textureLeftTop) {
+		return;
+	}
+	textureLeftTops_[index] = textureLeftTop;
+	dirtyFlags_[index] |= kDirtyQuad;
+}
+
+// テクスチャ切り出しサイズのsetter
+void SpriteSystem::SetTextureCutSize(SpriteHandle handle, const Vector2& textureCutSize) {
+	uint32_t index = IndexOf(handle);
+	if (textureCutSizes_[index] == textureCutSize) {
+		return;
+	}
+	textureCutSizes_[index] = textureCutSize;
+	dirtyFlags_[index] |= kDirtyQuad;
+}
+
+// 座標をまとめて書き込む
+void SpriteSystem::SetPositions(const SpriteHandle* handles, size_t count, const float* x, const float* y, std::vector<uint32_t>& outDeadIndices) {
+	SetWorldInputs(positions_, handles, count, x, y, outDeadIndices);
+}
+
+// 回転をまとめて書き込む
+void SpriteSystem::SetRotations(const SpriteHandle* handles, size_t count, const float* rotations, std::vector<uint32_t>& outDeadIndices) {
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t index = FindIndex(handles[i]);
+		if (index == kNoIndex) {
+			outDeadIndices.push_back(static_cast<uint32_t>(i));
+			continue;
+		}
+		if (rotations_[index] != rotations[i]) {
+			rotations_[index] = rotations[i];
+			dirtyFlags_[index] |= kDirtyWorld;
+		}
+	}
+}
+
+// 拡縮をまとめて書き込む
+void SpriteSystem::SetSizes(const SpriteHandle* handles, size_t count, const float* x, const float* y, std::vector<uint32_t>& outDeadIndices) {
+	SetWorldInputs(sizes_, handles, count, x, y, outDeadIndices);
+}
+
+// 色をまとめて書き込む
+void SpriteSystem::SetColors(const SpriteHandle* handles, size_t count, const float* r, const float* g, const float* b, const float* a, std::vector<uint32_t>& outDeadIndices) {
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t index = FindIndex(handles[i]);
+		if (index == kNoIndex) {
+			outDeadIndices.push_back(static_cast<uint32_t>(i));
+			continue;
+		}
+		colors_[index] = {r[i], g[i], b[i], a[i]};
+	}
+}
+
+// World行列の入力をまとめて書き込む
+void SpriteSystem::SetWorldInputs(std::vector<Vector2>& destination, const SpriteHandle* handles, size_t count, const float* x, const float* y, std::vector<uint32_t>& outDeadIndices) {
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t index = FindIndex(handles[i]);
+		if (index == kNoIndex) {
+			outDeadIndices.push_back(static_cast<uint32_t>(i));
+			continue;
+		}
+		Vector2 value = {x[i], y[i]};
+		if (destination[index] != value) {
+			destination[index] = value;
+			dirtyFlags_[index] |= kDirtyWorld;
+		}
+	}
+}
+
+// 使う画像の範囲の差し替え
+void SpriteSystem::SetTextureRegion(SpriteHandle handle, const SpriteTextureRegion& region) {
+	uint32_t index = IndexOf(handle);
+	textureIndices_[index] = region.textureIndex;
+	textureSizes_[index] = region.textureSize;
+	imageOrigins_[index] = region.origin;
+	imageSizes_[index] = region.size;
+	textureLeftTops_[index] = {0.0f, 0.0f};
+	textureCutSizes_[index] = region.size;
+	dirtyFlags_[index] |= kDirtyQuad;
+}
+
+// シーングラフのノードに取り付ける
+void SpriteSystem::SetParentNode(SpriteHandle handle, const SceneGraph* sceneGraph, SceneNodeId node) {
+	assert(node == kInvalidSceneNode || sceneGraph != nullptr);
+	// シーングラフは1つだけ(ノードの番号はシーングラフごとに別なので混ぜられない)
+	assert(sceneGraph == nullptr || sceneGraph_ == nullptr || sceneGraph_ == sceneGraph);
+	if (sceneGraph != nullptr) {
+		sceneGraph_ = sceneGraph;
+	}
+	uint32_t index = IndexOf(handle);
+	parentNodes_[index] = node;
+	dirtyFlags_[index] |= kDirtyWorld;
+}
+
+// 四角形とWorld行列の計算
+void SpriteSystem::Update() { rebuildCount_ += UpdateRange(nullptr, 0, GetCount()); }
+
+void SpriteSystem::Update(const uint32_t* indices, size_t count) { rebuildCount_ += UpdateRange(indices, 0, count); }
+
+void SpriteSystem::Update(WorkerPool& workerPool) {
+	// 計算し直した数は範囲ごとに数えて最後に足す
+	std::atomic<uint32_t> rebuildCount = 0;
+	workerPool.ParallelFor(GetCount(), kParallelChunkSize, [&](size_t begin, size_t end) {
+		rebuildCount.fetch_add(UpdateRange(nullptr, begin, end), std::memory_order_relaxed);
+	});
+	rebuildCount_ += rebuildCount.load(std::memory_order_relaxed);
+}
+
+void SpriteSystem::Update(const uint32_t* indices, size_t count, WorkerPool& workerPool) {
+	std::atomic<uint32_t> rebuildCount = 0;
+	workerPool.ParallelFor(count, kParallelChunkSize, [&](size_t begin, size_t end) {
+		rebuildCount.fetch_add(UpdateRange(indices, begin, end), std::memory_order_relaxed);
+	});
+	rebuildCount_ += rebuildCount.load(std::memory_order_relaxed);
+}
+
+// 範囲の計算
+// World行列を計算し直すものは溜めておき、4つずつまとめて求める(回転が配列に並んでいるので、sin/cosを4つ分1回で求められる)
+uint32_t SpriteSystem::UpdateRange(const uint32_t* indices, size_t begin, size_t end) {
+	uint32_t rebuildCount = 0;
+	uint32_t worldIndices[kWorldBatchSize];
+	uint32_t worldCount = 0;
+	for (size_t i = begin; i < end; ++i) {
+		uint32_t index = indices != nullptr ? indices[i] : static_cast<uint32_t>(i);
+		uint8_t dirtyFlags = UpdateAt(index);
+		if (dirtyFlags == 0) {
+			continue;
+		}
+		++rebuildCount;
+		if (dirtyFlags & kDirtyWorld) {
+			worldIndices[worldCount++] = index;
+			if (worldCount == kWorldBatchSize) {
+				UpdateWorldMatrices(worldIndices, worldCount);
+				worldCount = 0;
+			}
+		}
+	}
+	UpdateWorldMatrices(worldIndices, worldCount);
+	return rebuildCount;
+}
+
+// 1つ分の四角形の計算
+uint8_t SpriteSystem::UpdateAt(uint32_t index) {
+	// 親ノードのWorld行列が変わっていれば、自分のWorld行列も計算し直す
+	SceneNodeId parentNode = parentNodes_[index];
+	if (parentNode != kInvalidSceneNode) {
+		uint32_t parentWorldGeneration = sceneGraph_->GetWorldGeneration(parentNode);
+		if (parentWorldGeneration != parentWorldGenerations_[index]) {
+			parentWorldGenerations_[index] = parentWorldGeneration;
+			dirtyFlags_[index] |= kDirtyWorld;
+		}
+	}
+
+	// 何も変わっていなければ前回の値をそのまま使う
+	uint8_t dirtyFlags = dirtyFlags_[index];
+	if (dirtyFlags == 0) {
+		return 0;
+	}
+	++revisions_[index];
+
+	if (dirtyFlags & kDirtyQuad) {
+		// アンカーポイント-反映処理-
+		const Vector2& anchorPoint = anchorPoints_[index];
+		float left = 0.0f - anchorPoint.x;
+		float right = 1.0f - anchorPoint.x;
+		float top = 0.0f - anchorPoint.y;
+		float bottom = 1.0f - anchorPoint.y;
+
+		// 画像の中のピクセルで切り出す範囲
+		const Vector2& textureLeftTop = textureLeftTops_[index];
+		const Vector2& textureCutSize = textureCutSizes_[index];
+		const Vector2& imageSize = imageSizes_[index];
+		float tex_left = textureLeftTop.x;
+		float tex_right = textureLeftTop.x + textureCutSize.x;
+		float tex_top = textureLeftTop.y;
+		float tex_bottom = textureLeftTop.y + textureCutSize.y;
+
+		// 左右反転
+		// UVは画像の中で折り返す(テクスチャ1枚ならUVの符号を反転してWRAPで読むのと同じ。アトラスでも隣の画像を読まない)
+		if (flipFlags_[index] & kFlipX) {
+			left = -left;
+			right = -right;
+			tex_left = imageSize.x - tex_left;
+			tex_right = imageSize.x - tex_right;
+		}
+		// 上下反転
+		if (flipFlags_[index] & kFlipY) {
+			top = -top;
+			bottom = -bottom;
+			tex_top = imageSize.y - tex_top;
+			tex_bottom = imageSize.y - tex_bottom;
+		}
+
+		// テクスチャ全体のUVに直す
+		const Vector2& imageOrigin = imageOrigins_[index];
+		const Vector2& textureSize = textureSizes_[index];
+		tex_left = (imageOrigin.x + tex_left) / textureSize.x;
+		tex_right = (imageOrigin.x + tex_right) / textureSize.x;
+		tex_top = (imageOrigin.y + tex_top) / textureSize.y;
+		tex_bottom = (imageOrigin.y + tex_bottom) / textureSize.y;
+
+		// 四角形のローカル座標とUV(左下・左上・右下・右上)
+		SpriteQuad& quad = quads_[index];
+		quad.positions[0] = {left, bottom};
+		quad.texcoords[0] = {tex_left, tex_bottom};
+		quad.positions[1] = {left, top};
+		quad.texcoords[1] = {tex_left, tex_top};
+		quad.positions[2] = {right, bottom};
+		quad.texcoords[2] = {tex_right, tex_bottom};
+		quad.positions[3] = {right, top};
+		quad.texcoords[3] = {tex_right, tex_top};
+	}
+
+	dirtyFlags_[index] = 0;
+	return dirtyFlags;
+}
+
+// World行列をまとめて計算する
+void SpriteSystem::UpdateWorldMatrices(const uint32_t* indices, uint32_t count) {
+	assert(count <= kWorldBatchSize);
+	if (count == 0) {
+		return;
+	}
+	// 足りない分は最初のものを繰り返して4つにする
+	alignas(16) float rotations[kWorldBatchSize];
+	for (uint32_t i = 0; i < kWorldBatchSize; ++i) {
+		rotations[i] = rotations_[indices[i < count ? i : 0]];
+	}
+	alignas(16) float sinValues[kWorldBatchSize], cosValues[kWorldBatchSize];
+	__m128 s, c;
+	SinCos4(_mm_load_ps(rotations), s, c);
+	_mm_store_ps(sinValues, s);
+	_mm_store_ps(cosValues, c);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		uint32_t index = indices[i];
+		// MakeAffineMatrix({size.x, size.y, 1}, {0, 0, rotation}, {position.x, position.y, 0})と同じ値(Z軸回転だけなので行を直接書き込む)
+		const Vector2& position = positions_[index];
+		const Vector2& size = sizes_[index];
+		Matrix4x4& worldMatrix = worldMatrices_[index];
+		_mm_storeu_ps(worldMatrix.m[0], _mm_setr_ps(size.x * cosValues[i], size.x * sinValues[i], 0.0f, 0.0f));
+		_mm_storeu_ps(worldMatrix.m[1], _mm_setr_ps(-size.y * sinValues[i], size.y * cosValues[i], 0.0f, 0.0f));
+		_mm_storeu_ps(worldMatrix.m[2], _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f));
+		_mm_storeu_ps(worldMatrix.m[3], _mm_setr_ps(position.x, position.y, 0.0f, 1.0f));
+		// 親ノードがあればその座標系に置く
+		SceneNodeId parentNode = parentNodes_[index];
+		if (parentNode != kInvalidSceneNode) {
+			worldMatrix = Multiply(worldMatrix, sceneGraph_->GetWorldMatrix(parentNode));
+		}
+	}
+}
+
+// 画面上で占める範囲をまとめて求める
+void SpriteSystem::ComputeBoundingRects(Rect2D* outRects) const {
+	uint32_t count = GetCount();
+	for (uint32_t i = 0; i < count; ++i) {
+		outRects[i] = ComputeBoundingRect(i);
+	}
+}
+
+void SpriteSystem::ComputeBoundingRects(Rect2D* outRects, WorkerPool& workerPool) const {
+	workerPool.ParallelFor(GetCount(), kParallelChunkSize, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			outRects[i] = ComputeBoundingRect(static_cast<uint32_t>(i));
+		}
+	});
+}
+
+// 1つ分の範囲
+Rect2D SpriteSystem::ComputeBoundingRect(uint32_t index) const {
+	// アンカーポイントからの範囲(フリップすると反転する)
+	const Vector2& anchorPoint = anchorPoints_[index];
+	const Vector2& size = sizes_[index];
+	bool isFlipX = (flipFlags_[index] & kFlipX) != 0;
+	bool isFlipY = (flipFlags_[index] & kFlipY) != 0;
+	float left = (isFlipX ? anchorPoint.x - 1.0f : -anchorPoint.x) * size.x;
+	float right = (isFlipX ? anchorPoint.x : 1.0f - anchorPoint.x) * size.x;
+	float top = (isFlipY ? anchorPoint.y - 1.0f : -anchorPoint.y) * size.y;
+	float bottom = (isFlipY ? anchorPoint.y : 1.0f - anchorPoint.y) * size.y;
+
+	if (rotations_[index] != 0.0f) {
+		// 回転していれば、アンカーポイントから一番遠い角までの距離で囲む
+		float x = std::max(std::fabs(left), std::fabs(right));
+		float y = std::max(std::fabs(top), std::fabs(bottom));
+		float radius = std::sqrt(x * x + y * y);
+		left = -radius;
+		right = radius;
+		top = -radius;
+		bottom = radius;
+	}
+
+	const Vector2& position = positions_[index];
+	Rect2D rect = {std::min(left, right) + position.x, std::min(top, bottom) + position.y, std::max(left, right) + position.x, std::max(top, bottom) + position.y};
+	SceneNodeId parentNode = parentNodes_[index];
+	if (parentNode == kInvalidSceneNode) {
+		return rect;
+	}
+
+	// 親ノードがあれば4隅を親の座標系から変換して囲み直す
+	const Matrix4x4& parent = sceneGraph_->GetWorldMatrix(parentNode);
+	const Vector2 corners[4] = {
+	    {rect.left,  rect.top   },
+	    {rect.right, rect.top   },
+	    {rect.left,  rect.bottom},
+	    {rect.right, rect.bottom},
+	};
+	Rect2D result = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+	for (const Vector2& corner : corners) {
+		float x = corner.x * parent.m[0][0] + corner.y * parent.m[1][0] + parent.m[3][0];
+		float y = corner.x * parent.m[0][1] + corner.y * parent.m[1][1] + parent.m[3][1];
+		result.left = std::min(result.left, x);
+		result.top = std::min(result.top, y);
+		result.right = std::max(result.right, x);
+		result.bottom = std::max(result.bottom, y);
+	}
+	return result;
+}
@@ -0,0 +1,224 @@
+#pragma once
+#include "BlendMode.h"
+#include "SpriteBatchBuilder.h"
+#include "base/Culling.h"
+#include "base/MathTypes.h"
+#include "scene/SceneGraph.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 前方宣言
+class WorkerPool;
+
+// スプライトのハンドル
+// indexはスロットの番号、generationはそのスロットを使い回した回数
+// 削除済みのスプライトのハンドルはgenerationが合わなくなるので見分けられる
+struct SpriteHandle {
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+
+	bool operator==(const SpriteHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const SpriteHandle& other) const { return !(*this == other); }
+};
+inline constexpr SpriteHandle kInvalidSpriteHandle{};
+
+// スプライトが使うテクスチャの範囲
+// アトラスに詰めた画像なら、ページの中の1枚分の画像の場所になる
+struct SpriteTextureRegion {
+	uint32_t textureIndex = 0;
+	// テクスチャ全体のピクセル数
+	Vector2 textureSize = {0.0f, 0.0f};
+	// 画像の左上と大きさ(ピクセル)
+	Vector2 origin = {0.0f, 0.0f};
+	Vector2 size = {0.0f, 0.0f};
+};
+
+// スプライトの状態をまとめて持つ(DirectXに依存しない部分)
+// 値は項目ごとの配列(SoA)に隙間なく詰めて持ち、Updateやバッチに積む処理は配列を前から順に読む
+// ハンドルからはスロットを通して配列の位置(密な番号)を引く
+// 作成・削除はO(1)(削除は最後の要素を空いた位置に移すので、並び順は保たれない)
+// 別々のスプライトのsetterは別スレッドから同時に呼べる(作成・削除は呼んだスレッドだけで行うこと)
+class SpriteSystem {
+public:
+	// スプライトの作成(textureSizeはテクスチャ全体のピクセル数。拡縮と切り出しサイズもこれに合わせる)
+	SpriteHandle Create(uint32_t textureIndex, const Vector2& textureSize);
+	// テクスチャの一部を使うスプライトの作成(拡縮と切り出しサイズは画像の大きさに合わせる)
+	// テクスチャ範囲指定・切り出しサイズは画像の中のピクセルで指定し、Updateでテクスチャ全体のUVに直す
+	SpriteHandle Create(const SpriteTextureRegion& region);
+	// スプライトの削除(削除済みのハンドルなら何もしない)
+	void Destroy(SpriteHandle handle);
+	// ハンドルが生きているか
+	bool IsAlive(SpriteHandle handle) const;
+
+	// スプライト数
+	uint32_t GetCount() const { return static_cast<uint32_t>(handles_.size()); }
+	// ハンドルから配列の位置を求める(作成・削除で変わるので保存しない)
+	uint32_t IndexOf(SpriteHandle handle) const;
+	// 配列の位置からハンドルを求める
+	SpriteHandle GetHandle(uint32_t index) const { return handles_[index]; }
+
+	// 座標
+	const Vector2& GetPosition(SpriteHandle handle) const { return positions_[IndexOf(handle)]; }
+	void SetPosition(SpriteHandle handle, const Vector2& position);
+	// 回転
+	float GetRotation(SpriteHandle handle) const { return rotations_[IndexOf(handle)]; }
+	void SetRotation(SpriteHandle handle, float rotation);
+	// 拡縮
+	const Vector2& GetSize(SpriteHandle handle) const { return sizes_[IndexOf(handle)]; }
+	void SetSize(SpriteHandle handle, const Vector2& size);
+	// 縦横の拡縮が同じか(法線変換用の行列を求めずにWorld行列をそのまま使えるか)
+	// 奥行きの拡縮は1のままだが、スプライトの法線は(0,0,-1)だけなので向きは変わらない。親ノードの拡縮は分からないので、取り付けていればfalse
+	bool IsUniformScale(SpriteHandle handle) const;
+	// アンカーポイント
+	const Vector2& GetAnchorPoint(SpriteHandle handle) const { return anchorPoints_[IndexOf(handle)]; }
+	void SetAnchorPoint(SpriteHandle handle, const Vector2& anchorPoint);
+	// フリップ
+	bool GetIsFlipX(SpriteHandle handle) const { return (flipFlags_[IndexOf(handle)] & kFlipX) != 0; }
+	void SetIsFlipX(SpriteHandle handle, bool isFlipX);
+	bool GetIsFlipY(SpriteHandle handle) const { return (flipFlags_[IndexOf(handle)] & kFlipY) != 0; }
+	void SetIsFlipY(SpriteHandle handle, bool isFlipY);
+	// テクスチャ範囲指定
+	const Vector2& GetTextureLeftTop(SpriteHandle handle) const { return textureLeftTops_[IndexOf(handle)]; }
+	void SetTextureLeftTop(SpriteHandle handle, const Vector2& textureLeftTop);
+	// テクスチャ切り出しサイズ
+	const Vector2& GetTextureCutSize(SpriteHandle handle) const { return textureCutSizes_[IndexOf(handle)]; }
+	void SetTextureCutSize(SpriteHandle handle, const Vector2& textureCutSize);
+	// 色(四角形もWorld行列も変わらないので計算し直さない)
+	const Vector4& GetColor(SpriteHandle handle) const { return colors_[IndexOf(handle)]; }
+	void SetColor(SpriteHandle handle, const Vector4& color) { colors_[IndexOf(handle)] = color; }
+	// ブレンドモード
+	BlendMode GetBlendMode(SpriteHandle handle) const { return blendModes_[IndexOf(handle)]; }
+	void SetBlendMode(SpriteHandle handle, BlendMode blendMode) { blendModes_[IndexOf(handle)] = blendMode; }
+	// 描く順番のレイヤー(小さいほど先に描く。SpriteRenderQueueで並べるときに使う)
+	uint8_t GetLayer(SpriteHandle handle) const { return layers_[IndexOf(handle)]; }
+	void SetLayer(SpriteHandle handle, uint8_t layer) { layers_[IndexOf(handle)] = layer; }
+	// 同じレイヤーの中の奥行き(大きいほど奥で、先に描く。不透明は同じテクスチャの中だけで比べる。SpriteRenderQueueで並べるときに使う)
+	float GetDepth(SpriteHandle handle) const { return depths_[IndexOf(handle)]; }
+	void SetDepth(SpriteHandle handle, float depth) { depths_[IndexOf(handle)] = depth; }
+	// テクスチャ番号
+	uint32_t GetTextureIndex(SpriteHandle handle) const { return textureIndices_[IndexOf(handle)]; }
+	// 使う画像の範囲を差し替える(パラパラアニメのコマ送り用。切り出しは画像全体に戻し、拡縮はそのまま)
+	void SetTextureRegion(SpriteHandle handle, const SpriteTextureRegion& region);
+
+	// 成分ごとの配列に並んだ値をまとめて書き込む(Tweenで計算した値を移す用。i番目の値をhandles[i]に書き込む)
+	// 1つずつsetterを呼んだのと同じ結果になる。削除済みのハンドルは飛ばし、そのiをoutDeadIndicesに積む
+	void SetPositions(const SpriteHandle* handles, size_t count, const float* x, const float* y, std::vector<uint32_t>& outDeadIndices);
+	void SetRotations(const SpriteHandle* handles, size_t count, const float* rotations, std::vector<uint32_t>& outDeadIndices);
+	void SetSizes(const SpriteHandle* handles, size_t count, const float* x, const float* y, std::vector<uint32_t>& outDeadIndices);
+	void SetColors(const SpriteHandle* handles, size_t count, const float* r, const float* g, const float* b, const float* a, std::vector<uint32_t>& outDeadIndices);
+
+	// シーングラフのノードに取り付ける(nodeがkInvalidSceneNodeなら取り外す)
+	// シーングラフはシステムで1つだけ持つ
+	void SetParentNode(SpriteHandle handle, const SceneGraph* sceneGraph, SceneNodeId node);
+	SceneNodeId GetParentNode(SpriteHandle handle) const { return parentNodes_[IndexOf(handle)]; }
+
+	// 四角形とWorld行列の計算(変更があったものだけ)
+	void Update();
+	// indicesの位置のスプライトだけ計算する(カリング後など。昇順に並んでいれば前から順に読める)
+	void Update(const uint32_t* indices, size_t count);
+	// ワーカースレッドで分けて計算する(1つずつ別の位置に書き込むので、結果は1スレッドと同じ)
+	// indicesに同じ位置を2回入れないこと。親ノードのシーングラフは読むだけなので、終わるまで書き換えないこと
+	void Update(WorkerPool& workerPool);
+	void Update(const uint32_t* indices, size_t count, WorkerPool& workerPool);
+
+	// 画面上で占める範囲をまとめて求める(outRectsはGetCount()個分。回転している場合は回転しても収まる範囲)
+	void ComputeBoundingRects(Rect2D* outRects) const;
+	void ComputeBoundingRects(Rect2D* outRects, WorkerPool& workerPool) const;
+	// 1つ分の範囲
+	Rect2D GetBoundingRect(SpriteHandle handle) const { return ComputeBoundingRect(IndexOf(handle)); }
+
+	// Update後の値(配列の位置で引く。バッチに積むとき用)
+	const SpriteQuad* GetQuads() const { return quads_.data(); }
+	const Matrix4x4* GetWorldMatrices() const { return worldMatrices_.data(); }
+	const Vector4* GetColors() const { return colors_.data(); }
+	const uint32_t* GetTextureIndices() const { return textureIndices_.data(); }
+	const BlendMode* GetBlendModes() const { return blendModes_.data(); }
+	const uint8_t* GetLayers() const { return layers_.data(); }
+	const float* GetDepths() const { return depths_.data(); }
+	// 四角形かWorld行列を計算し直すたびに増える番号(1枚ずつ描くときに書き込み直すかの判断用)
+	uint32_t GetRevision(SpriteHandle handle) const { return revisions_[IndexOf(handle)]; }
+
+	// Updateで四角形かWorld行列を計算し直した数
+	uint32_t GetRebuildCount() const { return rebuildCount_; }
+	// 計算し直した数のリセット(フレームの最初に呼ぶ)
+	void ResetRebuildCount() { rebuildCount_ = 0; }
+
+private:
+	// 変更フラグ
+	enum DirtyFlag : uint8_t {
+		// 四角形(アンカーポイント・フリップ・テクスチャ範囲)
+		kDirtyQuad = 1 << 0,
+		// World行列(座標・回転・拡縮・親ノード)
+		kDirtyWorld = 1 << 1,
+	};
+	// フリップ
+	enum FlipFlag : uint8_t {
+		kFlipX = 1 << 0,
+		kFlipY = 1 << 1,
+	};
+	// スロットが空いていることを表す配列の位置
+	static constexpr uint32_t kNoIndex = UINT32_MAX;
+	// ワーカースレッドに分けるときの1回分の数(これより少なければ分けない)
+	static constexpr size_t kParallelChunkSize = 2048;
+	// World行列をまとめて計算する数(回転のsin/cosを4つずつ求める)
+	static constexpr uint32_t kWorldBatchSize = 4;
+
+	// 生きていれば配列の位置、削除済みならkNoIndex(削除で空いたスロットの位置はkNoIndexになっている)
+	uint32_t FindIndex(SpriteHandle handle) const {
+		return handle.index < slotIndices_.size() && slotGenerations_[handle.index] == handle.generation ? slotIndices_[handle.index] : kNoIndex;
+	}
+	// World行列の入力(座標・拡縮)をまとめて書き込む
+	void SetWorldInputs(std::vector<Vector2>& destination, const SpriteHandle* handles, size_t count, const float* x, const float* y, std::vector<uint32_t>& outDeadIndices);
+	// indicesの[begin, end)の位置(indicesがnullptrなら位置そのもの)を計算して、計算し直した数を返す
+	uint32_t UpdateRange(const uint32_t* indices, size_t begin, size_t end);
+	// 1つ分の四角形の計算(計算し直したら変更フラグを返す。World行列はUpdateWorldMatricesで求める)
+	uint8_t UpdateAt(uint32_t index);
+	// World行列をまとめて計算する(countはkWorldBatchSize以下)
+	void UpdateWorldMatrices(const uint32_t* indices, uint32_t count);
+	// 1つ分の範囲
+	Rect2D ComputeBoundingRect(uint32_t index) const;
+	// フリップの変更
+	void SetFlipFlag(SpriteHandle handle, uint8_t flag, bool isEnabled);
+
+	// 以下は密に並んだ配列(同じ位置が同じスプライト)
+	// World行列の入力
+	std::vector<Vector2> positions_;
+	std::vector<float> rotations_;
+	std::vector<Vector2> sizes_;
+	// 四角形の入力
+	std::vector<Vector2> anchorPoints_;
+	std::vector<uint8_t> flipFlags_;
+	std::vector<Vector2> textureLeftTops_;
+	std::vector<Vector2> textureCutSizes_;
+	std::vector<Vector2> textureSizes_;
+	std::vector<Vector2> imageOrigins_;
+	std::vector<Vector2> imageSizes_;
+	// 描画に使う値
+	std::vector<Vector4> colors_;
+	std::vector<uint32_t> textureIndices_;
+	std::vector<BlendMode> blendModes_;
+	// 描く順番
+	std::vector<uint8_t> layers_;
+	std::vector<float> depths_;
+	// 親ノードと、最後にWorld行列を計算したときの親の番号
+	std::vector<SceneNodeId> parentNodes_;
+	std::vector<uint32_t> parentWorldGenerations_;
+	// 変更フラグ(DirtyFlagの組み合わせ)
+	std::vector<uint8_t> dirtyFlags_;
+	// Updateで計算した値
+	std::vector<SpriteQuad> quads_;
+	std::vector<Matrix4x4> worldMatrices_;
+	std::vector<uint32_t> revisions_;
+	// 自分のハンドル(削除で後ろから移すときにスロットを書き換える)
+	std::vector<SpriteHandle> handles_;
+
+	// スロットごとの配列の位置(空きはkNoIndex)と使い回した回数
+	std::vector<uint32_t> slotIndices_;
+	std::vector<uint32_t> slotGenerations_;
+	// 空いているスロット
+	std::vector<uint32_t> freeSlots_;
+
+	const SceneGraph* sceneGraph_ = nullptr;
+	uint32_t rebuildCount_ = 0;
+};
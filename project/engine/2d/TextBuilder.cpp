@@ -0,0 +1,136 @@
+#include "TextBuilder.h"
+#include "BitmapFont.h"
+#include "base/Math.h"
+#include "base/TextureAtlas.h"
+
+namespace {
+
+// 改行
+const uint32_t kNewLine = '\n';
+const uint32_t kCarriageReturn = '\r';
+
+} // namespace
+
+TextBuilder::TextBuilder(const BitmapFont& font) : font_(&font) {}
+
+// 積み始める
+void TextBuilder::Begin() {
+	// 前のフレームで積まれなかったものを捨てる
+	std::erase_if(cache_, [&](const auto& item) { return item.second.lastUsedFrame < frame_; });
+	++frame_;
+
+	pages_.resize(font_->GetPageCount());
+	for (std::vector<SpriteVertex>& page : pages_) {
+		page.clear();
+	}
+}
+
+// 文字列を積む
+void TextBuilder::Add(std::string_view text, const Vector2& position, float scale, const Vector4& color) {
+	Entry& entry = cache_[ComputeKey(text, scale, color)];
+	// keyが同じでも中身が違う(初めて・keyが衝突した)なら並べ直す
+	if (entry.pageOffsets.empty() || entry.text != text || entry.scale != scale || entry.color != color) {
+		entry.text = text;
+		entry.scale = scale;
+		entry.color = color;
+		Layout(*font_, text, {0.0f, 0.0f}, scale, color, entry.vertices, entry.pageOffsets);
+		++layoutCount_;
+	}
+	entry.lastUsedFrame = frame_;
+
+	// ページごとの列の後ろに、位置をずらしながらコピーする
+	for (uint32_t page = 0; page < GetPageCount(); ++page) {
+		uint32_t first = entry.pageOffsets[page] * SpriteBatchBuilder::kVertexCountPerSprite;
+		uint32_t last = entry.pageOffsets[page + 1] * SpriteBatchBuilder::kVertexCountPerSprite;
+		if (first == last) {
+			continue;
+		}
+		std::vector<SpriteVertex>& vertices = pages_[page];
+		size_t offset = vertices.size();
+		vertices.resize(offset + (last - first));
+		const SpriteVertex* source = entry.vertices.data() + first;
+		SpriteVertex* destination = vertices.data() + offset;
+		for (uint32_t i = 0; i < last - first; ++i) {
+			destination[i] = source[i];
+			destination[i].position.x += position.x;
+			destination[i].position.y += position.y;
+		}
+	}
+}
+
+// 積んだ全ページの文字数
+uint32_t TextBuilder::GetGlyphCount() const {
+	uint32_t count = 0;
+	for (uint32_t page = 0; page < GetPageCount(); ++page) {
+		count += GetGlyphCount(page);
+	}
+	return count;
+}
+
+// 文字列を並べる
+void TextBuilder::Layout(
+    const BitmapFont& font, std::string_view text, const Vector2& position, float scale, const Vector4& color, std::vector<SpriteVertex>& outVertices,
+    std::vector<uint32_t>& outPageOffsets) {
+	const char* begin = text.data();
+	const char* end = text.data() + text.size();
+	uint32_t pageCount = font.GetPageCount();
+
+	// ページごとの文字数を数えて、ページ順に詰めたときの先頭を決める
+	outPageOffsets.assign(pageCount + 1, 0);
+	for (const char* it = begin; it != end;) {
+		uint32_t codepoint = DecodeUtf8(it, end);
+		if (codepoint == kNewLine || codepoint == kCarriageReturn) {
+			continue;
+		}
+		const Glyph* glyph = font.FindGlyph(codepoint);
+		if (glyph != nullptr && glyph->size.x > 0.0f) {
+			++outPageOffsets[glyph->page + 1];
+		}
+	}
+	for (uint32_t page = 0; page < pageCount; ++page) {
+		outPageOffsets[page + 1] += outPageOffsets[page];
+	}
+	outVertices.resize(static_cast<size_t>(outPageOffsets[pageCount]) * SpriteBatchBuilder::kVertexCountPerSprite);
+
+	// ペンをベースラインに沿って進めながら、ページごとの書き込み位置に四角形を書き込む
+	std::vector<uint32_t> cursors(outPageOffsets.begin(), outPageOffsets.end() - 1);
+	float penX = position.x;
+	float baseline = position.y + font.GetAscent() * scale;
+	for (const char* it = begin; it != end;) {
+		uint32_t codepoint = DecodeUtf8(it, end);
+		if (codepoint == kNewLine) {
+			penX = position.x;
+			baseline += font.GetLineHeight() * scale;
+			continue;
+		}
+		if (codepoint == kCarriageReturn) {
+			continue;
+		}
+		const Glyph* glyph = font.FindGlyph(codepoint);
+		if (glyph == nullptr) {
+			continue;
+		}
+		if (glyph->size.x > 0.0f) {
+			float left = penX + glyph->offset.x * scale;
+			float top = baseline + glyph->offset.y * scale;
+			float right = left + glyph->size.x * scale;
+			float bottom = top + glyph->size.y * scale;
+			const Vector4& uv = glyph->uvRect;
+
+			// 頂点の順番はSpriteと同じ 左下・左上・右下・右上
+			SpriteVertex* out = &outVertices[static_cast<size_t>(cursors[glyph->page]++) * SpriteBatchBuilder::kVertexCountPerSprite];
+			out[0] = {{left, bottom, 0.0f, 1.0f}, {uv.x, uv.w}, color};
+			out[1] = {{left, top, 0.0f, 1.0f}, {uv.x, uv.y}, color};
+			out[2] = {{right, bottom, 0.0f, 1.0f}, {uv.z, uv.w}, color};
+			out[3] = {{right, top, 0.0f, 1.0f}, {uv.z, uv.y}, color};
+		}
+		penX += glyph->advance * scale;
+	}
+}
+
+// キャッシュのkey
+uint64_t TextBuilder::ComputeKey(std::string_view text, float scale, const Vector4& color) {
+	uint64_t key = TextureAtlas::Hash(text.data(), text.size());
+	key = TextureAtlas::Hash(&scale, sizeof(scale), key);
+	return TextureAtlas::Hash(&color, sizeof(color), key);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "SpriteBatchBuilder.h"
+#include "base/MathTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 前方宣言
+class BitmapFont;
+
+// 文字列をフォントのページごとの頂点にまとめる(DirectXに依存しない部分)
+// 1文字を1枚の四角形(SpriteBatchと同じ頂点)にし、ページごとに1本の頂点の列に詰めるので、ページごとに1回のDrawCallで描ける
+//
+// 並べた結果は文字列・大きさ・色ごとに、位置(0, 0)に置いたものとしてキャッシュする
+// 同じ文字列をもう一度積むときは並べ直さず、キャッシュした頂点に位置を足しながらコピーするだけにする(動く・スクロールする文字列も並べ直さない)
+// 前のフレームで積まれなかったキャッシュはBeginで捨てる
+class TextBuilder {
+public:
+	explicit TextBuilder(const BitmapFont& font);
+
+	// 積み始める(フレームの始めに呼ぶ)
+	void Begin();
+	// 文字列を積む(positionは1行目の左上、scaleはフォントを焼き込んだ大きさに掛ける。改行は'\n')
+	void Add(std::string_view text, const Vector2& position, float scale, const Vector4& color);
+
+	// 積んだ頂点(ページごと。page番目のページの文字だけが並ぶ)
+	const SpriteVertex* GetVertices(uint32_t page) const { return pages_[page].data(); }
+	// ページごとの文字数
+	uint32_t GetGlyphCount(uint32_t page) const { return static_cast<uint32_t>(pages_[page].size() / SpriteBatchBuilder::kVertexCountPerSprite); }
+	// ページ数
+	uint32_t GetPageCount() const { return static_cast<uint32_t>(pages_.size()); }
+	// 積んだ全ページの文字数
+	uint32_t GetGlyphCount() const;
+
+	// キャッシュになく並べ直した文字列の数
+	uint32_t GetLayoutCount() const { return layoutCount_; }
+	// 並べ直した数のリセット(フレームの最初に呼ぶ)
+	void ResetLayoutCount() { layoutCount_ = 0; }
+	// キャッシュしている文字列の数
+	size_t GetCacheSize() const { return cache_.size(); }
+
+	// 文字列を並べて、ページ順に詰めた頂点を書き込む(キャッシュは使わない)
+	// outPageOffsetsはページ数 + 1個で、page番目のページの文字は[outPageOffsets[page], outPageOffsets[page + 1])
+	static void Layout(
+	    const BitmapFont& font, std::string_view text, const Vector2& position, float scale, const Vector4& color, std::vector<SpriteVertex>& outVertices,
+	    std::vector<uint32_t>& outPageOffsets);
+
+private:
+	// 並べた結果
+	struct Entry {
+		std::string text;
+		float scale;
+		Vector4 color;
+		// 位置(0, 0)に置いたときの頂点
+		std::vector<SpriteVertex> vertices;
+		std::vector<uint32_t> pageOffsets;
+		// 最後に積んだフレーム
+		uint64_t lastUsedFrame;
+	};
+
+	// キャッシュのkey
+	static uint64_t ComputeKey(std::string_view text, float scale, const Vector4& color);
+
+	const BitmapFont* font_ = nullptr;
+	std::vector<std::vector<SpriteVertex>> pages_;
+	std::unordered_map<uint64_t, Entry> cache_;
+	uint64_t frame_ = 0;
+	uint32_t layoutCount_ = 0;
+};
@@ -0,0 +1,133 @@
+#include "Tilemap.h"
+#include "base/Math.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+Tilemap::Tilemap(uint32_t width, uint32_t height, const Vector2& tileSize, const SpriteTextureRegion& tileset, uint32_t columns, uint32_t rows)
+    : width_(width), height_(height), tileSize_(tileSize), tileset_(tileset), tiles_(static_cast<size_t>(width) * height, kEmptyTile),
+      chunkColumns_((width + kChunkSize - 1) / kChunkSize), chunkRows_((height + kChunkSize - 1) / kChunkSize) {
+	assert(width > 0 && height > 0);
+	assert(columns > 0 && rows > 0 && columns * rows < UINT16_MAX);
+
+	// タイルの番号ごとのUVを先に求めておく(頂点を作るときは表を引くだけ)
+	const Vector2& textureSize = tileset.textureSize;
+	Vector2 cellSize = {tileset.size.x / static_cast<float>(columns), tileset.size.y / static_cast<float>(rows)};
+	tileUvs_.resize(static_cast<size_t>(columns) * rows + 1);
+	for (uint32_t row = 0; row < rows; ++row) {
+		for (uint32_t column = 0; column < columns; ++column) {
+			float left = tileset.origin.x + cellSize.x * static_cast<float>(column);
+			float top = tileset.origin.y + cellSize.y * static_cast<float>(row);
+			tileUvs_[row * columns + column + 1] = {
+			    left / textureSize.x,
+			    top / textureSize.y,
+			    (left + cellSize.x) / textureSize.x,
+			    (top + cellSize.y) / textureSize.y,
+			};
+		}
+	}
+
+	chunkTileCounts_.assign(GetChunkCount(), 0);
+	chunkRevisions_.assign(GetChunkCount(), 1);
+}
+
+// タイルのsetter
+void Tilemap::SetTile(uint32_t x, uint32_t y, TileId tile) {
+	assert(x < width_ && y < height_);
+	assert(tile < tileUvs_.size());
+	TileId& current = tiles_[static_cast<size_t>(y) * width_ + x];
+	if (current == tile) {
+		return;
+	}
+	uint32_t chunk = (y / kChunkSize) * chunkColumns_ + x / kChunkSize;
+	if (current == kEmptyTile) {
+		++chunkTileCounts_[chunk];
+	} else if (tile == kEmptyTile) {
+		--chunkTileCounts_[chunk];
+	}
+	current = tile;
+	++chunkRevisions_[chunk];
+}
+
+// 座標のsetter
+void Tilemap::SetPosition(const Vector2& position) {
+	if (position_ == position) {
+		return;
+	}
+	position_ = position;
+	InvalidateAllChunks();
+}
+
+// 色のsetter
+void Tilemap::SetColor(const Vector4& color) {
+	if (color_ == color) {
+		return;
+	}
+	color_ = color;
+	InvalidateAllChunks();
+}
+
+// ビューポート矩形と重なるチャンクを求める
+size_t Tilemap::CullChunks(const Rect2D& viewport, uint32_t* outChunks) const {
+	// ビューポートをチャンクの格子に直して、重なる範囲の行と列だけを調べる
+	float chunkWidth = tileSize_.x * static_cast<float>(kChunkSize);
+	float chunkHeight = tileSize_.y * static_cast<float>(kChunkSize);
+	auto toColumn = [&](float x) { return std::clamp(x / chunkWidth, 0.0f, static_cast<float>(chunkColumns_)); };
+	auto toRow = [&](float y) { return std::clamp(y / chunkHeight, 0.0f, static_cast<float>(chunkRows_)); };
+	uint32_t columnBegin = static_cast<uint32_t>(std::floor(toColumn(viewport.left - position_.x)));
+	uint32_t columnEnd = static_cast<uint32_t>(std::ceil(toColumn(viewport.right - position_.x)));
+	uint32_t rowBegin = static_cast<uint32_t>(std::floor(toRow(viewport.top - position_.y)));
+	uint32_t rowEnd = static_cast<uint32_t>(std::ceil(toRow(viewport.bottom - position_.y)));
+
+	size_t count = 0;
+	for (uint32_t row = rowBegin; row < rowEnd; ++row) {
+		for (uint32_t column = columnBegin; column < columnEnd; ++column) {
+			uint32_t chunk = row * chunkColumns_ + column;
+			// 空のチャンクは描くものがない
+			if (chunkTileCounts_[chunk] != 0) {
+				outChunks[count++] = chunk;
+			}
+		}
+	}
+	return count;
+}
+
+// チャンクの頂点を作る
+uint32_t Tilemap::BuildChunk(uint32_t chunk, SpriteVertex* outVertices) const {
+	uint32_t firstX = (chunk % chunkColumns_) * kChunkSize;
+	uint32_t firstY = (chunk / chunkColumns_) * kChunkSize;
+	uint32_t lastX = std::min(firstX + kChunkSize, width_);
+	uint32_t lastY = std::min(firstY + kChunkSize, height_);
+
+	uint32_t quadCount = 0;
+	for (uint32_t y = firstY; y < lastY; ++y) {
+		const TileId* row = &tiles_[static_cast<size_t>(y) * width_];
+		float top = position_.y + tileSize_.y * static_cast<float>(y);
+		float bottom = top + tileSize_.y;
+		for (uint32_t x = firstX; x < lastX; ++x) {
+			TileId tile = row[x];
+			if (tile == kEmptyTile) {
+				continue;
+			}
+			float left = position_.x + tileSize_.x * static_cast<float>(x);
+			float right = left + tileSize_.x;
+			const Vector4& uv = tileUvs_[tile];
+
+			// 頂点の順番はSpriteと同じ 左下・左上・右下・右上
+			SpriteVertex* out = outVertices + static_cast<size_t>(quadCount) * SpriteBatchBuilder::kVertexCountPerSprite;
+			out[0] = {{left, bottom, 0.0f, 1.0f}, {uv.x, uv.w}, color_};
+			out[1] = {{left, top, 0.0f, 1.0f}, {uv.x, uv.y}, color_};
+			out[2] = {{right, bottom, 0.0f, 1.0f}, {uv.z, uv.w}, color_};
+			out[3] = {{right, top, 0.0f, 1.0f}, {uv.z, uv.y}, color_};
+			++quadCount;
+		}
+	}
+	return quadCount;
+}
+
+// 全チャンクの番号を進める
+void Tilemap::InvalidateAllChunks() {
+	for (uint32_t& revision : chunkRevisions_) {
+		++revision;
+	}
+}
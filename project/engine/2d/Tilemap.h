@@ -0,0 +1,85 @@
+#pragma once
+#include "BlendMode.h"
+#include "SpriteBatchBuilder.h"
+#include "SpriteSystem.h"
+#include "base/Culling.h"
+#include "base/MathTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// タイルの番号(0は空。1からはタイルセットの左上から横、縦の順)
+using TileId = uint16_t;
+inline constexpr TileId kEmptyTile = 0;
+
+// タイルマップ(DirectXに依存しない部分)
+// マップをkChunkSize x kChunkSizeタイルのチャンクに分け、描くときはチャンクごとにまとめて頂点を作る
+// タイルを書き換えるとそのチャンクの番号(revision)が進むので、作った頂点を持つ側は番号が変わったチャンクだけ作り直せばよい
+// 見える範囲のチャンクは格子から直接求めるので、マップの大きさによらず見えている分だけ調べる
+class Tilemap {
+public:
+	// 1チャンクの1辺のタイル数
+	static const uint32_t kChunkSize = 32;
+	// 1チャンクの最大の四角形数
+	static const uint32_t kMaxQuadsPerChunk = kChunkSize * kChunkSize;
+
+	// width x heightタイルのマップ(全て空)。タイルセットはtilesetの範囲をcolumns x rowsに分けたもの
+	Tilemap(uint32_t width, uint32_t height, const Vector2& tileSize, const SpriteTextureRegion& tileset, uint32_t columns, uint32_t rows);
+
+	// マップのタイル数
+	uint32_t GetWidth() const { return width_; }
+	uint32_t GetHeight() const { return height_; }
+	// 1タイルの大きさ
+	const Vector2& GetTileSize() const { return tileSize_; }
+
+	// タイル
+	TileId GetTile(uint32_t x, uint32_t y) const { return tiles_[static_cast<size_t>(y) * width_ + x]; }
+	void SetTile(uint32_t x, uint32_t y, TileId tile);
+	// 左上の座標(変えると全チャンクを作り直す)
+	const Vector2& GetPosition() const { return position_; }
+	void SetPosition(const Vector2& position);
+	// 色(変えると全チャンクを作り直す)
+	const Vector4& GetColor() const { return color_; }
+	void SetColor(const Vector4& color);
+	// ブレンドモード(頂点は変わらない)
+	BlendMode GetBlendMode() const { return blendMode_; }
+	void SetBlendMode(BlendMode blendMode) { blendMode_ = blendMode; }
+	uint32_t GetTextureIndex() const { return tileset_.textureIndex; }
+
+	// チャンク数
+	uint32_t GetChunkColumns() const { return chunkColumns_; }
+	uint32_t GetChunkRows() const { return chunkRows_; }
+	uint32_t GetChunkCount() const { return chunkColumns_ * chunkRows_; }
+	// チャンクの中の空でないタイル数(= 頂点を作ったときの四角形数)
+	uint32_t GetChunkTileCount(uint32_t chunk) const { return chunkTileCounts_[chunk]; }
+	// チャンクの中身が変わるたびに増える番号(1から始まる)
+	uint32_t GetChunkRevision(uint32_t chunk) const { return chunkRevisions_[chunk]; }
+
+	// ビューポート矩形と重なる、空でないチャンクの番号をoutChunksに詰めて書き込み、その数を返す
+	// outChunksはGetChunkCount()個分の領域が必要
+	size_t CullChunks(const Rect2D& viewport, uint32_t* outChunks) const;
+	// チャンクの空でないタイルの四角形を書き込み、その数を返す(outVerticesはkMaxQuadsPerChunk * 4頂点分)
+	// 頂点はWorld変換済みで、SpriteBatchと同じ並び(左下・左上・右下・右上)
+	uint32_t BuildChunk(uint32_t chunk, SpriteVertex* outVertices) const;
+
+private:
+	// 全チャンクの番号を進める
+	void InvalidateAllChunks();
+
+	uint32_t width_;
+	uint32_t height_;
+	Vector2 tileSize_;
+	SpriteTextureRegion tileset_;
+	Vector2 position_ = {0.0f, 0.0f};
+	Vector4 color_ = {1.0f, 1.0f, 1.0f, 1.0f};
+	BlendMode blendMode_ = BlendMode::kNormal;
+	// タイル(横に並べた行を上から)
+	std::vector<TileId> tiles_;
+	// タイルの番号ごとのUV(left, top, right, bottom。0番は使わない)
+	std::vector<Vector4> tileUvs_;
+
+	uint32_t chunkColumns_;
+	uint32_t chunkRows_;
+	std::vector<uint32_t> chunkTileCounts_;
+	std::vector<uint32_t> chunkRevisions_;
+};
@@ -0,0 +1,82 @@
+#include "TilemapChunkCache.h"
+#include <algorithm>
+#include <cassert>
+
+// 書き込み先の設定
+void TilemapChunkCache::SetDestination(SpriteVertex* vertices, uint32_t slotCount) {
+	vertices_ = vertices;
+	tilemap_ = nullptr;
+	slotChunks_.assign(slotCount, kNoIndex);
+	slotRevisions_.assign(slotCount, 0);
+	slotQuadCounts_.assign(slotCount, 0);
+	slotLastFrames_.assign(slotCount, 0);
+	chunkSlots_.clear();
+	draws_.clear();
+	skippedCount_ = 0;
+}
+
+// 見えているチャンクを描けるようにする
+void TilemapChunkCache::Prepare(const Tilemap& tilemap, const uint32_t* chunks, size_t count) {
+	// 同時に見えるチャンク数よりスロットが少なければ、入りきる分だけ描く(描かなかった数はGetSkippedCountで分かる)
+	// 今のフレームで使うチャンクがスロット数以下なら、使い回せるスロットが必ず残る
+	size_t preparedCount = std::min(count, slotChunks_.size());
+	skippedCount_ = static_cast<uint32_t>(count - preparedCount);
+	if (tilemap_ != &tilemap || chunkSlots_.size() != tilemap.GetChunkCount()) {
+		// 違うタイルマップになったら全スロットを空ける
+		tilemap_ = &tilemap;
+		slotChunks_.assign(slotChunks_.size(), kNoIndex);
+		slotLastFrames_.assign(slotLastFrames_.size(), 0);
+		chunkSlots_.assign(tilemap.GetChunkCount(), kNoIndex);
+	}
+	++frame_;
+
+	// 先に今のフレームで使うスロットに印を付けておき、使い回すスロットに選ばれないようにする
+	for (size_t i = 0; i < preparedCount; ++i) {
+		uint32_t slot = chunkSlots_[chunks[i]];
+		if (slot != kNoIndex) {
+			slotLastFrames_[slot] = frame_;
+		}
+	}
+
+	draws_.clear();
+	for (size_t i = 0; i < preparedCount; ++i) {
+		uint32_t chunk = chunks[i];
+		uint32_t slot = chunkSlots_[chunk];
+		if (slot == kNoIndex) {
+			// スロットを持っていなければ、空いているか一番長く使われていないものをもらう
+			slot = FindVictimSlot();
+			if (slotChunks_[slot] != kNoIndex) {
+				chunkSlots_[slotChunks_[slot]] = kNoIndex;
+			}
+			slotChunks_[slot] = chunk;
+			slotRevisions_[slot] = 0;
+			slotLastFrames_[slot] = frame_;
+			chunkSlots_[chunk] = slot;
+		}
+		// 作ってから中身が変わっていれば作り直す(番号は1から始まるので、もらったばかりのスロットは必ず作る)
+		if (slotRevisions_[slot] != tilemap.GetChunkRevision(chunk)) {
+			slotQuadCounts_[slot] = tilemap.BuildChunk(chunk, vertices_ + static_cast<size_t>(slot) * kVertexCountPerSlot);
+			slotRevisions_[slot] = tilemap.GetChunkRevision(chunk);
+			++rebuildCount_;
+		}
+		if (slotQuadCounts_[slot] != 0) {
+			draws_.push_back({slot, slotQuadCounts_[slot]});
+		}
+	}
+}
+
+// 空いているか、一番長く使われていないスロットを探す
+uint32_t TilemapChunkCache::FindVictimSlot() const {
+	uint32_t victim = kNoIndex;
+	for (uint32_t slot = 0; slot < slotChunks_.size(); ++slot) {
+		if (slotChunks_[slot] == kNoIndex) {
+			return slot;
+		}
+		// 今のフレームで使うスロットは選ばない
+		if (slotLastFrames_[slot] != frame_ && (victim == kNoIndex || slotLastFrames_[slot] < slotLastFrames_[victim])) {
+			victim = slot;
+		}
+	}
+	assert(victim != kNoIndex);
+	return victim;
+}
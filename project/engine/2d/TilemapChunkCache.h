@@ -0,0 +1,61 @@
+#pragma once
+#include "SpriteBatchBuilder.h"
+#include "Tilemap.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// タイルマップのチャンクの頂点を置いておく場所(DirectXに依存しない部分)
+// 頂点の配列をチャンク1つ分ずつの枠(スロット)に分け、見えているチャンクに1つずつ割り当てる
+// 前のフレームから同じスロットにいて、中身の番号(revision)が変わっていないチャンクは作り直さない
+// スロットが足りなければ、一番長く使われていないチャンクのスロットを使い回す(戻ってきたら作り直す)
+// (ベンチマークからも使えるように分けてある。GPUのアップロードヒープを直接渡せるように、書き込むだけで読み戻さない)
+class TilemapChunkCache {
+public:
+	// 1回のDrawCallで描くチャンク
+	struct ChunkDraw {
+		uint32_t slot;
+		uint32_t quadCount;
+	};
+
+	// 1スロットの頂点数
+	static const uint32_t kVertexCountPerSlot = Tilemap::kMaxQuadsPerChunk * SpriteBatchBuilder::kVertexCountPerSprite;
+
+	// 書き込み先の設定(slotCount * kVertexCountPerSlot頂点分の領域が必要。全スロットを空にする)
+	void SetDestination(SpriteVertex* vertices, uint32_t slotCount);
+
+	// tilemapのchunksを描けるようにする(中身が変わったか、スロットを持っていないチャンクだけ頂点を作る)
+	// chunksはCullChunksで求めたもの。同じtilemapに使い続けること(違うtilemapを渡すと全て作り直す)
+	// スロット数より多ければ、入りきらない後ろのチャンクは描かずにGetSkippedCountで数える
+	void Prepare(const Tilemap& tilemap, const uint32_t* chunks, size_t count);
+
+	// 直前のPrepareで描くチャンク
+	const std::vector<ChunkDraw>& GetDraws() const { return draws_; }
+	// 直前のPrepareでスロットが足りずに描かなかったチャンク数(0でなければSetDestinationのslotCountを増やす)
+	uint32_t GetSkippedCount() const { return skippedCount_; }
+	// 頂点を作り直したチャンク数
+	uint32_t GetRebuildCount() const { return rebuildCount_; }
+	// 作り直したチャンク数のリセット(フレームの最初に呼ぶ)
+	void ResetRebuildCount() { rebuildCount_ = 0; }
+
+private:
+	// スロットやチャンクがないことを表す番号
+	static constexpr uint32_t kNoIndex = UINT32_MAX;
+
+	// 空いているか、一番長く使われていないスロットを探す
+	uint32_t FindVictimSlot() const;
+
+	SpriteVertex* vertices_ = nullptr;
+	const Tilemap* tilemap_ = nullptr;
+	// スロットごとのチャンク・作ったときの番号・四角形数・最後に使ったフレーム
+	std::vector<uint32_t> slotChunks_;
+	std::vector<uint32_t> slotRevisions_;
+	std::vector<uint32_t> slotQuadCounts_;
+	std::vector<uint64_t> slotLastFrames_;
+	// チャンクごとのスロット(持っていなければkNoIndex)
+	std::vector<uint32_t> chunkSlots_;
+	std::vector<ChunkDraw> draws_;
+	uint64_t frame_ = 0;
+	uint32_t skippedCount_ = 0;
+	uint32_t rebuildCount_ = 0;
+};
@@ -0,0 +1,69 @@
+#include "TilemapRenderer.h"
+#include "SpriteCommon.h"
+#include "Tilemap.h"
+#include "base/TextureManager.h"
+#include <cassert>
+
+// 初期化
+void TilemapRenderer::Initialize(SpriteCommon* spriteCommon, uint32_t maxVisibleChunks) {
+	assert(maxVisibleChunks > 0);
+	spriteCommon_ = spriteCommon;
+	DirectXCommon* dXCommon = spriteCommon_->GetDXCommon();
+
+	// 頂点バッファ(チャンク1つ分ずつのスロットに分けて使う。Mapしたままにして、作り直したチャンクだけ書き込む)
+	size_t vertexBufferSize = sizeof(SpriteVertex) * TilemapChunkCache::kVertexCountPerSlot * maxVisibleChunks;
+	vertexResource_ = dXCommon->CreateBufferResource(vertexBufferSize);
+	assert(vertexResource_ != nullptr);
+	SpriteVertex* vertexData = nullptr;
+	vertexResource_->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
+	vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
+	vertexBufferView_.SizeInBytes = static_cast<UINT>(vertexBufferSize);
+	vertexBufferView_.StrideInBytes = sizeof(SpriteVertex);
+	cache_.SetDestination(vertexData, maxVisibleChunks);
+
+	// インデックスバッファ(チャンク1つ分。スロットの先頭の頂点の位置をずらして全チャンクで使う)
+	size_t indexBufferSize = sizeof(uint32_t) * SpriteBatchBuilder::kIndexCountPerSprite * Tilemap::kMaxQuadsPerChunk;
+	indexResource_ = dXCommon->CreateBufferResource(indexBufferSize);
+	assert(indexResource_ != nullptr);
+	uint32_t* indexData = nullptr;
+	indexResource_->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+	SpriteBatchBuilder::WriteQuadIndices(indexData, Tilemap::kMaxQuadsPerChunk);
+	indexResource_->Unmap(0, nullptr);
+	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+	indexBufferView_.SizeInBytes = static_cast<UINT>(indexBufferSize);
+	indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
+
+	// ViewProjection行列(頂点はWorld変換済みなのでこれだけ掛ける)
+	viewProjectionResource_ = dXCommon->CreateBufferResource(sizeof(Matrix4x4));
+	assert(viewProjectionResource_ != nullptr);
+	viewProjectionResource_->Map(0, nullptr, reinterpret_cast<void**>(&viewProjectionData_));
+	*viewProjectionData_ = kIdentity4x4;
+}
+
+// 映るチャンクを描画する
+void TilemapRenderer::Draw(const Tilemap& tilemap, const Rect2D& viewport) {
+	// 映るチャンクを格子から求め、中身が変わったかスロットを持っていないチャンクだけ頂点を作る
+	visibleChunks_.resize(tilemap.GetChunkCount());
+	size_t visibleChunkCount = tilemap.CullChunks(viewport, visibleChunks_.data());
+	cache_.Prepare(tilemap, visibleChunks_.data(), visibleChunkCount);
+
+	tileCount_ = 0;
+	if (cache_.GetDraws().empty()) {
+		return;
+	}
+	*viewProjectionData_ = spriteCommon_->GetViewProjectionMatrix();
+
+	ID3D12GraphicsCommandList* commandList = spriteCommon_->GetDXCommon()->GetCommandList();
+	spriteCommon_->SetBatchPipelineState(tilemap.GetBlendMode());
+	commandList->IASetVertexBuffers(0, 1, &vertexBufferView_);
+	commandList->IASetIndexBuffer(&indexBufferView_);
+	commandList->SetGraphicsRootConstantBufferView(0, viewProjectionResource_->GetGPUVirtualAddress());
+	commandList->SetGraphicsRootDescriptorTable(1, TextureManager::GetInstance()->GetSrvHandleGPU(tilemap.GetTextureIndex()));
+
+	// チャンクごとに1回だけ描く(インデックスは0番目の頂点から数えているので、スロットの先頭に頂点の位置をずらす)
+	for (const TilemapChunkCache::ChunkDraw& draw : cache_.GetDraws()) {
+		INT baseVertex = static_cast<INT>(draw.slot * TilemapChunkCache::kVertexCountPerSlot);
+		commandList->DrawIndexedInstanced(draw.quadCount * SpriteBatchBuilder::kIndexCountPerSprite, 1, 0, baseVertex, 0);
+		tileCount_ += draw.quadCount;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "TilemapChunkCache.h"
+#include "base/DirectXCommon.h"
+#include <d3d12.h>
+#include <wrl.h>
+
+// 前方宣言
+class SpriteCommon;
+class Tilemap;
+
+// タイルマップを描画する
+// カメラに映るチャンクだけを、チャンクごとに1回のDrawCallで描く
+// チャンクの頂点は中身が変わったときか、初めて映ったときだけ作って頂点バッファに置いておく(毎フレームは書き込まない)
+// パイプラインはSpriteBatchと同じもの(SpriteCommon::SetBatchPipelineState)を使う
+//
+// 頂点バッファはMapしたままにしておく(PostDrawでGPUを待つので、1フレーム分あれば上書きしても問題ない)
+// インデックスはチャンク1つ分の四角形の並びを初期化時に1回だけ書き込み、全チャンクで使い回す
+class TilemapRenderer {
+public:
+	// 初期化(maxVisibleChunksは同時に映る最大チャンク数。頂点バッファはチャンクこの数分だけ持つ)
+	void Initialize(SpriteCommon* spriteCommon, uint32_t maxVisibleChunks);
+
+	// viewportに映るチャンクを描画する
+	void Draw(const Tilemap& tilemap, const Rect2D& viewport);
+
+	// 直前のDrawで積んだDrawCall数
+	uint32_t GetDrawCallCount() const { return static_cast<uint32_t>(cache_.GetDraws().size()); }
+	// 直前のDrawで描いたタイル数
+	uint32_t GetTileCount() const { return tileCount_; }
+	// 直前のDrawで頂点バッファが足りずに描かなかったチャンク数(0でなければInitializeのmaxVisibleChunksを増やす)
+	uint32_t GetSkippedChunkCount() const { return cache_.GetSkippedCount(); }
+	// 頂点を作り直したチャンク数(GetRebuildCountはResetRebuildCountまで数え続ける)
+	uint32_t GetRebuildCount() const { return cache_.GetRebuildCount(); }
+	void ResetRebuildCount() { cache_.ResetRebuildCount(); }
+
+private:
+	SpriteCommon* spriteCommon_ = nullptr;
+
+	// 頂点・インデックス・ViewProjection行列のリソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_;
+	Microsoft::WRL::ComPtr<ID3D12Resource> viewProjectionResource_;
+	Matrix4x4* viewProjectionData_ = nullptr;
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
+	D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+
+	TilemapChunkCache cache_;
+	// カリングの作業領域
+	std::vector<uint32_t> visibleChunks_;
+	uint32_t tileCount_ = 0;
+};
@@ -0,0 +1,289 @@
+#include "TweenSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace {
+
+// SIMDでまとめて処理する要素数
+const size_t kLaneCount = 4;
+// 項目ごとの成分数
+const uint32_t kComponentCounts[] = {2, 1, 2, 4};
+// kOnceの折り返す長さ(折り返さない)
+const float kOncePeriod = FLT_MAX;
+
+// 4つ分の進み具合を進め、イージングを掛けた値を求める
+// progressは折り返した後の値に書き換える
+inline __m128 Advance4(__m128& progress, __m128 rate, __m128 period, __m128i tableOffset, __m128 deltaTime, const float* table) {
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	// 1周を超えたら折り返す(遅延中の負の値はそのまま)
+	__m128 u = _mm_add_ps(progress, _mm_mul_ps(deltaTime, rate));
+	__m128 cycles = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(_mm_max_ps(u, zero), period)));
+	u = _mm_sub_ps(u, _mm_mul_ps(cycles, period));
+	progress = u;
+
+	// 0〜1の時間(往復は後半を逆向きにする)
+	__m128 t = _mm_max_ps(u, zero);
+	__m128 isYoyo = _mm_cmpeq_ps(period, _mm_set1_ps(2.0f));
+	__m128 yoyo = _mm_sub_ps(one, _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(t, one)));
+	t = _mm_or_ps(_mm_and_ps(isYoyo, yoyo), _mm_andnot_ps(isYoyo, _mm_min_ps(t, one)));
+
+	// 表の隣り合う2点を線形補間する
+	const float sampleCount = static_cast<float>(EasingTable::kSampleCount);
+	__m128 x = _mm_mul_ps(t, _mm_set1_ps(sampleCount));
+	__m128i sample = _mm_cvttps_epi32(_mm_min_ps(x, _mm_set1_ps(sampleCount - 1.0f)));
+	__m128 fraction = _mm_sub_ps(x, _mm_cvtepi32_ps(sample));
+	alignas(16) int32_t offsets[kLaneCount];
+	_mm_store_si128(reinterpret_cast<__m128i*>(offsets), _mm_add_epi32(tableOffset, sample));
+	__m128 a = _mm_setr_ps(table[offsets[0]], table[offsets[1]], table[offsets[2]], table[offsets[3]]);
+	__m128 b = _mm_setr_ps(table[offsets[0] + 1], table[offsets[1] + 1], table[offsets[2] + 1], table[offsets[3] + 1]);
+	return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fraction));
+}
+
+// kOnceで終わりまで進んだレーン
+inline int FinishedMask(__m128 progress, __m128 period) {
+	__m128 isOnce = _mm_cmpgt_ps(period, _mm_set1_ps(2.0f));
+	return _mm_movemask_ps(_mm_and_ps(isOnce, _mm_cmpge_ps(progress, _mm_set1_ps(1.0f))));
+}
+
+} // namespace
+
+// 項目ごとの成分数を決めておく
+TweenSystem::TweenSystem() {
+	for (size_t property = 0; property < static_cast<size_t>(TweenProperty::kCount); ++property) {
+		tracks_[property].componentCount = kComponentCounts[property];
+	}
+}
+
+// 座標
+void TweenSystem::TweenPosition(const SpriteSystem& system, SpriteHandle target, const Vector2& end, const Settings& settings) {
+	const Vector2& start = system.GetPosition(target);
+	Add(TweenProperty::kPosition, target, &start.x, &end.x, settings);
+}
+
+// 回転
+void TweenSystem::TweenRotation(const SpriteSystem& system, SpriteHandle target, float end, const Settings& settings) {
+	float start = system.GetRotation(target);
+	Add(TweenProperty::kRotation, target, &start, &end, settings);
+}
+
+// 拡縮
+void TweenSystem::TweenSize(const SpriteSystem& system, SpriteHandle target, const Vector2& end, const Settings& settings) {
+	const Vector2& start = system.GetSize(target);
+	Add(TweenProperty::kSize, target, &start.x, &end.x, settings);
+}
+
+// 色
+void TweenSystem::TweenColor(const SpriteSystem& system, SpriteHandle target, const Vector4& end, const Settings& settings) {
+	const Vector4& start = system.GetColor(target);
+	Add(TweenProperty::kColor, target, &start.x, &end.x, settings);
+}
+
+// 止める
+void TweenSystem::Cancel(SpriteHandle target, TweenProperty property) {
+	Track& track = tracks_[static_cast<size_t>(property)];
+	uint32_t index = Find(track, target);
+	if (index != kNoIndex) {
+		RemoveAt(track, index);
+	}
+}
+
+// 再生中か
+bool TweenSystem::IsTweening(SpriteHandle target, TweenProperty property) const { return Find(tracks_[static_cast<size_t>(property)], target) != kNoIndex; }
+
+// 全Tweenを進めてスプライトに書き込む
+void TweenSystem::Update(float deltaTime, SpriteSystem& system) {
+	for (size_t property = 0; property < static_cast<size_t>(TweenProperty::kCount); ++property) {
+		Track& track = tracks_[property];
+		if (track.targets.empty()) {
+			continue;
+		}
+		finished_.clear();
+		Evaluate(track, deltaTime);
+		Scatter(static_cast<TweenProperty>(property), track, system);
+
+		// 後ろから取り除く(後ろの要素が前に移るので、前の位置は変わらない)
+		std::sort(finished_.begin(), finished_.end());
+		finished_.erase(std::unique(finished_.begin(), finished_.end()), finished_.end());
+		for (auto it = finished_.rbegin(); it != finished_.rend(); ++it) {
+			RemoveAt(track, *it);
+		}
+	}
+}
+
+// 再生中のTween数
+uint32_t TweenSystem::GetCount() const {
+	uint32_t count = 0;
+	for (const Track& track : tracks_) {
+		count += static_cast<uint32_t>(track.targets.size());
+	}
+	return count;
+}
+
+// Tweenを追加する
+void TweenSystem::Add(TweenProperty property, SpriteHandle target, const float* start, const float* end, const Settings& settings) {
+	assert(settings.duration > 0.0f);
+	Track& track = tracks_[static_cast<size_t>(property)];
+
+	uint32_t index = Find(track, target);
+	if (index == kNoIndex) {
+		if (target.index >= track.targetTweens.size()) {
+			track.targetTweens.resize(target.index + 1, kNoIndex);
+		}
+		// 削除済みのスプライトのものが残っていれば先に取り除く(同じスロットを使い回している)
+		if (track.targetTweens[target.index] != kNoIndex) {
+			RemoveAt(track, track.targetTweens[target.index]);
+		}
+		// 後ろに追加する
+		index = static_cast<uint32_t>(track.targets.size());
+		track.targetTweens[target.index] = index;
+		track.targets.push_back(target);
+		track.progresses.push_back(0.0f);
+		track.rates.push_back(0.0f);
+		track.periods.push_back(0.0f);
+		track.tableOffsets.push_back(0);
+		for (uint32_t c = 0; c < track.componentCount; ++c) {
+			track.starts[c].push_back(0.0f);
+			track.deltas[c].push_back(0.0f);
+			track.values[c].push_back(0.0f);
+		}
+	}
+
+	float rate = 1.0f / settings.duration;
+	track.progresses[index] = -settings.delay * rate;
+	track.rates[index] = rate;
+	track.periods[index] = settings.loopMode == TweenLoopMode::kLoop ? 1.0f : settings.loopMode == TweenLoopMode::kYoyo ? 2.0f : kOncePeriod;
+	track.tableOffsets[index] = static_cast<int32_t>(static_cast<uint32_t>(settings.easing) * EasingTable::kStride);
+	for (uint32_t c = 0; c < track.componentCount; ++c) {
+		track.starts[c][index] = start[c];
+		track.deltas[c][index] = end[c] - start[c];
+	}
+}
+
+// スプライトのTweenの配列の位置
+uint32_t TweenSystem::Find(const Track& track, SpriteHandle target) const {
+	if (target.index >= track.targetTweens.size()) {
+		return kNoIndex;
+	}
+	uint32_t index = track.targetTweens[target.index];
+	// 同じスロットを使い回した別のスプライトならTweenはない
+	if (index == kNoIndex || track.targets[index] != target) {
+		return kNoIndex;
+	}
+	return index;
+}
+
+// 1つ分を取り除く
+void TweenSystem::RemoveAt(Track& track, uint32_t index) {
+	uint32_t last = static_cast<uint32_t>(track.targets.size()) - 1;
+	track.targetTweens[track.targets[index].index] = kNoIndex;
+	if (index != last) {
+		track.targets[index] = track.targets[last];
+		track.progresses[index] = track.progresses[last];
+		track.rates[index] = track.rates[last];
+		track.periods[index] = track.periods[last];
+		track.tableOffsets[index] = track.tableOffsets[last];
+		for (uint32_t c = 0; c < track.componentCount; ++c) {
+			track.starts[c][index] = track.starts[c][last];
+			track.deltas[c][index] = track.deltas[c][last];
+			track.values[c][index] = track.values[c][last];
+		}
+		track.targetTweens[track.targets[index].index] = index;
+	}
+	track.targets.pop_back();
+	track.progresses.pop_back();
+	track.rates.pop_back();
+	track.periods.pop_back();
+	track.tableOffsets.pop_back();
+	for (uint32_t c = 0; c < track.componentCount; ++c) {
+		track.starts[c].pop_back();
+		track.deltas[c].pop_back();
+		track.values[c].pop_back();
+	}
+}
+
+// トラックの全Tweenを進めて値を計算する
+void TweenSystem::Evaluate(Track& track, float deltaTime) {
+	const float* table = EasingTable::GetInstance().GetData();
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	const size_t count = track.targets.size();
+
+	size_t base = 0;
+	// 4つ揃っている分は配列から直接読み書きする
+	for (; base + kLaneCount <= count; base += kLaneCount) {
+		__m128 progress = _mm_loadu_ps(&track.progresses[base]);
+		__m128 period = _mm_loadu_ps(&track.periods[base]);
+		__m128i tableOffset = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&track.tableOffsets[base]));
+		__m128 eased = Advance4(progress, _mm_loadu_ps(&track.rates[base]), period, tableOffset, dt, table);
+		_mm_storeu_ps(&track.progresses[base], progress);
+		for (uint32_t c = 0; c < track.componentCount; ++c) {
+			__m128 value = _mm_add_ps(_mm_loadu_ps(&track.starts[c][base]), _mm_mul_ps(_mm_loadu_ps(&track.deltas[c][base]), eased));
+			_mm_storeu_ps(&track.values[c][base], value);
+		}
+		int finished = FinishedMask(progress, period);
+		for (size_t lane = 0; finished != 0; ++lane, finished >>= 1) {
+			if (finished & 1) {
+				finished_.push_back(static_cast<uint32_t>(base + lane));
+			}
+		}
+	}
+
+	// 端数は0で埋めて同じ計算をする(折り返す長さは0で割らないように1にする)
+	if (base < count) {
+		size_t laneCount = count - base;
+		alignas(16) float progresses[kLaneCount] = {}, rates[kLaneCount] = {}, periods[kLaneCount] = {1.0f, 1.0f, 1.0f, 1.0f};
+		alignas(16) int32_t tableOffsets[kLaneCount] = {};
+		std::memcpy(progresses, &track.progresses[base], laneCount * sizeof(float));
+		std::memcpy(rates, &track.rates[base], laneCount * sizeof(float));
+		std::memcpy(periods, &track.periods[base], laneCount * sizeof(float));
+		std::memcpy(tableOffsets, &track.tableOffsets[base], laneCount * sizeof(int32_t));
+		__m128 progress = _mm_load_ps(progresses);
+		__m128 period = _mm_load_ps(periods);
+		__m128 eased = Advance4(progress, _mm_load_ps(rates), period, _mm_load_si128(reinterpret_cast<const __m128i*>(tableOffsets)), dt, table);
+		_mm_store_ps(progresses, progress);
+		std::memcpy(&track.progresses[base], progresses, laneCount * sizeof(float));
+		alignas(16) float easedValues[kLaneCount];
+		_mm_store_ps(easedValues, eased);
+		for (uint32_t c = 0; c < track.componentCount; ++c) {
+			for (size_t lane = 0; lane < laneCount; ++lane) {
+				track.values[c][base + lane] = track.starts[c][base + lane] + track.deltas[c][base + lane] * easedValues[lane];
+			}
+		}
+		int finished = FinishedMask(progress, period);
+		for (size_t lane = 0; lane < laneCount; ++lane) {
+			if (finished & (1 << lane)) {
+				finished_.push_back(static_cast<uint32_t>(base + lane));
+			}
+		}
+	}
+}
+
+// 計算した値をスプライトに書き込む
+void TweenSystem::Scatter(TweenProperty property, Track& track, SpriteSystem& system) {
+	const SpriteHandle* targets = track.targets.data();
+	const size_t count = track.targets.size();
+	const float* x = track.values[0].data();
+	const float* y = track.values[1].data();
+	const float* z = track.values[2].data();
+	const float* w = track.values[3].data();
+	switch (property) {
+	case TweenProperty::kPosition:
+		system.SetPositions(targets, count, x, y, finished_);
+		break;
+	case TweenProperty::kRotation:
+		system.SetRotations(targets, count, x, finished_);
+		break;
+	case TweenProperty::kSize:
+		system.SetSizes(targets, count, x, y, finished_);
+		break;
+	case TweenProperty::kColor:
+		system.SetColors(targets, count, x, y, z, w, finished_);
+		break;
+	default:
+		break;
+	}
+}
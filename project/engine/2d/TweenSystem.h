@@ -0,0 +1,104 @@
+#pragma once
+#include "SpriteSystem.h"
+#include "base/Easing.h"
+#include <cstdint>
+#include <vector>
+
+// Tweenで変える項目
+enum class TweenProperty : uint8_t {
+	kPosition,
+	kRotation,
+	kSize,
+	kColor,
+
+	kCount,
+};
+
+// Tweenの繰り返し方
+enum class TweenLoopMode : uint8_t {
+	// 終わりの値で止まり、取り除く
+	kOnce,
+	// 終わったら始まりの値に戻って繰り返す
+	kLoop,
+	// 終わったら逆向きに戻り、往復を繰り返す
+	kYoyo,
+};
+
+// スプライトの値を時間をかけて変える(DirectXに依存しない部分)
+// 項目ごとに1本のトラックを持ち、再生中のTweenを項目の成分ごとの配列(SoA)に詰める
+// Updateではトラックごとに4つずつSIMDで進み具合とイージングを計算し、最後にまとめてスプライトに書き込む
+// イージングは焼き込んだ表(EasingTable)を引くので、sin・powは使わない
+class TweenSystem {
+public:
+	// Tweenの設定
+	struct Settings {
+		// 始まりから終わりまでの秒数
+		float duration = 1.0f;
+		EasingType easing = EasingType::kLinear;
+		TweenLoopMode loopMode = TweenLoopMode::kOnce;
+		// 始まるまでの秒数(その間は始まりの値のまま)
+		float delay = 0.0f;
+	};
+
+	TweenSystem();
+
+	// 今の値からendまで変える(同じスプライト・項目のTweenがあれば置き換える)
+	void TweenPosition(const SpriteSystem& system, SpriteHandle target, const Vector2& end, const Settings& settings);
+	void TweenRotation(const SpriteSystem& system, SpriteHandle target, float end, const Settings& settings);
+	void TweenSize(const SpriteSystem& system, SpriteHandle target, const Vector2& end, const Settings& settings);
+	void TweenColor(const SpriteSystem& system, SpriteHandle target, const Vector4& end, const Settings& settings);
+
+	// 止める(今の値のまま残る)
+	void Cancel(SpriteHandle target, TweenProperty property);
+	// 再生中か
+	bool IsTweening(SpriteHandle target, TweenProperty property) const;
+
+	// 全TweenをdeltaTime秒まとめて進めてスプライトに書き込む
+	// kOnceで終わったものと、削除済みのスプライトのものはここで取り除く(毎フレームのメモリ確保はしない)
+	void Update(float deltaTime, SpriteSystem& system);
+
+	// 再生中のTween数
+	uint32_t GetCount() const;
+	uint32_t GetCount(TweenProperty property) const { return static_cast<uint32_t>(tracks_[static_cast<size_t>(property)].targets.size()); }
+
+private:
+	// 1つのTweenの成分の最大数(色)
+	static constexpr uint32_t kMaxComponentCount = 4;
+	// Tweenがないことを表す配列の位置
+	static constexpr uint32_t kNoIndex = UINT32_MAX;
+
+	// 1つの項目のTween(隙間なく詰める)
+	struct Track {
+		uint32_t componentCount = 0;
+		std::vector<SpriteHandle> targets;
+		// 進み具合(0で始まり、1で終わり。遅延中は負)
+		std::vector<float> progresses;
+		// 1秒あたりの進み具合(1 / duration)
+		std::vector<float> rates;
+		// 進み具合を折り返す長さ(kLoopは1、kYoyoは2、kOnceは折り返さない)
+		std::vector<float> periods;
+		// イージングの表の先頭(type * EasingTable::kStride)
+		std::vector<int32_t> tableOffsets;
+		// 成分ごとの始まりの値・終わりとの差・計算した値
+		std::vector<float> starts[kMaxComponentCount];
+		std::vector<float> deltas[kMaxComponentCount];
+		std::vector<float> values[kMaxComponentCount];
+		// スプライトのスロット番号からTweenの配列の位置を引く
+		std::vector<uint32_t> targetTweens;
+	};
+
+	// Tweenを追加する(置き換える)
+	void Add(TweenProperty property, SpriteHandle target, const float* start, const float* end, const Settings& settings);
+	// スプライトのTweenの配列の位置(なければkNoIndex)
+	uint32_t Find(const Track& track, SpriteHandle target) const;
+	// 1つ分を取り除く(最後の要素を空いた位置に移す)
+	void RemoveAt(Track& track, uint32_t index);
+	// トラックの全Tweenを進めて値を計算し、終わったものをfinished_に積む
+	void Evaluate(Track& track, float deltaTime);
+	// 計算した値をスプライトに書き込み、削除済みのスプライトのものをfinished_に積む
+	void Scatter(TweenProperty property, Track& track, SpriteSystem& system);
+
+	Track tracks_[static_cast<size_t>(TweenProperty::kCount)];
+	// 取り除くTweenの配列の位置(昇順。作業用に使い回す)
+	std::vector<uint32_t> finished_;
+};
@@ -0,0 +1,91 @@
+#include "Camera3D.h"
+
+uint32_t Camera3D::matrixRebuildCount_ = 0;
+
+// 初期化
+void Camera3D::Initialize(float fovY, float aspectRatio, float nearClip, float farClip) {
+	fovY_ = fovY;
+	aspectRatio_ = aspectRatio;
+	nearClip_ = nearClip;
+	farClip_ = farClip;
+	isViewDirty_ = true;
+	isProjectionDirty_ = true;
+	Update();
+}
+
+// 回転のsetter
+void Camera3D::SetRotate(const Vector3& rotate) {
+	if (rotate == rotate_) {
+		return;
+	}
+	rotate_ = rotate;
+	isViewDirty_ = true;
+}
+
+// 座標のsetter
+void Camera3D::SetTranslate(const Vector3& translate) {
+	if (translate == translate_) {
+		return;
+	}
+	translate_ = translate;
+	isViewDirty_ = true;
+}
+
+// 垂直画角のsetter
+void Camera3D::SetFovY(float fovY) {
+	if (fovY == fovY_) {
+		return;
+	}
+	fovY_ = fovY;
+	isProjectionDirty_ = true;
+}
+
+// アスペクト比のsetter
+void Camera3D::SetAspectRatio(float aspectRatio) {
+	if (aspectRatio == aspectRatio_) {
+		return;
+	}
+	aspectRatio_ = aspectRatio;
+	isProjectionDirty_ = true;
+}
+
+// クリップ距離のsetter
+void Camera3D::SetNearFarClip(float nearClip, float farClip) {
+	if (nearClip == nearClip_ && farClip == farClip_) {
+		return;
+	}
+	nearClip_ = nearClip;
+	farClip_ = farClip;
+	isProjectionDirty_ = true;
+}
+
+// 更新処理
+void Camera3D::Update() {
+	if (!isViewDirty_ && !isProjectionDirty_) {
+		return;
+	}
+
+	// ビュー行列はカメラのアフィン変換の逆変換
+	if (isViewDirty_) {
+		AffineTransform cameraTransform = MakeAffineTransform({1.0f, 1.0f, 1.0f}, rotate_, translate_);
+		worldMatrix_ = ToMatrix4x4(cameraTransform);
+		viewMatrix_ = ToMatrix4x4(Inverse(cameraTransform));
+		++matrixRebuildCount_;
+	}
+
+	// 透視投影行列
+	if (isProjectionDirty_) {
+		projectionMatrix_ = MakePerspectiveFovMatrix(fovY_, aspectRatio_, nearClip_, farClip_);
+		inverseProjectionMatrix_ = Inverse(projectionMatrix_);
+		++matrixRebuildCount_;
+	}
+
+	// どちらかが変わったらビュープロジェクション行列も作り直す
+	// (V*P)^-1 = P^-1 * V^-1 で、V^-1はカメラのワールド行列
+	viewProjectionMatrix_ = Multiply(viewMatrix_, projectionMatrix_);
+	inverseViewProjectionMatrix_ = Multiply(inverseProjectionMatrix_, worldMatrix_);
+	++matrixRebuildCount_;
+
+	isViewDirty_ = false;
+	isProjectionDirty_ = false;
+}
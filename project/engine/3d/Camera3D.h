@@ -0,0 +1,75 @@
+#pragma once
+#include "base/Math.h"
+#include "base/MathTypes.h"
+#include <cstdint>
+
+// 3Dカメラ
+// 入力が変わったときだけビュー・プロジェクション行列を作り直す
+class Camera3D {
+public:
+	// 初期化
+	void Initialize(float fovY, float aspectRatio, float nearClip, float farClip);
+
+	// 更新処理(変更があった行列だけ作り直す)
+	void Update();
+
+	// 回転のgetter
+	const Vector3& GetRotate() const { return rotate_; }
+	// 回転のsetter
+	void SetRotate(const Vector3& rotate);
+
+	// 座標のgetter
+	const Vector3& GetTranslate() const { return translate_; }
+	// 座標のsetter
+	void SetTranslate(const Vector3& translate);
+
+	// 垂直画角のsetter
+	void SetFovY(float fovY);
+	// アスペクト比のsetter
+	void SetAspectRatio(float aspectRatio);
+	// クリップ距離のsetter
+	void SetNearFarClip(float nearClip, float farClip);
+
+	// 行列のgetter(Update後の値)
+	const Matrix4x4& GetWorldMatrix() const { return worldMatrix_; }
+	const Matrix4x4& GetViewMatrix() const { return viewMatrix_; }
+	const Matrix4x4& GetProjectionMatrix() const { return projectionMatrix_; }
+	const Matrix4x4& GetViewProjectionMatrix() const { return viewProjectionMatrix_; }
+	const Matrix4x4& GetInverseProjectionMatrix() const { return inverseProjectionMatrix_; }
+	const Matrix4x4& GetInverseViewProjectionMatrix() const { return inverseViewProjectionMatrix_; }
+
+	// このフレームで行列を作り直した回数(全カメラ合計)
+	static uint32_t GetMatrixRebuildCount() { return matrixRebuildCount_; }
+	// 行列を作り直した回数のリセット(フレームの最初に呼ぶ)
+	static void ResetMatrixRebuildCount() { matrixRebuildCount_ = 0; }
+
+private:
+	// 回転
+	Vector3 rotate_ = {0.0f, 0.0f, 0.0f};
+	// 座標
+	Vector3 translate_ = {0.0f, 0.0f, -5.0f};
+
+	// 垂直画角
+	float fovY_ = 0.45f;
+	// アスペクト比
+	float aspectRatio_ = 16.0f / 9.0f;
+	// ニアクリップ距離
+	float nearClip_ = 0.1f;
+	// ファークリップ距離
+	float farClip_ = 100.0f;
+
+	// 変更フラグ
+	bool isViewDirty_ = true;
+	bool isProjectionDirty_ = true;
+
+	// キャッシュした行列
+	Matrix4x4 worldMatrix_ = kIdentity4x4;
+	Matrix4x4 viewMatrix_ = kIdentity4x4;
+	Matrix4x4 projectionMatrix_ = kIdentity4x4;
+	Matrix4x4 viewProjectionMatrix_ = kIdentity4x4;
+	Matrix4x4 inverseProjectionMatrix_ = kIdentity4x4;
+	Matrix4x4 inverseViewProjectionMatrix_ = kIdentity4x4;
+
+	// 行列を作り直した回数
+	static uint32_t matrixRebuildCount_;
+};
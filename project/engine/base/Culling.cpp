@@ -0,0 +1,151 @@
+#include "Culling.h"
+#include <cmath>
+#include <emmintrin.h>
+
+namespace {
+
+// 4要素ずつ処理する
+const size_t kLaneCount = 4;
+
+// 判定結果のマスクから表示する番号を詰めて書き込む
+inline size_t WriteVisibleIndices(int mask, size_t base, uint32_t* outIndices, size_t visibleCount) {
+	while (mask != 0) {
+		// 一番下の立っているビット
+		int lane = 0;
+		while (((mask >> lane) & 1) == 0) {
+			++lane;
+		}
+		outIndices[visibleCount++] = static_cast<uint32_t>(base + lane);
+		mask &= mask - 1;
+	}
+	return visibleCount;
+}
+
+// 端数分の要素を有効にするマスク
+inline int ValidLaneMask(size_t laneCount) { return (1 << laneCount) - 1; }
+
+// 平面の正規化
+Plane NormalizePlane(float a, float b, float c, float d) {
+	float length = std::sqrt(a * a + b * b + c * c);
+	float lengthRecp = length != 0.0f ? 1.0f / length : 0.0f;
+	return {
+	    {a * lengthRecp, b * lengthRecp, c * lengthRecp},
+        d * lengthRecp
+    };
+}
+
+} // namespace
+
+// ビュープロジェクション行列から視錐台の6平面を取り出す
+// 行ベクトル規約なので、クリップ座標の各成分は行列の列との内積になる
+Frustum MakeFrustum(const Matrix4x4& viewProjection) {
+	const float(&m)[4][4] = viewProjection.m;
+	Frustum frustum;
+	// 左 : w + x >= 0
+	frustum.planes[0] = NormalizePlane(m[0][3] + m[0][0], m[1][3] + m[1][0], m[2][3] + m[2][0], m[3][3] + m[3][0]);
+	// 右 : w - x >= 0
+	frustum.planes[1] = NormalizePlane(m[0][3] - m[0][0], m[1][3] - m[1][0], m[2][3] - m[2][0], m[3][3] - m[3][0]);
+	// 下 : w + y >= 0
+	frustum.planes[2] = NormalizePlane(m[0][3] + m[0][1], m[1][3] + m[1][1], m[2][3] + m[2][1], m[3][3] + m[3][1]);
+	// 上 : w - y >= 0
+	frustum.planes[3] = NormalizePlane(m[0][3] - m[0][1], m[1][3] - m[1][1], m[2][3] - m[2][1], m[3][3] - m[3][1]);
+	// 近 : z >= 0 (DirectXの深度範囲は0～1)
+	frustum.planes[4] = NormalizePlane(m[0][2], m[1][2], m[2][2], m[3][2]);
+	// 遠 : w - z >= 0
+	frustum.planes[5] = NormalizePlane(m[0][3] - m[0][2], m[1][3] - m[1][2], m[2][3] - m[2][2], m[3][3] - m[3][2]);
+	return frustum;
+}
+
+// 視錐台と重なる境界球を求める
+size_t CullSpheres(const Frustum& frustum, const BoundingSphere* spheres, size_t count, uint32_t* outIndices) {
+	size_t visibleCount = 0;
+	for (size_t base = 0; base < count; base += kLaneCount) {
+		size_t laneCount = count - base < kLaneCount ? count - base : kLaneCount;
+
+		// 4つの球を読み込んでSoAに並べ替える(端数は最後の球で埋める)
+		__m128 x = _mm_loadu_ps(&spheres[base].center.x);
+		__m128 y = _mm_loadu_ps(&spheres[base + (laneCount > 1 ? 1 : 0)].center.x);
+		__m128 z = _mm_loadu_ps(&spheres[base + (laneCount > 2 ? 2 : laneCount - 1)].center.x);
+		__m128 radius = _mm_loadu_ps(&spheres[base + laneCount - 1].center.x);
+		_MM_TRANSPOSE4_PS(x, y, z, radius);
+
+		// 全ての平面の表側にかかっていれば表示
+		__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Plane& plane : frustum.planes) {
+			__m128 distance = _mm_add_ps(
+			    _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.normal.x)), _mm_mul_ps(y, _mm_set1_ps(plane.normal.y))),
+			    _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.normal.z)), _mm_set1_ps(plane.distance)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+		}
+
+		int mask = _mm_movemask_ps(inside) & ValidLaneMask(laneCount);
+		visibleCount = WriteVisibleIndices(mask, base, outIndices, visibleCount);
+	}
+	return visibleCount;
+}
+
+// 視錐台と重なるAABBを求める
+size_t CullAABBs(const Frustum& frustum, const AABB* boxes, size_t count, uint32_t* outIndices) {
+	size_t visibleCount = 0;
+	alignas(16) float minX[kLaneCount], minY[kLaneCount], minZ[kLaneCount];
+	alignas(16) float maxX[kLaneCount], maxY[kLaneCount], maxZ[kLaneCount];
+
+	for (size_t base = 0; base < count; base += kLaneCount) {
+		size_t laneCount = count - base < kLaneCount ? count - base : kLaneCount;
+
+		// SoAに並べ替える(端数は最後の箱で埋める)
+		for (size_t lane = 0; lane < kLaneCount; ++lane) {
+			const AABB& box = boxes[base + (lane < laneCount ? lane : laneCount - 1)];
+			minX[lane] = box.min.x;
+			minY[lane] = box.min.y;
+			minZ[lane] = box.min.z;
+			maxX[lane] = box.max.x;
+			maxY[lane] = box.max.y;
+			maxZ[lane] = box.max.z;
+		}
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Plane& plane : frustum.planes) {
+			// 平面の法線方向に一番遠い頂点が表側にあれば重なっている
+			__m128 px = _mm_load_ps(plane.normal.x >= 0.0f ? maxX : minX);
+			__m128 py = _mm_load_ps(plane.normal.y >= 0.0f ? maxY : minY);
+			__m128 pz = _mm_load_ps(plane.normal.z >= 0.0f ? maxZ : minZ);
+			__m128 distance = _mm_add_ps(
+			    _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(plane.normal.x)), _mm_mul_ps(py, _mm_set1_ps(plane.normal.y))),
+			    _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(plane.normal.z)), _mm_set1_ps(plane.distance)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+		}
+
+		int mask = _mm_movemask_ps(inside) & ValidLaneMask(laneCount);
+		visibleCount = WriteVisibleIndices(mask, base, outIndices, visibleCount);
+	}
+	return visibleCount;
+}
+
+// ビューポート矩形と重なる矩形を求める
+size_t CullRects(const Rect2D& viewport, const Rect2D* rects, size_t count, uint32_t* outIndices) {
+	__m128 viewportLeft = _mm_set1_ps(viewport.left);
+	__m128 viewportTop = _mm_set1_ps(viewport.top);
+	__m128 viewportRight = _mm_set1_ps(viewport.right);
+	__m128 viewportBottom = _mm_set1_ps(viewport.bottom);
+
+	size_t visibleCount = 0;
+	for (size_t base = 0; base < count; base += kLaneCount) {
+		size_t laneCount = count - base < kLaneCount ? count - base : kLaneCount;
+
+		// 4つの矩形を読み込んでSoAに並べ替える(端数は最後の矩形で埋める)
+		__m128 left = _mm_loadu_ps(&rects[base].left);
+		__m128 top = _mm_loadu_ps(&rects[base + (laneCount > 1 ? 1 : 0)].left);
+		__m128 right = _mm_loadu_ps(&rects[base + (laneCount > 2 ? 2 : laneCount - 1)].left);
+		__m128 bottom = _mm_loadu_ps(&rects[base + laneCount - 1].left);
+		_MM_TRANSPOSE4_PS(left, top, right, bottom);
+
+		__m128 inside = _mm_and_ps(
+		    _mm_and_ps(_mm_cmple_ps(left, viewportRight), _mm_cmpge_ps(right, viewportLeft)), _mm_and_ps(_mm_cmple_ps(top, viewportBottom), _mm_cmpge_ps(bottom, viewportTop)));
+
+		int mask = _mm_movemask_ps(inside) & ValidLaneMask(laneCount);
+		visibleCount = WriteVisibleIndices(mask, base, outIndices, visibleCount);
+	}
+	return visibleCount;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "MathTypes.h"
+#include <cstddef>
+#include <cstdint>
+
+// 平面(dot(normal, p) + distance >= 0 が表側)
+struct Plane {
+	Vector3 normal;
+	float distance;
+};
+
+// 視錐台(左・右・下・上・近・遠の6平面)
+struct Frustum {
+	Plane planes[6];
+};
+
+// 軸平行境界ボックス
+struct AABB {
+	Vector3 min;
+	Vector3 max;
+};
+
+// 境界球
+struct BoundingSphere {
+	Vector3 center;
+	float radius;
+};
+
+// 2Dの矩形(スクリーン座標。topはbottomより小さい)
+struct Rect2D {
+	float left;
+	float top;
+	float right;
+	float bottom;
+};
+
+// ビュープロジェクション行列から視錐台の6平面を取り出す
+Frustum MakeFrustum(const Matrix4x4& viewProjection);
+
+// 視錐台と重なる境界球の番号をoutIndicesに詰めて書き込み、その数を返す
+// outIndicesはcount個分の領域が必要
+size_t CullSpheres(const Frustum& frustum, const BoundingSphere* spheres, size_t count, uint32_t* outIndices);
+
+// 視錐台と重なるAABBの番号をoutIndicesに詰めて書き込み、その数を返す
+size_t CullAABBs(const Frustum& frustum, const AABB* boxes, size_t count, uint32_t* outIndices);
+
+// ビューポート矩形と重なる矩形の番号をoutIndicesに詰めて書き込み、その数を返す
+size_t CullRects(const Rect2D& viewport, const Rect2D* rects, size_t count, uint32_t* outIndices);
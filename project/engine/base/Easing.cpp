@@ -0,0 +1,95 @@
+#include "Easing.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+// Backの行き過ぎる量
+constexpr float kBackOvershoot = 1.70158f;
+
+// 跳ねて止まる(放物線を4回つなげる)
+float OutBounce(float t) {
+	const float n = 7.5625f;
+	const float d = 2.75f;
+	if (t < 1.0f / d) {
+		return n * t * t;
+	}
+	if (t < 2.0f / d) {
+		t -= 1.5f / d;
+		return n * t * t + 0.75f;
+	}
+	if (t < 2.5f / d) {
+		t -= 2.25f / d;
+		return n * t * t + 0.9375f;
+	}
+	t -= 2.625f / d;
+	return n * t * t + 0.984375f;
+}
+
+} // namespace
+
+// イージング
+float Ease(EasingType type, float t) {
+	switch (type) {
+	case EasingType::kLinear:
+		return t;
+	case EasingType::kInSine:
+		return 1.0f - std::cos(t * kPi * 0.5f);
+	case EasingType::kOutSine:
+		return std::sin(t * kPi * 0.5f);
+	case EasingType::kInOutSine:
+		return 0.5f - 0.5f * std::cos(t * kPi);
+	case EasingType::kInQuad:
+		return t * t;
+	case EasingType::kOutQuad:
+		return 1.0f - (1.0f - t) * (1.0f - t);
+	case EasingType::kInOutQuad:
+		return t < 0.5f ? 2.0f * t * t : 1.0f - 2.0f * (1.0f - t) * (1.0f - t);
+	case EasingType::kInCubic:
+		return t * t * t;
+	case EasingType::kOutCubic:
+		return 1.0f - (1.0f - t) * (1.0f - t) * (1.0f - t);
+	case EasingType::kInOutCubic:
+		return t < 0.5f ? 4.0f * t * t * t : 1.0f - 4.0f * (1.0f - t) * (1.0f - t) * (1.0f - t);
+	case EasingType::kInBack:
+		return t * t * ((kBackOvershoot + 1.0f) * t - kBackOvershoot);
+	case EasingType::kOutBack: {
+		float u = t - 1.0f;
+		return 1.0f + u * u * ((kBackOvershoot + 1.0f) * u + kBackOvershoot);
+	}
+	case EasingType::kOutElastic:
+		if (t <= 0.0f || t >= 1.0f) {
+			return t <= 0.0f ? 0.0f : 1.0f;
+		}
+		return std::pow(2.0f, -10.0f * t) * std::sin((t * 10.0f - 0.75f) * (2.0f * kPi / 3.0f)) + 1.0f;
+	case EasingType::kOutBounce:
+		return OutBounce(t);
+	default:
+		return t;
+	}
+}
+
+// 焼き込み済みの表
+const EasingTable& EasingTable::GetInstance() {
+	static const EasingTable instance;
+	return instance;
+}
+
+// 全種類を焼き込む
+EasingTable::EasingTable() {
+	for (uint32_t type = 0; type < static_cast<uint32_t>(EasingType::kCount); ++type) {
+		float* samples = samples_ + type * kStride;
+		for (uint32_t i = 0; i < kStride; ++i) {
+			samples[i] = Ease(static_cast<EasingType>(type), static_cast<float>(i) / static_cast<float>(kSampleCount));
+		}
+	}
+}
+
+// 表から求める
+float EasingTable::Evaluate(EasingType type, float t) const {
+	float x = std::clamp(t, 0.0f, 1.0f) * static_cast<float>(kSampleCount);
+	uint32_t i = static_cast<uint32_t>(std::min(x, static_cast<float>(kSampleCount - 1)));
+	const float* samples = samples_ + static_cast<uint32_t>(type) * kStride + i;
+	return samples[0] + (samples[1] - samples[0]) * (x - static_cast<float>(i));
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+// イージングの種類
+enum class EasingType : uint8_t {
+	kLinear,
+	kInSine,
+	kOutSine,
+	kInOutSine,
+	kInQuad,
+	kOutQuad,
+	kInOutQuad,
+	kInCubic,
+	kOutCubic,
+	kInOutCubic,
+	// 少し戻ってから/行き過ぎてから止まる
+	kInBack,
+	kOutBack,
+	// ばねのように揺れて止まる
+	kOutElastic,
+	// 跳ねて止まる
+	kOutBounce,
+
+	kCount,
+};
+
+// イージング(tは0〜1、0で0・1で1になる。Back・Elasticは途中で0〜1を少しはみ出す)
+float Ease(EasingType type, float t);
+
+// イージングを等間隔に焼き込んだ表
+// sin・powを毎回計算せず、表の隣り合う2点を線形補間して求める
+// 全種類を1つの配列に並べるので、種類ごとの先頭はtype * kStride
+// 誤差は折れ目のあるBounceが最大で、値の幅の0.3%以下
+class EasingTable {
+public:
+	// 1種類あたりの区間数
+	static constexpr uint32_t kSampleCount = 256;
+	// 1種類あたりの要素数(両端を含む)
+	static constexpr uint32_t kStride = kSampleCount + 1;
+
+	// 焼き込み済みの表(初めて呼んだときに作る)
+	static const EasingTable& GetInstance();
+
+	// 全種類を並べた表
+	const float* GetData() const { return samples_; }
+
+	// 表から求める(tは0〜1)
+	float Evaluate(EasingType type, float t) const;
+
+private:
+	EasingTable();
+
+	float samples_[static_cast<uint32_t>(EasingType::kCount) * kStride];
+};
@@ -0,0 +1,26 @@
+#include "FastTrig.h"
+
+namespace {
+
+template<bool kPrecise> void SinCosBatchImpl(const float* x, float* outSin, float* outCos, size_t n) {
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128 s, c;
+		FastTrigDetail::SinCos4<kPrecise>(_mm_loadu_ps(x + i), s, c);
+		_mm_storeu_ps(outSin + i, s);
+		_mm_storeu_ps(outCos + i, c);
+	}
+	// 端数
+	for (; i < n; ++i) {
+		__m128 s, c;
+		FastTrigDetail::SinCos4<kPrecise>(_mm_set_ss(x[i]), s, c);
+		outSin[i] = _mm_cvtss_f32(s);
+		outCos[i] = _mm_cvtss_f32(c);
+	}
+}
+
+} // namespace
+
+void SinCosBatch(const float* x, float* outSin, float* outCos, size_t n) { SinCosBatchImpl<true>(x, outSin, outCos, n); }
+
+void SinCosFastBatch(const float* x, float* outSin, float* outCos, size_t n) { SinCosBatchImpl<false>(x, outSin, outCos, n); }
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <emmintrin.h>
+
+// 多項式近似によるsin/cos
+// sinとcosを同時に求め、SSEで4つまとめて計算する
+//
+// 精度は2段階
+//  SinCos     : 3段階の範囲縮約 + 7次/8次多項式。|x| < 8192 で最大誤差 約1e-7(libmと同程度)
+//  SinCosFast : 1段階の範囲縮約 + 5次/6次多項式。|x| <= π で最大誤差 約1e-6、|x| < 100 で約1e-5(アニメーション・パーティクル向け)
+// どちらもNaN・無限大は考慮しない
+
+namespace FastTrigDetail {
+
+// π/2を3つに分けたもの(Cody-Waite法の範囲縮約用)
+constexpr float kHalfPiPart1 = 1.5703125f;
+constexpr float kHalfPiPart2 = 4.837512969970703125e-4f;
+constexpr float kHalfPiPart3 = 7.54978995489188216e-8f;
+constexpr float kHalfPi = 1.57079632679489661923f;
+constexpr float kTwoOverPi = 0.63661977236758134308f;
+
+// xをπ/2単位の象限と[-π/4, π/4]の余りに分ける
+template<bool kPrecise> inline __m128 Reduce(__m128 x, __m128i& quadrant) {
+	// cvtps_epi32は最近接偶数丸め
+	quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kTwoOverPi)));
+	__m128 q = _mm_cvtepi32_ps(quadrant);
+	if constexpr (kPrecise) {
+		x = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(kHalfPiPart1)));
+		x = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(kHalfPiPart2)));
+		x = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(kHalfPiPart3)));
+	} else {
+		x = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(kHalfPi)));
+	}
+	return x;
+}
+
+// [-π/4, π/4]でのsinの多項式
+template<bool kPrecise> inline __m128 SinPoly(__m128 r, __m128 r2) {
+	__m128 p;
+	if constexpr (kPrecise) {
+		p = _mm_set1_ps(-1.9515295891e-4f);
+		p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(8.3321608736e-3f));
+		p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(-1.6666654611e-1f));
+	} else {
+		p = _mm_set1_ps(8.15297158e-3f);
+		p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(-1.66628329e-1f));
+	}
+	return _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(p, r2), r));
+}
+
+// [-π/4, π/4]でのcosの多項式
+template<bool kPrecise> inline __m128 CosPoly(__m128 r2) {
+	__m128 p;
+	if constexpr (kPrecise) {
+		p = _mm_set1_ps(2.443315711809948e-5f);
+		p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(-1.388731625493765e-3f));
+		p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(4.166664568298827e-2f));
+		p = _mm_mul_ps(_mm_mul_ps(p, r2), r2);
+		return _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, _mm_set1_ps(0.5f))), p);
+	} else {
+		p = _mm_set1_ps(-1.35978005e-3f);
+		p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(4.1656293e-2f));
+		p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(-4.99998948e-1f));
+		return _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(p, r2));
+	}
+}
+
+template<bool kPrecise> inline void SinCos4(__m128 x, __m128& outSin, __m128& outCos) {
+	__m128i quadrant;
+	__m128 r = Reduce<kPrecise>(x, quadrant);
+	__m128 r2 = _mm_mul_ps(r, r);
+	__m128 s = SinPoly<kPrecise>(r, r2);
+	__m128 c = CosPoly<kPrecise>(r2);
+
+	// 奇数象限はsinとcosが入れ替わる
+	__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	__m128 sinResult = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+	__m128 cosResult = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+	// 符号 sin:象限2,3で反転 cos:象限1,2で反転
+	__m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+	__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+	outSin = _mm_xor_ps(sinResult, sinSign);
+	outCos = _mm_xor_ps(cosResult, cosSign);
+}
+
+} // namespace FastTrigDetail
+
+// 4要素のsin/cos
+inline void SinCos4(__m128 x, __m128& outSin, __m128& outCos) { FastTrigDetail::SinCos4<true>(x, outSin, outCos); }
+inline void SinCos4Fast(__m128 x, __m128& outSin, __m128& outCos) { FastTrigDetail::SinCos4<false>(x, outSin, outCos); }
+
+// 1要素のsin/cos
+inline void SinCos(float x, float& outSin, float& outCos) {
+	__m128 s, c;
+	SinCos4(_mm_set_ss(x), s, c);
+	outSin = _mm_cvtss_f32(s);
+	outCos = _mm_cvtss_f32(c);
+}
+inline void SinCosFast(float x, float& outSin, float& outCos) {
+	__m128 s, c;
+	SinCos4Fast(_mm_set_ss(x), s, c);
+	outSin = _mm_cvtss_f32(s);
+	outCos = _mm_cvtss_f32(c);
+}
+
+// 配列をまとめて計算する版
+void SinCosBatch(const float* x, float* outSin, float* outCos, size_t n);
+void SinCosFastBatch(const float* x, float* outSin, float* outCos, size_t n);
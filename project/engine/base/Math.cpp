@@ -1,9 +1,191 @@
 #include "Math.h"
+#include "FastTrig.h"
 #include <cmath>
 #include "assert.h"
+#include <emmintrin.h>
 
+namespace {
 
+// 行列の1行をSSEレジスタに読み込む
+inline __m128 LoadRow(const Matrix4x4& m, int row) { return _mm_loadu_ps(m.m[row]); }
+
+// SSEレジスタを行列の1行に書き込む
+inline void StoreRow(Matrix4x4& m, int row, __m128 v) { _mm_storeu_ps(m.m[row], v); }
+
+// 1行 × 行列 (行ベクトル規約)
+inline __m128 MultiplyRow(__m128 row, __m128 r0, __m128 r1, __m128 r2, __m128 r3) {
+	__m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+	return result;
+}
+
+// 2x2行列(xyzw = m00,m01,m10,m11)の積 A*B
+inline __m128 Mat2Mul(__m128 a, __m128 b) {
+	return _mm_add_ps(
+	    _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))), _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+// 2x2行列の余因子行列との積 adj(A)*B
+inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+	return _mm_sub_ps(
+	    _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b), _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+// 2x2行列と余因子行列との積 A*adj(B)
+inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+	return _mm_sub_ps(
+	    _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))), _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+// X→Y→Zの順で合成した回転行列の3行を直接求める
+void MakeRotateXYZRows(const Vector3& rot, float r[3][3]) {
+	// 3軸分のsin/cosを1回で求める
+	alignas(16) float sinValues[4], cosValues[4];
+	__m128 s, c;
+	SinCos4(_mm_setr_ps(rot.x, rot.y, rot.z, 0.0f), s, c);
+	_mm_store_ps(sinValues, s);
+	_mm_store_ps(cosValues, c);
+	float sx = sinValues[0], sy = sinValues[1], sz = sinValues[2];
+	float cx = cosValues[0], cy = cosValues[1], cz = cosValues[2];
+
+	r[0][0] = cy * cz;
+	r[0][1] = cy * sz;
+	r[0][2] = -sy;
+	r[1][0] = sx * sy * cz - cx * sz;
+	r[1][1] = sx * sy * sz + cx * cz;
+	r[1][2] = sx * cy;
+	r[2][0] = cx * sy * cz + sx * sz;
+	r[2][1] = cx * sy * sz - sx * cz;
+	r[2][2] = cx * cy;
+}
+
+} // namespace
+
+// 行列の積(SSE)
 Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+	__m128 r0 = LoadRow(m2, 0);
+	__m128 r1 = LoadRow(m2, 1);
+	__m128 r2 = LoadRow(m2, 2);
+	__m128 r3 = LoadRow(m2, 3);
+
+	Matrix4x4 result;
+	for (int row = 0; row < 4; ++row) {
+		StoreRow(result, row, MultiplyRow(LoadRow(m1, row), r0, r1, r2, r3));
+	}
+	return result;
+}
+
+// 行列の積をまとめて計算する
+void MultiplyBatch(const Matrix4x4* a, const Matrix4x4* b, Matrix4x4* out, size_t n) {
+	for (size_t i = 0; i < n; ++i) {
+		out[i] = Multiply(a[i], b[i]);
+	}
+}
+
+// 全ての行列に同じ行列を右から掛ける(WVPの計算など)
+void MultiplyBatch(const Matrix4x4* a, const Matrix4x4& b, Matrix4x4* out, size_t n) {
+	__m128 r0 = LoadRow(b, 0);
+	__m128 r1 = LoadRow(b, 1);
+	__m128 r2 = LoadRow(b, 2);
+	__m128 r3 = LoadRow(b, 3);
+
+	for (size_t i = 0; i < n; ++i) {
+		__m128 a0 = LoadRow(a[i], 0);
+		__m128 a1 = LoadRow(a[i], 1);
+		__m128 a2 = LoadRow(a[i], 2);
+		__m128 a3 = LoadRow(a[i], 3);
+		StoreRow(out[i], 0, MultiplyRow(a0, r0, r1, r2, r3));
+		StoreRow(out[i], 1, MultiplyRow(a1, r0, r1, r2, r3));
+		StoreRow(out[i], 2, MultiplyRow(a2, r0, r1, r2, r3));
+		StoreRow(out[i], 3, MultiplyRow(a3, r0, r1, r2, r3));
+	}
+}
+
+// 逆行列(SSE)
+// 4x4を2x2のブロックに分けて計算する
+Matrix4x4 Inverse(const Matrix4x4& m) {
+	__m128 row0 = LoadRow(m, 0);
+	__m128 row1 = LoadRow(m, 1);
+	__m128 row2 = LoadRow(m, 2);
+	__m128 row3 = LoadRow(m, 3);
+
+	// 2x2のブロック
+	__m128 a = _mm_movelh_ps(row0, row1);
+	__m128 b = _mm_movehl_ps(row1, row0);
+	__m128 c = _mm_movelh_ps(row2, row3);
+	__m128 d = _mm_movehl_ps(row3, row2);
+
+	// 各ブロックの行列式
+	__m128 detSub = _mm_sub_ps(
+	    _mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1))),
+	    _mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0))));
+	__m128 detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2));
+	__m128 detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+	__m128 dc = Mat2AdjMul(d, c);
+	__m128 ab = Mat2AdjMul(a, b);
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+	// 全体の行列式
+	__m128 determinant = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+	__m128 trace = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)));
+	trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+	trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+	determinant = _mm_sub_ps(determinant, trace);
+
+	assert(_mm_cvtss_f32(determinant) != 0);
+
+	__m128 determinantRecp = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+	x = _mm_mul_ps(x, determinantRecp);
+	y = _mm_mul_ps(y, determinantRecp);
+	z = _mm_mul_ps(z, determinantRecp);
+	w = _mm_mul_ps(w, determinantRecp);
+
+	Matrix4x4 result;
+	StoreRow(result, 0, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+	StoreRow(result, 1, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+	StoreRow(result, 2, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+	StoreRow(result, 3, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+	return result;
+}
+
+// 逆行列をまとめて計算する
+void InverseBatch(const Matrix4x4* m, Matrix4x4* out, size_t n) {
+	for (size_t i = 0; i < n; ++i) {
+		out[i] = Inverse(m[i]);
+	}
+}
+
+// アフィン変換行列の作成(SSE)
+// 回転行列は合成済みの式から直接求め、拡縮は行ごとに掛ける
+Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rot, const Vector3& translate) {
+	float r[3][3];
+	MakeRotateXYZRows(rot, r);
+
+	Matrix4x4 result;
+	StoreRow(result, 0, _mm_mul_ps(_mm_set1_ps(scale.x), _mm_setr_ps(r[0][0], r[0][1], r[0][2], 0.0f)));
+	StoreRow(result, 1, _mm_mul_ps(_mm_set1_ps(scale.y), _mm_setr_ps(r[1][0], r[1][1], r[1][2], 0.0f)));
+	StoreRow(result, 2, _mm_mul_ps(_mm_set1_ps(scale.z), _mm_setr_ps(r[2][0], r[2][1], r[2][2], 0.0f)));
+	StoreRow(result, 3, _mm_setr_ps(translate.x, translate.y, translate.z, 1.0f));
+	return result;
+}
+
+// アフィン変換行列をまとめて作成する
+void MakeAffineMatrixBatch(const Transform* transforms, Matrix4x4* out, size_t n) {
+	for (size_t i = 0; i < n; ++i) {
+		out[i] = MakeAffineMatrix(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+	}
+}
+
+// 行列の積(スカラー版。SIMD版の検証用)
+Matrix4x4 MultiplyScalar(const Matrix4x4& m1, const Matrix4x4& m2) {
 	Matrix4x4 result{};
 	for (int row = 0; row < 4; ++row) {
 		for (int col = 0; col < 4; ++col) {
@@ -19,8 +201,8 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
 
 
 
-// 逆行列
-Matrix4x4 Inverse(const Matrix4x4& m) {
+// 逆行列(スカラー版。SIMD版の検証用)
+Matrix4x4 InverseScalar(const Matrix4x4& m) {
 
 	Matrix4x4 result{};
 
@@ -117,56 +299,8 @@ Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip
 }
 
 
-// ビューポート変換行列
-Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth) {
-
-	Matrix4x4 result = {};
-	result.m[0][0] = width / 2;
-	result.m[0][1] = 0;
-	result.m[0][2] = 0;
-	result.m[0][3] = 0;
-	result.m[1][0] = 0;
-	result.m[1][1] = -height / 2;
-	result.m[1][2] = 0;
-	result.m[1][3] = 0;
-	result.m[2][0] = 0;
-	result.m[2][1] = 0;
-	result.m[2][2] = maxDepth - minDepth;
-	result.m[2][3] = 0;
-	result.m[3][0] = left + width / 2;
-	result.m[3][1] = top + height / 2;
-	result.m[3][2] = minDepth;
-	result.m[3][3] = 1;
-	return result;
-}
-
-// 単位行列の作成
-Matrix4x4 MakeIdentity4x4() {
-
-	Matrix4x4 result{};
-
-	result.m[0][0] = 1;
-	result.m[0][1] = 0;
-	result.m[0][2] = 0;
-	result.m[0][3] = 0;
-	result.m[1][0] = 0;
-	result.m[1][1] = 1;
-	result.m[1][2] = 0;
-	result.m[1][3] = 0;
-	result.m[2][0] = 0;
-	result.m[2][1] = 0;
-	result.m[2][2] = 1;
-	result.m[2][3] = 0;
-	result.m[3][0] = 0;
-	result.m[3][1] = 0;
-	result.m[3][2] = 0;
-	result.m[3][3] = 1;
-
-	return result;
-}
-
-// アフィン変換行列の作成
-Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rot, const Vector3& translate) {
+// アフィン変換行列の作成(スカラー版。SIMD版の検証用)
+Matrix4x4 MakeAffineMatrixScalar(const Vector3& scale, const Vector3& rot, const Vector3& translate) {
 
 	Matrix4x4 result{};
 
@@ -247,7 +381,7 @@ Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rot, const Vecto
 
 	// X、Y、Z軸回転行列の合成（Z→Y→X）
 	Matrix4x4 rotateMatrixXYZ = {};
-	rotateMatrixXYZ = Multiply(rotateMatrixX, Multiply(rotateMatrixY, rotateMatrixZ));
+	rotateMatrixXYZ = MultiplyScalar(rotateMatrixX, MultiplyScalar(rotateMatrixY, rotateMatrixZ));
 
 	Matrix4x4 translateMatrix = {};
 	translateMatrix.m[0][0] = 1;
@@ -267,64 +401,379 @@ Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rot, const Vecto
 	translateMatrix.m[3][2] = translate.z;
 	translateMatrix.m[3][3] = 1;
 
-	result = Multiply(scaleMatrix, Multiply(rotateMatrixXYZ, translateMatrix));
+	result = MultiplyScalar(scaleMatrix, MultiplyScalar(rotateMatrixXYZ, translateMatrix));
 
 	return result;
 }
 
 
-// 正射影行列
-Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip) {
-
+Matrix4x4 MakeRotateZMatrix(float angle) {
 	Matrix4x4 result = {};
-	result.m[0][0] = 2 / (right - left);
-	result.m[0][1] = 0;
-	result.m[0][2] = 0;
-	result.m[0][3] = 0;
-	result.m[1][0] = 0;
-	result.m[1][1] = 2 / (top - bottom);
-	result.m[1][2] = 0;
-	result.m[1][3] = 0;
-	result.m[2][0] = 0;
-	result.m[2][1] = 0;
-	result.m[2][2] = 1 / (farClip - nearClip);
-	result.m[2][3] = 0;
-	result.m[3][0] = (left + right) / (left - right);
-	result.m[3][1] = (top + bottom) / (bottom - top);
-	result.m[3][2] = nearClip / (nearClip - farClip);
-	result.m[3][3] = 1;
+	float radians = angle * (3.14159265359f / 180.0f); // Convert degrees to radians
+	float s, c;
+	SinCos(radians, s, c);
+	result.m[0][0] = c;
+	result.m[0][1] = -s;
+	result.m[1][0] = s;
+	result.m[1][1] = c;
+	result.m[2][2] = 1.0f;
+	result.m[3][3] = 1.0f;
+	return result;
+}
+
+// アフィン変換の作成
+AffineTransform MakeAffineTransform(const Vector3& scale, const Vector3& rot, const Vector3& translate) {
+	float r[3][3];
+	MakeRotateXYZRows(rot, r);
+
+	AffineTransform result;
+	const float s[3] = {scale.x, scale.y, scale.z};
+	for (int row = 0; row < 3; ++row) {
+		result.m[row][0] = s[row] * r[row][0];
+		result.m[row][1] = s[row] * r[row][1];
+		result.m[row][2] = s[row] * r[row][2];
+	}
+	result.m[3][0] = translate.x;
+	result.m[3][1] = translate.y;
+	result.m[3][2] = translate.z;
 	return result;
 }
 
-Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
-	Matrix4x4 matrix = {};
-	matrix.m[0][0] = scale.x;
-	matrix.m[1][1] = scale.y;
-	matrix.m[2][2] = scale.z;
-	matrix.m[3][3] = 1.0f;
-	return matrix;
+// アフィン変換の合成(a1を適用してからa2を適用する。Multiply(a1, a2)と同じ)
+AffineTransform Compose(const AffineTransform& a1, const AffineTransform& a2) {
+	AffineTransform result;
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 3; ++col) {
+			result.m[row][col] = a1.m[row][0] * a2.m[0][col] + a1.m[row][1] * a2.m[1][col] + a1.m[row][2] * a2.m[2][col];
+		}
+	}
+	// 平行移動の行だけa2の平行移動を足す
+	result.m[3][0] += a2.m[3][0];
+	result.m[3][1] += a2.m[3][1];
+	result.m[3][2] += a2.m[3][2];
+	return result;
 }
 
-Matrix4x4 MakeRotateZMatrix(float angle) {
-	Matrix4x4 result = {};
-	float radians = angle * (3.14159265359f / 180.0f); // Convert degrees to radians
-	result.m[0][0] = std::cos(radians);
-	result.m[0][1] = -std::sin(radians);
-	result.m[1][0] = std::sin(radians);
-	result.m[1][1] = std::cos(radians);
-	result.m[2][2] = 1.0f;
+// アフィン変換の逆変換
+// 3x3部分を余因子で逆行列にし、平行移動はその逆行列で戻す
+AffineTransform Inverse(const AffineTransform& a) {
+	const float(&m)[4][3] = a.m;
+
+	// 余因子
+	float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+
+	float determinant = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+	assert(determinant != 0);
+	float determinantRecp = 1.0f / determinant;
+
+	AffineTransform result;
+	result.m[0][0] = c00 * determinantRecp;
+	result.m[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * determinantRecp;
+	result.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * determinantRecp;
+	result.m[1][0] = c01 * determinantRecp;
+	result.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * determinantRecp;
+	result.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * determinantRecp;
+	result.m[2][0] = c02 * determinantRecp;
+	result.m[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * determinantRecp;
+	result.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * determinantRecp;
+
+	// 平行移動 = -t * 逆行列
+	for (int col = 0; col < 3; ++col) {
+		result.m[3][col] = -(m[3][0] * result.m[0][col] + m[3][1] * result.m[1][col] + m[3][2] * result.m[2][col]);
+	}
+	return result;
+}
+
+// 点の変換(平行移動を含む)
+Vector3 TransformPoint(const Vector3& point, const AffineTransform& a) {
+	return {
+	    point.x * a.m[0][0] + point.y * a.m[1][0] + point.z * a.m[2][0] + a.m[3][0],
+	    point.x * a.m[0][1] + point.y * a.m[1][1] + point.z * a.m[2][1] + a.m[3][1],
+	    point.x * a.m[0][2] + point.y * a.m[1][2] + point.z * a.m[2][2] + a.m[3][2],
+	};
+}
+
+// 方向の変換(平行移動を含まない)
+Vector3 TransformDirection(const Vector3& direction, const AffineTransform& a) {
+	return {
+	    direction.x * a.m[0][0] + direction.y * a.m[1][0] + direction.z * a.m[2][0],
+	    direction.x * a.m[0][1] + direction.y * a.m[1][1] + direction.z * a.m[2][1],
+	    direction.x * a.m[0][2] + direction.y * a.m[1][2] + direction.z * a.m[2][2],
+	};
+}
+
+// 4x4行列に変換
+Matrix4x4 ToMatrix4x4(const AffineTransform& a) {
+	Matrix4x4 result;
+	for (int row = 0; row < 4; ++row) {
+		result.m[row][0] = a.m[row][0];
+		result.m[row][1] = a.m[row][1];
+		result.m[row][2] = a.m[row][2];
+		result.m[row][3] = 0.0f;
+	}
 	result.m[3][3] = 1.0f;
 	return result;
 }
 
-Matrix4x4 MakeTranslateMatrix(const Vector3& translate) {
-	Matrix4x4 matrix = {};
-	matrix.m[0][0] = 1.0f;
-	matrix.m[1][1] = 1.0f;
-	matrix.m[2][2] = 1.0f;
-	matrix.m[3][3] = 1.0f;
-	matrix.m[3][0] = translate.x;
-	matrix.m[3][1] = translate.y;
-	matrix.m[3][2] = translate.z;
-	return matrix;
-}
\ No newline at end of file
+// 4x4行列から変換(4列目は(0,0,0,1)であること)
+AffineTransform ToAffineTransform(const Matrix4x4& m) {
+	assert(m.m[0][3] == 0.0f && m.m[1][3] == 0.0f && m.m[2][3] == 0.0f && m.m[3][3] == 1.0f);
+	AffineTransform result;
+	for (int row = 0; row < 4; ++row) {
+		result.m[row][0] = m.m[row][0];
+		result.m[row][1] = m.m[row][1];
+		result.m[row][2] = m.m[row][2];
+	}
+	return result;
+}
+
+
+// 単位クォータニオン
+Quaternion MakeIdentityQuaternion() { return {0.0f, 0.0f, 0.0f, 1.0f}; }
+
+// 任意軸回転のクォータニオン(axisは正規化済みであること)
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle) {
+	float s, c;
+	SinCos(angle * 0.5f, s, c);
+	return {axis.x * s, axis.y * s, axis.z * s, c};
+}
+
+// オイラー角(MakeAffineMatrixと同じX→Y→Zの順)からクォータニオンを作る
+Quaternion MakeEulerQuaternion(const Vector3& rot) {
+	alignas(16) float sinValues[4], cosValues[4];
+	__m128 s, c;
+	SinCos4(_mm_setr_ps(rot.x * 0.5f, rot.y * 0.5f, rot.z * 0.5f, 0.0f), s, c);
+	_mm_store_ps(sinValues, s);
+	_mm_store_ps(cosValues, c);
+	float sx = sinValues[0], sy = sinValues[1], sz = sinValues[2];
+	float cx = cosValues[0], cy = cosValues[1], cz = cosValues[2];
+
+	// qz * qy * qx を展開したもの
+	return {
+	    sx * cy * cz - cx * sy * sz,
+	    cx * sy * cz + sx * cy * sz,
+	    cx * cy * sz - sx * sy * cz,
+	    cx * cy * cz + sx * sy * sz,
+	};
+}
+
+// クォータニオンの積(q2を適用してからq1を適用する)
+Quaternion Multiply(const Quaternion& q1, const Quaternion& q2) {
+	return {
+	    q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y,
+	    q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x,
+	    q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w,
+	    q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z,
+	};
+}
+
+// 共役クォータニオン
+Quaternion Conjugate(const Quaternion& q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+// 内積
+float Dot(const Quaternion& q1, const Quaternion& q2) { return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w; }
+
+// 正規化
+Quaternion Normalize(const Quaternion& q) {
+	float length = std::sqrt(Dot(q, q));
+	if (length == 0.0f) {
+		return MakeIdentityQuaternion();
+	}
+	float lengthRecp = 1.0f / length;
+	return {q.x * lengthRecp, q.y * lengthRecp, q.z * lengthRecp, q.w * lengthRecp};
+}
+
+// 逆クォータニオン
+Quaternion Inverse(const Quaternion& q) {
+	float normSq = Dot(q, q);
+	assert(normSq != 0);
+	float normSqRecp = 1.0f / normSq;
+	return {-q.x * normSqRecp, -q.y * normSqRecp, -q.z * normSqRecp, q.w * normSqRecp};
+}
+
+// 正規化線形補間
+// 近い方の回転を通るように符号を揃える
+Quaternion Nlerp(const Quaternion& q1, const Quaternion& q2, float t) {
+	float sign = Dot(q1, q2) < 0.0f ? -1.0f : 1.0f;
+	float t1 = 1.0f - t;
+	float t2 = t * sign;
+	return Normalize({q1.x * t1 + q2.x * t2, q1.y * t1 + q2.y * t2, q1.z * t1 + q2.z * t2, q1.w * t1 + q2.w * t2});
+}
+
+// 球面線形補間
+Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t) {
+	float dot = Dot(q1, q2);
+	float sign = 1.0f;
+	if (dot < 0.0f) {
+		dot = -dot;
+		sign = -1.0f;
+	}
+
+	// ほぼ同じ向きならNlerpで十分
+	const float kEpsilon = 0.9995f;
+	if (dot > kEpsilon) {
+		return Nlerp(q1, q2, t);
+	}
+
+	float theta = std::acos(dot);
+	float sinThetaRecp = 1.0f / std::sin(theta);
+	float t1 = std::sin((1.0f - t) * theta) * sinThetaRecp;
+	float t2 = std::sin(t * theta) * sinThetaRecp * sign;
+	return {q1.x * t1 + q2.x * t2, q1.y * t1 + q2.y * t2, q1.z * t1 + q2.z * t2, q1.w * t1 + q2.w * t2};
+}
+
+// ベクトルの回転
+Vector3 RotateVector(const Vector3& vector, const Quaternion& q) {
+	// v' = v + 2w(u×v) + 2u×(u×v)
+	Vector3 u = {q.x, q.y, q.z};
+	Vector3 uv = Cross(u, vector);
+	Vector3 uuv = Cross(u, uv);
+	return vector + (uv * q.w + uuv) * 2.0f;
+}
+
+// クォータニオンから回転行列を作る(正規化済みであること)
+Matrix4x4 MakeRotateMatrix(const Quaternion& q) {
+	float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+	float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+	float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+	Matrix4x4 result;
+	StoreRow(result, 0, _mm_setr_ps(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f));
+	StoreRow(result, 1, _mm_setr_ps(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f));
+	StoreRow(result, 2, _mm_setr_ps(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f));
+	StoreRow(result, 3, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+	return result;
+}
+
+// アフィン変換行列の作成(クォータニオン版)
+// 三角関数を使わずに回転行列を作れる
+Matrix4x4 MakeAffineMatrixQuaternion(const Vector3& scale, const Quaternion& rotate, const Vector3& translate) {
+	Matrix4x4 result = MakeRotateMatrix(rotate);
+	StoreRow(result, 0, _mm_mul_ps(_mm_set1_ps(scale.x), LoadRow(result, 0)));
+	StoreRow(result, 1, _mm_mul_ps(_mm_set1_ps(scale.y), LoadRow(result, 1)));
+	StoreRow(result, 2, _mm_mul_ps(_mm_set1_ps(scale.z), LoadRow(result, 2)));
+	StoreRow(result, 3, _mm_setr_ps(translate.x, translate.y, translate.z, 1.0f));
+	return result;
+}
+
+// 法線変換用の行列(Worldの3x3部分の逆転置行列)
+Matrix3x3 MakeNormalMatrix(const Matrix4x4& world) {
+	const auto& m = world.m;
+	// 余因子行列 / 行列式 = 逆行列の転置
+	float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+	float det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+
+	Matrix3x3 result;
+	// 潰れている(拡縮0)場合は逆行列がないのでそのまま返す
+	if (det == 0.0f) {
+		for (int row = 0; row < 3; ++row) {
+			result.m[row][0] = m[row][0];
+			result.m[row][1] = m[row][1];
+			result.m[row][2] = m[row][2];
+		}
+		return result;
+	}
+	float invDet = 1.0f / det;
+	result.m[0][0] = c00 * invDet;
+	result.m[0][1] = c01 * invDet;
+	result.m[0][2] = c02 * invDet;
+	result.m[1][0] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+	result.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+	result.m[1][2] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+	result.m[2][0] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+	result.m[2][1] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+	result.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+	return result;
+}
+
+// 法線変換用の行列をまとめて計算する(SSEで4つずつ)
+void MakeNormalMatrixBatch(const Matrix4x4* worlds, const uint8_t* isUniformScale, Matrix3x3* out, size_t n) {
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		const Matrix4x4* w = worlds + i;
+
+		// 均一スケールならWorldの3x3をそのまま使う
+		int uniformMask = 0;
+		if (isUniformScale) {
+			uniformMask = (isUniformScale[i] ? 1 : 0) | (isUniformScale[i + 1] ? 2 : 0) | (isUniformScale[i + 2] ? 4 : 0) | (isUniformScale[i + 3] ? 8 : 0);
+		}
+		if (uniformMask == 0xF) {
+			for (size_t lane = 0; lane < 4; ++lane) {
+				for (int row = 0; row < 3; ++row) {
+					out[i + lane].m[row][0] = w[lane].m[row][0];
+					out[i + lane].m[row][1] = w[lane].m[row][1];
+					out[i + lane].m[row][2] = w[lane].m[row][2];
+				}
+			}
+			continue;
+		}
+
+		// 要素ごとに4行列分を並べる
+		__m128 m[3][3];
+		for (int row = 0; row < 3; ++row) {
+			for (int column = 0; column < 3; ++column) {
+				m[row][column] = _mm_setr_ps(w[0].m[row][column], w[1].m[row][column], w[2].m[row][column], w[3].m[row][column]);
+			}
+		}
+		auto det2 = [](__m128 a, __m128 b, __m128 c, __m128 d) { return _mm_sub_ps(_mm_mul_ps(a, b), _mm_mul_ps(c, d)); };
+
+		__m128 c[3][3];
+		c[0][0] = det2(m[1][1], m[2][2], m[1][2], m[2][1]);
+		c[0][1] = det2(m[1][2], m[2][0], m[1][0], m[2][2]);
+		c[0][2] = det2(m[1][0], m[2][1], m[1][1], m[2][0]);
+		c[1][0] = det2(m[0][2], m[2][1], m[0][1], m[2][2]);
+		c[1][1] = det2(m[0][0], m[2][2], m[0][2], m[2][0]);
+		c[1][2] = det2(m[0][1], m[2][0], m[0][0], m[2][1]);
+		c[2][0] = det2(m[0][1], m[1][2], m[0][2], m[1][1]);
+		c[2][1] = det2(m[0][2], m[1][0], m[0][0], m[1][2]);
+		c[2][2] = det2(m[0][0], m[1][1], m[0][1], m[1][0]);
+		__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][0], c[0][0]), _mm_mul_ps(m[0][1], c[0][1])), _mm_mul_ps(m[0][2], c[0][2]));
+		__m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+		// 均一スケールの要素と潰れている要素はWorldの3x3を選ぶ
+		__m128 uniform = _mm_castsi128_ps(_mm_setr_epi32(uniformMask & 1 ? -1 : 0, uniformMask & 2 ? -1 : 0, uniformMask & 4 ? -1 : 0, uniformMask & 8 ? -1 : 0));
+		uniform = _mm_or_ps(uniform, _mm_cmpeq_ps(det, _mm_setzero_ps()));
+		alignas(16) float result[3][3][4];
+		for (int row = 0; row < 3; ++row) {
+			for (int column = 0; column < 3; ++column) {
+				__m128 inverseTranspose = _mm_mul_ps(c[row][column], invDet);
+				_mm_store_ps(result[row][column], _mm_or_ps(_mm_and_ps(uniform, m[row][column]), _mm_andnot_ps(uniform, inverseTranspose)));
+			}
+		}
+		for (size_t lane = 0; lane < 4; ++lane) {
+			for (int row = 0; row < 3; ++row) {
+				for (int column = 0; column < 3; ++column) {
+					out[i + lane].m[row][column] = result[row][column][lane];
+				}
+			}
+		}
+	}
+
+	// 端数
+	for (; i < n; ++i) {
+		if (isUniformScale && isUniformScale[i]) {
+			for (int row = 0; row < 3; ++row) {
+				out[i].m[row][0] = worlds[i].m[row][0];
+				out[i].m[row][1] = worlds[i].m[row][1];
+				out[i].m[row][2] = worlds[i].m[row][2];
+			}
+		} else {
+			out[i] = MakeNormalMatrix(worlds[i]);
+		}
+	}
+}
+
+// 4x4行列に変換(3x3の部分以外は単位行列)
+Matrix4x4 ToMatrix4x4(const Matrix3x3& m) {
+	Matrix4x4 result = kIdentity4x4;
+	for (int row = 0; row < 3; ++row) {
+		result.m[row][0] = m.m[row][0];
+		result.m[row][1] = m.m[row][1];
+		result.m[row][2] = m.m[row][2];
+	}
+	return result;
+}
@@ -1,17 +1,61 @@
 #pragma once
 #include "MathTypes.h"
+#include "MathConstexpr.h"
+#include <cstddef>
+#include <cstdint>
 
 
 Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
 Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
 Matrix4x4 Inverse(const Matrix4x4& m);
-Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
-Matrix4x4 MakeIdentity4x4();
 Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rot, const Vector3& translate);
-Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip);
-Matrix4x4 MakeScaleMatrix(const Vector3& scale);
 Matrix4x4 MakeRotateZMatrix(float angle);
-Matrix4x4 MakeTranslateMatrix(const Vector3& translate);
+
+// 配列をまとめて計算する版
+void MultiplyBatch(const Matrix4x4* a, const Matrix4x4* b, Matrix4x4* out, size_t n);
+void MultiplyBatch(const Matrix4x4* a, const Matrix4x4& b, Matrix4x4* out, size_t n);
+void InverseBatch(const Matrix4x4* m, Matrix4x4* out, size_t n);
+void MakeAffineMatrixBatch(const Transform* transforms, Matrix4x4* out, size_t n);
+
+// スカラー版(SIMD版の検証用)
+Matrix4x4 MultiplyScalar(const Matrix4x4& m1, const Matrix4x4& m2);
+Matrix4x4 InverseScalar(const Matrix4x4& m);
+Matrix4x4 MakeAffineMatrixScalar(const Vector3& scale, const Vector3& rot, const Vector3& translate);
+
+// アフィン変換(3x4)専用の計算
+AffineTransform MakeAffineTransform(const Vector3& scale, const Vector3& rot, const Vector3& translate);
+AffineTransform Compose(const AffineTransform& a1, const AffineTransform& a2);
+AffineTransform Inverse(const AffineTransform& a);
+Vector3 TransformPoint(const Vector3& point, const AffineTransform& a);
+Vector3 TransformDirection(const Vector3& direction, const AffineTransform& a);
+Matrix4x4 ToMatrix4x4(const AffineTransform& a);
+AffineTransform ToAffineTransform(const Matrix4x4& m);
+
+// クォータニオン
+Quaternion MakeIdentityQuaternion();
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle);
+Quaternion MakeEulerQuaternion(const Vector3& rot);
+Quaternion Multiply(const Quaternion& q1, const Quaternion& q2);
+Quaternion Conjugate(const Quaternion& q);
+Quaternion Normalize(const Quaternion& q);
+Quaternion Inverse(const Quaternion& q);
+float Dot(const Quaternion& q1, const Quaternion& q2);
+Quaternion Nlerp(const Quaternion& q1, const Quaternion& q2, float t);
+Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t);
+Vector3 RotateVector(const Vector3& vector, const Quaternion& q);
+Matrix4x4 MakeRotateMatrix(const Quaternion& q);
+// (オイラー角版と名前を分けているのは、{0,0,0}のような波括弧の引数がVector3にもQuaternionにもなって呼び分けられなくなるため)
+Matrix4x4 MakeAffineMatrixQuaternion(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+
+// 法線変換用の行列(Worldの3x3部分の逆転置行列)
+// 拡縮が不均一でも法線が面に垂直なまま変換できる
+Matrix3x3 MakeNormalMatrix(const Matrix4x4& world);
+// まとめて計算する版
+// isUniformScale[i]が0以外の要素は逆行列を求めず、Worldの3x3をそのまま返す
+// (均一スケールなら向きは同じなので、シェーダーで正規化すれば結果は変わらない)
+// isUniformScaleはnullptrでもよい
+void MakeNormalMatrixBatch(const Matrix4x4* worlds, const uint8_t* isUniformScale, Matrix3x3* out, size_t n);
+Matrix4x4 ToMatrix4x4(const Matrix3x3& m);
 
 class Math {
 
@@ -0,0 +1,179 @@
+#pragma once
+#include "MathTypes.h"
+#include <cmath>
+#include <type_traits>
+
+// コンパイル時にも計算できる演算子と行列作成関数
+// 定数の行列(単位行列や画面サイズ固定の正射影行列)はコンパイル時に計算される
+
+// ==============================
+// Vector2
+// ==============================
+constexpr Vector2 operator+(const Vector2& v1, const Vector2& v2) { return {v1.x + v2.x, v1.y + v2.y}; }
+constexpr Vector2 operator-(const Vector2& v1, const Vector2& v2) { return {v1.x - v2.x, v1.y - v2.y}; }
+constexpr Vector2 operator*(const Vector2& v, float s) { return {v.x * s, v.y * s}; }
+constexpr Vector2 operator*(float s, const Vector2& v) { return v * s; }
+constexpr Vector2 operator-(const Vector2& v) { return {-v.x, -v.y}; }
+constexpr Vector2& operator+=(Vector2& v1, const Vector2& v2) { return v1 = v1 + v2; }
+constexpr Vector2& operator-=(Vector2& v1, const Vector2& v2) { return v1 = v1 - v2; }
+constexpr Vector2& operator*=(Vector2& v, float s) { return v = v * s; }
+constexpr bool operator==(const Vector2& v1, const Vector2& v2) { return v1.x == v2.x && v1.y == v2.y; }
+
+// ==============================
+// Vector3
+// ==============================
+constexpr Vector3 operator+(const Vector3& v1, const Vector3& v2) { return {v1.x + v2.x, v1.y + v2.y, v1.z + v2.z}; }
+constexpr Vector3 operator-(const Vector3& v1, const Vector3& v2) { return {v1.x - v2.x, v1.y - v2.y, v1.z - v2.z}; }
+constexpr Vector3 operator*(const Vector3& v, float s) { return {v.x * s, v.y * s, v.z * s}; }
+constexpr Vector3 operator*(float s, const Vector3& v) { return v * s; }
+constexpr Vector3 operator-(const Vector3& v) { return {-v.x, -v.y, -v.z}; }
+constexpr Vector3& operator+=(Vector3& v1, const Vector3& v2) { return v1 = v1 + v2; }
+constexpr Vector3& operator-=(Vector3& v1, const Vector3& v2) { return v1 = v1 - v2; }
+constexpr Vector3& operator*=(Vector3& v, float s) { return v = v * s; }
+constexpr bool operator==(const Vector3& v1, const Vector3& v2) { return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z; }
+
+// 内積
+constexpr float Dot(const Vector3& v1, const Vector3& v2) { return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; }
+// クロス積
+constexpr Vector3 Cross(const Vector3& v1, const Vector3& v2) { return {v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x}; }
+// 長さ
+inline float Length(const Vector3& v) { return std::sqrt(Dot(v, v)); }
+// 正規化
+inline Vector3 Normalize(const Vector3& v) {
+	float length = Length(v);
+	if (length == 0.0f)
+		return {0.0f, 0.0f, 0.0f};
+	return {v.x / length, v.y / length, v.z / length};
+}
+
+// ==============================
+// Vector4
+// ==============================
+constexpr Vector4 operator+(const Vector4& v1, const Vector4& v2) { return {v1.x + v2.x, v1.y + v2.y, v1.z + v2.z, v1.w + v2.w}; }
+constexpr Vector4 operator-(const Vector4& v1, const Vector4& v2) { return {v1.x - v2.x, v1.y - v2.y, v1.z - v2.z, v1.w - v2.w}; }
+constexpr Vector4 operator*(const Vector4& v, float s) { return {v.x * s, v.y * s, v.z * s, v.w * s}; }
+constexpr Vector4 operator*(float s, const Vector4& v) { return v * s; }
+constexpr Vector4 operator-(const Vector4& v) { return {-v.x, -v.y, -v.z, -v.w}; }
+constexpr Vector4& operator+=(Vector4& v1, const Vector4& v2) { return v1 = v1 + v2; }
+constexpr Vector4& operator-=(Vector4& v1, const Vector4& v2) { return v1 = v1 - v2; }
+constexpr Vector4& operator*=(Vector4& v, float s) { return v = v * s; }
+constexpr bool operator==(const Vector4& v1, const Vector4& v2) { return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z && v1.w == v2.w; }
+
+// ==============================
+// Matrix4x4
+// ==============================
+constexpr bool operator==(const Matrix4x4& m1, const Matrix4x4& m2) {
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			if (m1.m[row][col] != m2.m[row][col]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// 単位行列の作成
+constexpr Matrix4x4 MakeIdentity4x4() {
+	Matrix4x4 result{};
+	result.m[0][0] = 1;
+	result.m[1][1] = 1;
+	result.m[2][2] = 1;
+	result.m[3][3] = 1;
+	return result;
+}
+
+// 拡縮行列の作成
+constexpr Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
+	Matrix4x4 matrix = {};
+	matrix.m[0][0] = scale.x;
+	matrix.m[1][1] = scale.y;
+	matrix.m[2][2] = scale.z;
+	matrix.m[3][3] = 1.0f;
+	return matrix;
+}
+
+// 平行移動行列の作成
+constexpr Matrix4x4 MakeTranslateMatrix(const Vector3& translate) {
+	Matrix4x4 matrix = {};
+	matrix.m[0][0] = 1.0f;
+	matrix.m[1][1] = 1.0f;
+	matrix.m[2][2] = 1.0f;
+	matrix.m[3][3] = 1.0f;
+	matrix.m[3][0] = translate.x;
+	matrix.m[3][1] = translate.y;
+	matrix.m[3][2] = translate.z;
+	return matrix;
+}
+
+// 正射影行列
+constexpr Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip) {
+	Matrix4x4 result = {};
+	result.m[0][0] = 2 / (right - left);
+	result.m[1][1] = 2 / (top - bottom);
+	result.m[2][2] = 1 / (farClip - nearClip);
+	result.m[3][0] = (left + right) / (left - right);
+	result.m[3][1] = (top + bottom) / (bottom - top);
+	result.m[3][2] = nearClip / (nearClip - farClip);
+	result.m[3][3] = 1;
+	return result;
+}
+
+// ビューポート変換行列
+constexpr Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth) {
+	Matrix4x4 result = {};
+	result.m[0][0] = width / 2;
+	result.m[1][1] = -height / 2;
+	result.m[2][2] = maxDepth - minDepth;
+	result.m[3][0] = left + width / 2;
+	result.m[3][1] = top + height / 2;
+	result.m[3][2] = minDepth;
+	result.m[3][3] = 1;
+	return result;
+}
+
+// 転置行列
+constexpr Matrix4x4 Transpose(const Matrix4x4& m) {
+	Matrix4x4 result = {};
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			result.m[row][col] = m.m[col][row];
+		}
+	}
+	return result;
+}
+
+// 行列の積(SSE版。Math.cppで定義)
+Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+
+// 行列の積
+// コンパイル時はその場で計算し、実行時はSSE版のMultiplyを使う
+constexpr Matrix4x4 operator*(const Matrix4x4& m1, const Matrix4x4& m2) {
+	if (std::is_constant_evaluated()) {
+		Matrix4x4 result = {};
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				for (int k = 0; k < 4; ++k) {
+					result.m[row][col] += m1.m[row][k] * m2.m[k][col];
+				}
+			}
+		}
+		return result;
+	}
+	return Multiply(m1, m2);
+}
+
+// 単位行列
+inline constexpr Matrix4x4 kIdentity4x4 = MakeIdentity4x4();
+
+// ==============================
+// コンパイル時に計算されていることの確認
+// ==============================
+static_assert(kIdentity4x4.m[0][0] == 1.0f && kIdentity4x4.m[0][1] == 0.0f && kIdentity4x4.m[3][3] == 1.0f);
+static_assert(kIdentity4x4 * kIdentity4x4 == kIdentity4x4);
+static_assert(Transpose(MakeTranslateMatrix({1.0f, 2.0f, 3.0f})).m[0][3] == 1.0f);
+static_assert(MakeScaleMatrix({2.0f, 2.0f, 2.0f}) * MakeTranslateMatrix({1.0f, 0.0f, 0.0f}) == Matrix4x4{{{2, 0, 0, 0}, {0, 2, 0, 0}, {0, 0, 2, 0}, {1, 0, 0, 1}}});
+static_assert(MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f).m[3][0] == -1.0f);
+static_assert(MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f).m[3][1] == 1.0f);
+static_assert(Dot(Cross({1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}), {0.0f, 0.0f, 1.0f}) == 1.0f);
+static_assert(Vector2{1.0f, 2.0f} + Vector2{3.0f, 4.0f} * 2.0f == Vector2{7.0f, 10.0f});
@@ -11,6 +11,10 @@ struct Vector4 {
 	float x, y, z, w;
 };
 
+struct Quaternion {
+	float x, y, z, w;
+};
+
 struct Transform {
 	Vector3 scale;
 	Vector3 rotate;
@@ -23,4 +27,10 @@ struct Matrix4x4 {
 
 struct Matrix3x3 {
 	float m[3][3];
+};
+
+// アフィン変換(3x4)
+// m[0]～m[2]が回転・拡縮の3x3部分、m[3]が平行移動(行ベクトル規約)
+struct AffineTransform {
+	float m[4][3];
 };
\ No newline at end of file
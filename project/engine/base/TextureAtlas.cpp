@@ -0,0 +1,262 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+// imguiのものはimgui_draw.cppの中だけで使えるようにstaticになっているので、こちらでも実装を置く
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace {
+
+// キャッシュファイルの先頭
+const uint32_t kCacheMagic = 0x534C5441; // "ATLS"
+const uint32_t kCacheVersion = 1;
+
+template<typename T> void Write(std::ofstream& file, const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+template<typename T> bool Read(std::ifstream& file, T& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+} // namespace
+
+// 画像を詰める
+bool TextureAtlas::Build(const std::vector<AtlasImage>& images, const Settings& settings) {
+	settings_ = settings;
+	pages_.clear();
+	names_.clear();
+	regions_.clear();
+	indexOfNames_.clear();
+
+	// gutterを含めた大きさに、右と下の隙間を足して詰める
+	uint32_t border = settings.gutter * 2 + settings.padding;
+	std::vector<stbrp_rect> rects(images.size());
+	for (size_t i = 0; i < images.size(); ++i) {
+		const AtlasImage& image = images[i];
+		assert(image.pixels.size() == static_cast<size_t>(image.width) * image.height * kBytesPerPixel);
+		if (image.width + border > settings.pageSize || image.height + border > settings.pageSize) {
+			return false;
+		}
+		rects[i] = {};
+		rects[i].id = static_cast<int>(i);
+		rects[i].w = static_cast<stbrp_coord>(image.width + border);
+		rects[i].h = static_cast<stbrp_coord>(image.height + border);
+	}
+
+	// 1ページに入らなかった画像を次のページに詰める
+	regions_.resize(images.size());
+	std::vector<stbrp_node> nodes(settings.pageSize);
+	std::vector<stbrp_rect> remaining = rects;
+	while (!remaining.empty()) {
+		stbrp_context context;
+		int pageSize = static_cast<int>(settings.pageSize);
+		stbrp_init_target(&context, pageSize, pageSize, nodes.data(), static_cast<int>(nodes.size()));
+		stbrp_pack_rects(&context, remaining.data(), static_cast<int>(remaining.size()));
+
+		uint32_t page = static_cast<uint32_t>(pages_.size());
+		uint32_t usedHeight = 0;
+		std::vector<stbrp_rect> next;
+		for (const stbrp_rect& rect : remaining) {
+			if (!rect.was_packed) {
+				next.push_back(rect);
+				continue;
+			}
+			usedHeight = std::max(usedHeight, static_cast<uint32_t>(rect.y + rect.h));
+			const AtlasImage& image = images[rect.id];
+			AtlasRegion& region = regions_[rect.id];
+			region.page = page;
+			region.x = static_cast<uint32_t>(rect.x) + settings.gutter;
+			region.y = static_cast<uint32_t>(rect.y) + settings.gutter;
+			region.width = image.width;
+			region.height = image.height;
+		}
+		// 空のページに1つも入らないことはない(大きさは最初に調べてある)
+		assert(next.size() < remaining.size());
+		remaining.swap(next);
+
+		// 下の使っていない部分は削る(高さは2のべき乗にそろえる)
+		uint32_t height = 1;
+		while (height < usedHeight) {
+			height *= 2;
+		}
+		AtlasPage& atlasPage = pages_.emplace_back();
+		atlasPage.width = settings.pageSize;
+		atlasPage.height = std::min(height, settings.pageSize);
+		atlasPage.pixels.assign(static_cast<size_t>(atlasPage.width) * atlasPage.height * kBytesPerPixel, 0);
+	}
+
+	names_.reserve(images.size());
+	for (size_t i = 0; i < images.size(); ++i) {
+		Blit(images[i], regions_[i]);
+		ComputeUvRect(regions_[i]);
+		names_.push_back(images[i].name);
+		indexOfNames_[images[i].name] = static_cast<uint32_t>(i);
+	}
+	return true;
+}
+
+// 画像の場所
+const AtlasRegion* TextureAtlas::FindRegion(const std::string& name) const {
+	auto it = indexOfNames_.find(name);
+	return it == indexOfNames_.end() ? nullptr : &regions_[it->second];
+}
+
+// 画像をページに書き込み、端を引き伸ばす
+void TextureAtlas::Blit(const AtlasImage& image, const AtlasRegion& region) {
+	AtlasPage& page = pages_[region.page];
+	size_t pageStride = static_cast<size_t>(page.width) * kBytesPerPixel;
+	size_t rowSize = static_cast<size_t>(image.width) * kBytesPerPixel;
+	uint32_t gutter = settings_.gutter;
+
+	// gutterを含めた範囲の1行ずつ、一番近い画像の行をコピーする
+	for (uint32_t y = 0; y < image.height + gutter * 2; ++y) {
+		uint32_t sourceY = std::min(y < gutter ? 0 : y - gutter, image.height - 1);
+		const uint8_t* source = image.pixels.data() + sourceY * rowSize;
+		uint8_t* destination = page.pixels.data() + (region.y - gutter + y) * pageStride + static_cast<size_t>(region.x) * kBytesPerPixel;
+		std::memcpy(destination, source, rowSize);
+		// 左右は端のピクセルを引き伸ばす
+		for (uint32_t x = 1; x <= gutter; ++x) {
+			std::memcpy(destination - x * kBytesPerPixel, source, kBytesPerPixel);
+			std::memcpy(destination + rowSize + (x - 1) * kBytesPerPixel, source + rowSize - kBytesPerPixel, kBytesPerPixel);
+		}
+	}
+}
+
+// UVを求める
+void TextureAtlas::ComputeUvRect(AtlasRegion& region) const {
+	const AtlasPage& page = pages_[region.page];
+	float width = static_cast<float>(page.width);
+	float height = static_cast<float>(page.height);
+	region.uvRect = {
+	    static_cast<float>(region.x) / width,
+	    static_cast<float>(region.y) / height,
+	    static_cast<float>(region.x + region.width) / width,
+	    static_cast<float>(region.y + region.height) / height,
+	};
+}
+
+// ファイルに書き出す
+bool TextureAtlas::SaveCache(const std::string& filePath, uint64_t key) const {
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	Write(file, kCacheMagic);
+	Write(file, kCacheVersion);
+	Write(file, key);
+	Write(file, settings_);
+
+	Write(file, static_cast<uint32_t>(pages_.size()));
+	for (const AtlasPage& page : pages_) {
+		Write(file, page.width);
+		Write(file, page.height);
+		file.write(reinterpret_cast<const char*>(page.pixels.data()), static_cast<std::streamsize>(page.pixels.size()));
+	}
+
+	Write(file, static_cast<uint32_t>(regions_.size()));
+	for (size_t i = 0; i < regions_.size(); ++i) {
+		const AtlasRegion& region = regions_[i];
+		Write(file, static_cast<uint32_t>(names_[i].size()));
+		file.write(names_[i].data(), static_cast<std::streamsize>(names_[i].size()));
+		Write(file, region.page);
+		Write(file, region.x);
+		Write(file, region.y);
+		Write(file, region.width);
+		Write(file, region.height);
+	}
+	return static_cast<bool>(file);
+}
+
+// ファイルから読み込む
+bool TextureAtlas::LoadCache(const std::string& filePath, uint64_t key) {
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	uint32_t magic = 0, version = 0;
+	uint64_t cachedKey = 0;
+	if (!Read(file, magic) || !Read(file, version) || !Read(file, cachedKey) || magic != kCacheMagic || version != kCacheVersion || cachedKey != key) {
+		return false;
+	}
+
+	// 途中で失敗したときに中途半端な状態にならないように、別の変数に読んでから入れ替える
+	Settings settings;
+	std::vector<AtlasPage> pages;
+	std::vector<std::string> names;
+	std::vector<AtlasRegion> regions;
+	uint32_t pageCount = 0;
+	if (!Read(file, settings) || !Read(file, pageCount)) {
+		return false;
+	}
+	pages.resize(pageCount);
+	for (AtlasPage& page : pages) {
+		if (!Read(file, page.width) || !Read(file, page.height) || page.width > settings.pageSize || page.height > settings.pageSize) {
+			return false;
+		}
+		page.pixels.resize(static_cast<size_t>(page.width) * page.height * kBytesPerPixel);
+		if (!file.read(reinterpret_cast<char*>(page.pixels.data()), static_cast<std::streamsize>(page.pixels.size()))) {
+			return false;
+		}
+	}
+
+	uint32_t regionCount = 0;
+	if (!Read(file, regionCount)) {
+		return false;
+	}
+	names.resize(regionCount);
+	regions.resize(regionCount);
+	for (uint32_t i = 0; i < regionCount; ++i) {
+		uint32_t nameSize = 0;
+		if (!Read(file, nameSize)) {
+			return false;
+		}
+		names[i].resize(nameSize);
+		AtlasRegion& region = regions[i];
+		if (!file.read(names[i].data(), nameSize) || !Read(file, region.page) || !Read(file, region.x) || !Read(file, region.y) || !Read(file, region.width) ||
+		    !Read(file, region.height)) {
+			return false;
+		}
+		if (region.page >= pageCount || region.x + region.width > pages[region.page].width || region.y + region.height > pages[region.page].height) {
+			return false;
+		}
+	}
+
+	settings_ = settings;
+	pages_.swap(pages);
+	names_.swap(names);
+	regions_.swap(regions);
+	indexOfNames_.clear();
+	for (uint32_t i = 0; i < regionCount; ++i) {
+		ComputeUvRect(regions_[i]);
+		indexOfNames_[names_[i]] = i;
+	}
+	return true;
+}
+
+// ハッシュ(FNV-1a)
+uint64_t TextureAtlas::Hash(const void* data, size_t size, uint64_t seed) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// 画像と設定からkeyを作る
+uint64_t TextureAtlas::ComputeKey(const std::vector<AtlasImage>& images, const Settings& settings) {
+	uint64_t key = Hash(&settings, sizeof(settings));
+	for (const AtlasImage& image : images) {
+		key = Hash(image.name.data(), image.name.size(), key);
+		key = Hash(&image.width, sizeof(image.width), key);
+		key = Hash(&image.height, sizeof(image.height), key);
+		key = Hash(image.pixels.data(), image.pixels.size(), key);
+	}
+	return key;
+}
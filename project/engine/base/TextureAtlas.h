@@ -0,0 +1,91 @@
+#pragma once
+#include "base/MathTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// テクスチャアトラス(DirectXに依存しない部分)
+// 小さい画像をimstb_rectpackで数枚の大きなページに詰め、画像ごとのUV範囲を求める
+//
+// 画像の周りにはgutterピクセル分だけ端のピクセルを引き伸ばして置く(ミップマップや線形補間で隣の画像がにじまないように)
+// さらにpaddingピクセル分の隙間を空ける
+// gutterは使うミップレベルをnとすると2^n以上あれば、そのレベルまで隣の画像が混ざらない
+//
+// 詰めた結果はファイルに書き出せるので、入力が変わっていなければ起動時に詰め直さずに読み込む
+
+// 入力の画像(RGBA8、左上から1行ずつ)
+struct AtlasImage {
+	std::string name;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> pixels;
+};
+
+// 詰めた後の画像の場所
+struct AtlasRegion {
+	// ページの番号
+	uint32_t page = 0;
+	// ページ内の左上と大きさ(ピクセル。gutterは含まない)
+	uint32_t x = 0;
+	uint32_t y = 0;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	// 左上と右下のUV
+	Vector4 uvRect = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+// 1ページ分の画像(RGBA8)
+struct AtlasPage {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> pixels;
+};
+
+class TextureAtlas {
+public:
+	struct Settings {
+		// ページの大きさ(ピクセル。下が余ったページは高さを2のべき乗まで縮める)
+		uint32_t pageSize = 2048;
+		// 画像の周りに引き伸ばして置く幅
+		uint32_t gutter = 4;
+		// gutterの外側に空ける隙間
+		uint32_t padding = 2;
+	};
+
+	static const uint32_t kBytesPerPixel = 4;
+
+	// 画像を詰める(ページに入らない大きさの画像があればfalse)
+	bool Build(const std::vector<AtlasImage>& images, const Settings& settings);
+
+	// ページのgetter
+	const std::vector<AtlasPage>& GetPages() const { return pages_; }
+	// 画像の場所(名前で引く。なければnullptr)
+	const AtlasRegion* FindRegion(const std::string& name) const;
+	// 画像数
+	size_t GetRegionCount() const { return regions_.size(); }
+
+	// ファイルに書き出す(keyは入力を表す値。読み込むときに一致しなければ使わない)
+	bool SaveCache(const std::string& filePath, uint64_t key) const;
+	// ファイルから読み込む(ファイルがない・keyが違う・壊れている場合はfalse)
+	bool LoadCache(const std::string& filePath, uint64_t key);
+
+	// キャッシュのkeyを作るためのハッシュ(FNV-1a。seedに前の値を渡して続けて混ぜられる)
+	static constexpr uint64_t kHashSeed = 14695981039346656037ull;
+	static uint64_t Hash(const void* data, size_t size, uint64_t seed = kHashSeed);
+	// 画像と設定からkeyを作る
+	static uint64_t ComputeKey(const std::vector<AtlasImage>& images, const Settings& settings);
+
+private:
+	// 画像をページに書き込み、端を引き伸ばす
+	void Blit(const AtlasImage& image, const AtlasRegion& region);
+	// UVを求める
+	void ComputeUvRect(AtlasRegion& region) const;
+
+	Settings settings_;
+	std::vector<AtlasPage> pages_;
+	std::vector<std::string> names_;
+	std::vector<AtlasRegion> regions_;
+	std::unordered_map<std::string, uint32_t> indexOfNames_;
+};
@@ -1,6 +1,8 @@
 #include "TextureManager.h"
 #include "base/DirectXCommon.h"
 #include <io/Input.h>
+#include <cstring>
+#include <filesystem>
 
 
 TextureManager* TextureManager::instance = nullptr;
@@ -21,6 +23,12 @@ TextureManager* TextureManager::GetInstance() {
 	return instance;
 }
 
+// テクスチャ番号0のSRVのGPUハンドル
+D3D12_GPU_DESCRIPTOR_HANDLE TextureManager::GetSrvHandleGPUTop() const { return dXCommon_->GetSRVGPUDescriptorHandle(kSRVIndexTop); }
+
+// 読み込めるテクスチャの最大数
+uint32_t TextureManager::GetMaxTextureCount() { return DirectXCommon::kMaxSRVCount - kSRVIndexTop; }
+
 void TextureManager::Finalize() {
 		delete instance;
 		instance = nullptr;
@@ -43,6 +51,11 @@ void TextureManager::LoadTexture(const std::string& filePath) {
 	// テクスチャファイルを読んでプログラムで扱えるようにする
 	image = DirectXCommon::LoadTexture(filePath);
 
+	CreateTexture(filePath, image);
+}
+
+// 画像からテクスチャを作ってGPUに転送する
+void TextureManager::CreateTexture(const std::string& filePath, const DirectX::ScratchImage& image) {
 	DirectX::ScratchImage mipImages{};
 	// mipmapの作成
 	HRESULT hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImages);
@@ -105,6 +118,86 @@ void TextureManager::LoadTexture(const std::string& filePath) {
 	
 }
 
+// 画像ファイルをまとめてアトラスにして読み込む
+void TextureManager::LoadAtlas(const std::vector<std::string>& filePaths, const std::string& cacheFilePath, const TextureAtlas::Settings& settings) {
+	// キャッシュのkeyはファイルの中身を読まずに作る(パス・サイズ・更新日時)
+	uint64_t key = TextureAtlas::Hash(&settings, sizeof(settings));
+	for (const std::string& filePath : filePaths) {
+		assert(std::filesystem::exists(filePath) && "Texture file not found");
+		uint64_t fileSize = std::filesystem::file_size(filePath);
+		int64_t writeTime = std::filesystem::last_write_time(filePath).time_since_epoch().count();
+		key = TextureAtlas::Hash(filePath.data(), filePath.size(), key);
+		key = TextureAtlas::Hash(&fileSize, sizeof(fileSize), key);
+		key = TextureAtlas::Hash(&writeTime, sizeof(writeTime), key);
+	}
+
+	AtlasData& atlasData = atlasDatas.emplace_back();
+	if (!atlasData.atlas.LoadCache(cacheFilePath, key)) {
+		// キャッシュが使えなければ画像を読んで詰め直す
+		std::vector<AtlasImage> images(filePaths.size());
+		for (size_t i = 0; i < filePaths.size(); ++i) {
+			DirectX::ScratchImage loaded = DirectXCommon::LoadTexture(filePaths[i]);
+			// 一番大きいミップレベルをRGBA8にそろえる
+			DirectX::ScratchImage converted{};
+			const DirectX::Image* source = loaded.GetImage(0, 0, 0);
+			if (source->format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) {
+				HRESULT hr = DirectX::Convert(*source, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+				assert(SUCCEEDED(hr) && "Convert failed");
+				source = converted.GetImage(0, 0, 0);
+			}
+
+			AtlasImage& image = images[i];
+			image.name = filePaths[i];
+			image.width = static_cast<uint32_t>(source->width);
+			image.height = static_cast<uint32_t>(source->height);
+			size_t rowSize = static_cast<size_t>(image.width) * TextureAtlas::kBytesPerPixel;
+			image.pixels.resize(rowSize * image.height);
+			for (uint32_t y = 0; y < image.height; ++y) {
+				std::memcpy(image.pixels.data() + y * rowSize, source->pixels + y * source->rowPitch, rowSize);
+			}
+		}
+		bool isBuilt = atlasData.atlas.Build(images, settings);
+		assert(isBuilt && "Atlas page is too small");
+		(void)isBuilt;
+		atlasData.atlas.SaveCache(cacheFilePath, key);
+	}
+
+	// ページをテクスチャとして読み込む
+	atlasData.firstTextureIndex = LoadAtlasPages(atlasData.atlas, cacheFilePath);
+}
+
+// アトラスのページをテクスチャとして読み込む
+uint32_t TextureManager::LoadAtlasPages(const TextureAtlas& atlas, const std::string& name) {
+	uint32_t firstTextureIndex = static_cast<uint32_t>(textureDatas.size());
+	const std::vector<AtlasPage>& pages = atlas.GetPages();
+	for (size_t i = 0; i < pages.size(); ++i) {
+		const AtlasPage& page = pages[i];
+		DirectX::ScratchImage image{};
+		HRESULT hr = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, page.width, page.height, 1, 1);
+		assert(SUCCEEDED(hr) && "Initialize2D failed");
+		const DirectX::Image* destination = image.GetImage(0, 0, 0);
+		size_t rowSize = static_cast<size_t>(page.width) * TextureAtlas::kBytesPerPixel;
+		for (uint32_t y = 0; y < page.height; ++y) {
+			std::memcpy(destination->pixels + y * destination->rowPitch, page.pixels.data() + y * rowSize, rowSize);
+		}
+		CreateTexture(name + "#" + std::to_string(i), image);
+	}
+	return firstTextureIndex;
+}
+
+// アトラスに入っている画像の場所
+bool TextureManager::FindAtlasRegion(const std::string& filePath, uint32_t& outTextureIndex, AtlasRegion& outRegion) const {
+	for (const AtlasData& atlasData : atlasDatas) {
+		const AtlasRegion* region = atlasData.atlas.FindRegion(filePath);
+		if (region != nullptr) {
+			outTextureIndex = atlasData.firstTextureIndex + region->page;
+			outRegion = *region;
+			return true;
+		}
+	}
+	return false;
+}
+
 // SRVインデックスの開始番号
 uint32_t TextureManager::GetTextureIndexByFilePath(const std::string& filePath) {
 	// 読み込みのテクスチャを検索
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <DirectXTex/DirectXTex.h>
+#include "TextureAtlas.h"
 #include <wrl.h>
 #include <d3d12.h>
 
@@ -36,6 +38,16 @@ private:
 	// テクスチャデータ
 	std::vector<TextureData> textureDatas;
 
+	// 読み込んだアトラス(ページはtextureDatasにfirstTextureIndexから順に並ぶ)
+	struct AtlasData {
+		TextureAtlas atlas;
+		uint32_t firstTextureIndex;
+	};
+	std::vector<AtlasData> atlasDatas;
+
+	// 画像からテクスチャを作ってGPUに転送する(ミップマップもここで作る)
+	void CreateTexture(const std::string& filePath, const DirectX::ScratchImage& image);
+
 	// SRVインデックスの開始番号
 	static uint32_t kSRVIndexTop;
 
@@ -53,10 +65,23 @@ public:
 
 	void LoadTexture(const std::string& filePath);
 
+	// 画像ファイルをまとめてアトラスにして読み込む
+	// 前回と同じファイル(パス・サイズ・更新日時)と設定ならcacheFilePathから読み込み、詰め直さない
+	void LoadAtlas(const std::vector<std::string>& filePaths, const std::string& cacheFilePath, const TextureAtlas::Settings& settings = {});
+	// 組み立て済みのアトラスのページをテクスチャとして読み込む(フォントなど。ページはnameの後ろに#番号を付けた名前になる)
+	// 戻り値は0ページ目のテクスチャ番号(ページは番号順に並ぶ)
+	uint32_t LoadAtlasPages(const TextureAtlas& atlas, const std::string& name);
+	// アトラスに入っている画像の場所(ページのテクスチャ番号とページ内の範囲。入っていなければfalse)
+	bool FindAtlasRegion(const std::string& filePath, uint32_t& outTextureIndex, AtlasRegion& outRegion) const;
+
 	// SRVインデックスの開始番号
 	uint32_t GetTextureIndexByFilePath(const std::string& filePath);
 	// テクスチャ番号からGPUハンドルを取得
 	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(uint32_t textureIndex);
+	// テクスチャ番号0のSRVのGPUハンドル(テクスチャのSRVは番号順に並んでいるので、配列として渡すときの先頭)
+	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPUTop() const;
+	// 読み込めるテクスチャの最大数
+	static uint32_t GetMaxTextureCount();
 
 	// メタデータを取得
 	const DirectX::TexMetadata& GetMetadata(uint32_t textureIndex);
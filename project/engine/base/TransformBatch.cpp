@@ -0,0 +1,175 @@
+#include "TransformBatch.h"
+#include "FastTrig.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace {
+
+// SIMDでまとめて処理する要素数
+const size_t kLaneCount = 4;
+
+// 1行 × 行列 (行ベクトル規約)
+inline __m128 MultiplyRow(float x, float y, float z, __m128 r0, __m128 r1, __m128 r2) {
+	__m128 result = _mm_mul_ps(_mm_set1_ps(x), r0);
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(y), r1));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(z), r2));
+	return result;
+}
+
+} // namespace
+
+// 要素数の変更
+void TransformBatch::Resize(size_t count) {
+	count_ = count;
+	// 拡縮の初期値は1
+	scaleX_.resize(count, 1.0f);
+	scaleY_.resize(count, 1.0f);
+	scaleZ_.resize(count, 1.0f);
+	rotateX_.resize(count, 0.0f);
+	rotateY_.resize(count, 0.0f);
+	rotateZ_.resize(count, 0.0f);
+	translateX_.resize(count, 0.0f);
+	translateY_.resize(count, 0.0f);
+	translateZ_.resize(count, 0.0f);
+}
+
+// Transformのsetter
+void TransformBatch::SetTransform(size_t index, const Transform& transform) {
+	assert(index < count_);
+	scaleX_[index] = transform.scale.x;
+	scaleY_[index] = transform.scale.y;
+	scaleZ_[index] = transform.scale.z;
+	rotateX_[index] = transform.rotate.x;
+	rotateY_[index] = transform.rotate.y;
+	rotateZ_[index] = transform.rotate.z;
+	translateX_[index] = transform.translate.x;
+	translateY_[index] = transform.translate.y;
+	translateZ_[index] = transform.translate.z;
+}
+
+// Transformのgetter
+Transform TransformBatch::GetTransform(size_t index) const {
+	assert(index < count_);
+	return Transform{
+	    {scaleX_[index],     scaleY_[index],     scaleZ_[index]    },
+	    {rotateX_[index],    rotateY_[index],    rotateZ_[index]   },
+	    {translateX_[index], translateY_[index], translateZ_[index]},
+	};
+}
+
+// World行列とWVP行列をまとめて計算して書き込む
+void TransformBatch::Update(const Matrix4x4& viewProjection, void* output, size_t strideInBytes) const {
+	assert(output != nullptr || count_ == 0);
+	assert(strideInBytes >= sizeof(TransformationMatrix));
+	UpdateRange(viewProjection, static_cast<uint8_t*>(output), strideInBytes, 0, count_);
+}
+
+// ワーカースレッドで分けて計算する
+void TransformBatch::Update(const Matrix4x4& viewProjection, void* output, WorkerPool& workerPool, size_t strideInBytes) const {
+	assert(output != nullptr || count_ == 0);
+	assert(strideInBytes >= sizeof(TransformationMatrix));
+	static_assert(kParallelChunkSize % kLaneCount == 0);
+	uint8_t* dst = static_cast<uint8_t*>(output);
+	workerPool.ParallelFor(count_, kParallelChunkSize, [&](size_t begin, size_t end) { UpdateRange(viewProjection, dst, strideInBytes, begin, end); });
+}
+
+// [begin, end)の範囲を計算する
+void TransformBatch::UpdateRange(const Matrix4x4& viewProjection, uint8_t* output, size_t strideInBytes, size_t begin, size_t end) const {
+	__m128 vp0 = _mm_loadu_ps(viewProjection.m[0]);
+	__m128 vp1 = _mm_loadu_ps(viewProjection.m[1]);
+	__m128 vp2 = _mm_loadu_ps(viewProjection.m[2]);
+	__m128 vp3 = _mm_loadu_ps(viewProjection.m[3]);
+
+	// 4要素分のWorld行列(回転×拡縮の9要素)を要素ごとに並べたもの
+	alignas(16) float world[9][kLaneCount];
+	// 法線変換用の行列の9要素
+	alignas(16) float normal[9][kLaneCount];
+
+	for (size_t base = begin; base < end; base += kLaneCount) {
+		size_t laneCount = std::min(kLaneCount, end - base);
+
+		// 端数は0で埋める
+		alignas(16) float rx[kLaneCount] = {}, ry[kLaneCount] = {}, rz[kLaneCount] = {};
+		alignas(16) float sx[kLaneCount] = {}, sy[kLaneCount] = {}, sz[kLaneCount] = {};
+		std::memcpy(rx, &rotateX_[base], laneCount * sizeof(float));
+		std::memcpy(ry, &rotateY_[base], laneCount * sizeof(float));
+		std::memcpy(rz, &rotateZ_[base], laneCount * sizeof(float));
+		std::memcpy(sx, &scaleX_[base], laneCount * sizeof(float));
+		std::memcpy(sy, &scaleY_[base], laneCount * sizeof(float));
+		std::memcpy(sz, &scaleZ_[base], laneCount * sizeof(float));
+
+		__m128 snx, csx, sny, csy, snz, csz;
+		SinCos4(_mm_load_ps(rx), snx, csx);
+		SinCos4(_mm_load_ps(ry), sny, csy);
+		SinCos4(_mm_load_ps(rz), snz, csz);
+		__m128 scx = _mm_load_ps(sx), scy = _mm_load_ps(sy), scz = _mm_load_ps(sz);
+
+		// X→Y→Zで合成した回転行列に拡縮を掛ける(4要素同時)
+		__m128 sxsy = _mm_mul_ps(snx, sny);
+		__m128 cxsy = _mm_mul_ps(csx, sny);
+		_mm_store_ps(world[0], _mm_mul_ps(scx, _mm_mul_ps(csy, csz)));
+		_mm_store_ps(world[1], _mm_mul_ps(scx, _mm_mul_ps(csy, snz)));
+		_mm_store_ps(world[2], _mm_mul_ps(scx, _mm_sub_ps(_mm_setzero_ps(), sny)));
+		_mm_store_ps(world[3], _mm_mul_ps(scy, _mm_sub_ps(_mm_mul_ps(sxsy, csz), _mm_mul_ps(csx, snz))));
+		_mm_store_ps(world[4], _mm_mul_ps(scy, _mm_add_ps(_mm_mul_ps(sxsy, snz), _mm_mul_ps(csx, csz))));
+		_mm_store_ps(world[5], _mm_mul_ps(scy, _mm_mul_ps(snx, csy)));
+		_mm_store_ps(world[6], _mm_mul_ps(scz, _mm_add_ps(_mm_mul_ps(cxsy, csz), _mm_mul_ps(snx, snz))));
+		_mm_store_ps(world[7], _mm_mul_ps(scz, _mm_sub_ps(_mm_mul_ps(cxsy, snz), _mm_mul_ps(snx, csz))));
+		_mm_store_ps(world[8], _mm_mul_ps(scz, _mm_mul_ps(csx, csy)));
+
+		// 法線変換用の行列
+		// World = S * R なので逆転置行列は S^-1 * R、つまりWorldの各行を拡縮の2乗で割ったもの
+		// 均一スケールの要素は向きが変わらないのでWorldをそのまま使う(シェーダーで正規化する)
+		__m128 isUniform = _mm_and_ps(_mm_cmpeq_ps(scx, scy), _mm_cmpeq_ps(scy, scz));
+		bool isAllUniform = _mm_movemask_ps(isUniform) == 0xF;
+		if (!isAllUniform) {
+			__m128 invSq[3] = {
+			    _mm_div_ps(_mm_set1_ps(1.0f), _mm_mul_ps(scx, scx)),
+			    _mm_div_ps(_mm_set1_ps(1.0f), _mm_mul_ps(scy, scy)),
+			    _mm_div_ps(_mm_set1_ps(1.0f), _mm_mul_ps(scz, scz)),
+			};
+			__m128 zeroScale[3] = {_mm_cmpeq_ps(scx, _mm_setzero_ps()), _mm_cmpeq_ps(scy, _mm_setzero_ps()), _mm_cmpeq_ps(scz, _mm_setzero_ps())};
+			for (int row = 0; row < 3; ++row) {
+				// 均一スケールと拡縮0の要素は1倍
+				__m128 keep = _mm_or_ps(isUniform, zeroScale[row]);
+				__m128 factor = _mm_or_ps(_mm_and_ps(keep, _mm_set1_ps(1.0f)), _mm_andnot_ps(keep, invSq[row]));
+				for (int column = 0; column < 3; ++column) {
+					_mm_store_ps(normal[row * 3 + column], _mm_mul_ps(_mm_load_ps(world[row * 3 + column]), factor));
+				}
+			}
+		}
+		const float(*normalRows)[kLaneCount] = isAllUniform ? world : normal;
+
+		// 要素ごとにWorld行列とWVP行列を書き込む
+		for (size_t lane = 0; lane < laneCount; ++lane) {
+			size_t index = base + lane;
+			float tx = translateX_[index];
+			float ty = translateY_[index];
+			float tz = translateZ_[index];
+
+			TransformationMatrix* dst = reinterpret_cast<TransformationMatrix*>(output + index * strideInBytes);
+
+			__m128 w0 = _mm_setr_ps(world[0][lane], world[1][lane], world[2][lane], 0.0f);
+			__m128 w1 = _mm_setr_ps(world[3][lane], world[4][lane], world[5][lane], 0.0f);
+			__m128 w2 = _mm_setr_ps(world[6][lane], world[7][lane], world[8][lane], 0.0f);
+			_mm_storeu_ps(dst->World.m[0], w0);
+			_mm_storeu_ps(dst->World.m[1], w1);
+			_mm_storeu_ps(dst->World.m[2], w2);
+			_mm_storeu_ps(dst->World.m[3], _mm_setr_ps(tx, ty, tz, 1.0f));
+
+			_mm_storeu_ps(dst->WorldInverseTranspose.m[0], _mm_setr_ps(normalRows[0][lane], normalRows[1][lane], normalRows[2][lane], 0.0f));
+			_mm_storeu_ps(dst->WorldInverseTranspose.m[1], _mm_setr_ps(normalRows[3][lane], normalRows[4][lane], normalRows[5][lane], 0.0f));
+			_mm_storeu_ps(dst->WorldInverseTranspose.m[2], _mm_setr_ps(normalRows[6][lane], normalRows[7][lane], normalRows[8][lane], 0.0f));
+			_mm_storeu_ps(dst->WorldInverseTranspose.m[3], _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+
+			// World行列は4列目が(0,0,0,1)なのでその分の積を省く
+			_mm_storeu_ps(dst->WVP.m[0], MultiplyRow(world[0][lane], world[1][lane], world[2][lane], vp0, vp1, vp2));
+			_mm_storeu_ps(dst->WVP.m[1], MultiplyRow(world[3][lane], world[4][lane], world[5][lane], vp0, vp1, vp2));
+			_mm_storeu_ps(dst->WVP.m[2], MultiplyRow(world[6][lane], world[7][lane], world[8][lane], vp0, vp1, vp2));
+			_mm_storeu_ps(dst->WVP.m[3], _mm_add_ps(MultiplyRow(tx, ty, tz, vp0, vp1, vp2), vp3));
+		}
+	}
+}
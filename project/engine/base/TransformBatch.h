@@ -0,0 +1,71 @@
+#pragma once
+#include "MathTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 前方宣言
+class WorkerPool;
+
+// 複数オブジェクトのTransformをSoA(要素ごとの配列)で持ち、
+// World行列とWVP行列をまとめて計算するクラス
+class TransformBatch {
+public:
+	// 座標変換行列データ(Sprite::TransformationMatrixと同じ並び)
+	struct TransformationMatrix {
+		Matrix4x4 WVP;
+		Matrix4x4 World;
+		// 法線変換用(Worldの逆転置行列。均一スケールならWorldと同じ)
+		Matrix4x4 WorldInverseTranspose;
+	};
+
+	// ワーカースレッドに分けるときの1回分の数(これより少なければ分けない。SIMDの単位の倍数)
+	static constexpr size_t kParallelChunkSize = 4096;
+
+	// 要素数の変更
+	void Resize(size_t count);
+
+	// 要素数のgetter
+	size_t GetCount() const { return count_; }
+
+	// Transformのsetter
+	void SetTransform(size_t index, const Transform& transform);
+	// Transformのgetter
+	Transform GetTransform(size_t index) const;
+
+	// World行列とWVP行列をまとめて計算して書き込む
+	// output : マップ済みの定数バッファなど。strideInBytes間隔でTransformationMatrixを書き込む
+	void Update(const Matrix4x4& viewProjection, void* output, size_t strideInBytes = sizeof(TransformationMatrix)) const;
+	// ワーカースレッドで分けて計算する(要素ごとに別の位置に書き込むので、結果は1スレッドと同じ)
+	void Update(const Matrix4x4& viewProjection, void* output, WorkerPool& workerPool, size_t strideInBytes = sizeof(TransformationMatrix)) const;
+
+	// 各要素の配列のgetter
+	float* GetScaleX() { return scaleX_.data(); }
+	float* GetScaleY() { return scaleY_.data(); }
+	float* GetScaleZ() { return scaleZ_.data(); }
+	float* GetRotateX() { return rotateX_.data(); }
+	float* GetRotateY() { return rotateY_.data(); }
+	float* GetRotateZ() { return rotateZ_.data(); }
+	float* GetTranslateX() { return translateX_.data(); }
+	float* GetTranslateY() { return translateY_.data(); }
+	float* GetTranslateZ() { return translateZ_.data(); }
+
+private:
+	// [begin, end)の範囲を計算する
+	void UpdateRange(const Matrix4x4& viewProjection, uint8_t* output, size_t strideInBytes, size_t begin, size_t end) const;
+
+	size_t count_ = 0;
+
+	// 拡縮
+	std::vector<float> scaleX_;
+	std::vector<float> scaleY_;
+	std::vector<float> scaleZ_;
+	// 回転
+	std::vector<float> rotateX_;
+	std::vector<float> rotateY_;
+	std::vector<float> rotateZ_;
+	// 移動
+	std::vector<float> translateX_;
+	std::vector<float> translateY_;
+	std::vector<float> translateZ_;
+};
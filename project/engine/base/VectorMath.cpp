@@ -0,0 +1,226 @@
+#include "VectorMath.h"
+#include "MathConstexpr.h"
+#include <emmintrin.h>
+
+// 4つずつ読み書きするのでVector3は隙間なく並んでいる必要がある
+static_assert(sizeof(Vector3) == sizeof(float) * 3);
+static_assert(sizeof(Vector4) == sizeof(float) * 4);
+
+namespace {
+
+// 要素ごとに4つ並べたVector3(x,y,zそれぞれに4要素)
+struct Vector3x4 {
+	__m128 x, y, z;
+};
+
+// Vector3を4つ読み込んで要素ごとに並べ替える
+// (x0 y0 z0 x1)(y1 z1 x2 y2)(z2 x3 y3 z3) → (x0 x1 x2 x3)(y0 y1 y2 y3)(z0 z1 z2 z3)
+inline Vector3x4 Load4(const Vector3* v) {
+	const float* p = &v->x;
+	__m128 a = _mm_loadu_ps(p);
+	__m128 b = _mm_loadu_ps(p + 4);
+	__m128 c = _mm_loadu_ps(p + 8);
+
+	Vector3x4 result;
+	__m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2));
+	result.x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(3, 0, 3, 0));
+	__m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+	bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+	result.y = _mm_shuffle_ps(ab, bc, _MM_SHUFFLE(2, 0, 2, 0));
+	ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+	__m128 cc = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+	result.z = _mm_shuffle_ps(ab, cc, _MM_SHUFFLE(2, 0, 2, 0));
+	return result;
+}
+
+// Load4の逆
+inline void Store4(Vector3* v, const Vector3x4& value) {
+	float* p = &v->x;
+	__m128 t = _mm_shuffle_ps(value.x, value.y, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 u = _mm_shuffle_ps(value.z, value.x, _MM_SHUFFLE(1, 1, 0, 0));
+	_mm_storeu_ps(p, _mm_shuffle_ps(t, u, _MM_SHUFFLE(2, 0, 2, 0)));
+	t = _mm_shuffle_ps(value.y, value.z, _MM_SHUFFLE(1, 1, 1, 1));
+	u = _mm_shuffle_ps(value.x, value.y, _MM_SHUFFLE(2, 2, 2, 2));
+	_mm_storeu_ps(p + 4, _mm_shuffle_ps(t, u, _MM_SHUFFLE(2, 0, 2, 0)));
+	t = _mm_shuffle_ps(value.z, value.x, _MM_SHUFFLE(3, 3, 2, 2));
+	u = _mm_shuffle_ps(value.y, value.z, _MM_SHUFFLE(3, 3, 3, 3));
+	_mm_storeu_ps(p + 8, _mm_shuffle_ps(t, u, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+inline __m128 Dot4(const Vector3x4& a, const Vector3x4& b) { return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z)); }
+
+// 1/sqrt(d) (近似値 + ニュートン法1回)。d = 0の要素は0
+inline __m128 ReciprocalSqrt(__m128 d) {
+	__m128 r = _mm_rsqrt_ps(d);
+	// r' = r * (1.5 - 0.5 * d * r * r)
+	__m128 halfDrr = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), d), _mm_mul_ps(r, r));
+	r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), halfDrr));
+	return _mm_and_ps(r, _mm_cmpgt_ps(d, _mm_setzero_ps()));
+}
+
+inline Vector3x4 Normalize4(const Vector3x4& v) {
+	__m128 r = ReciprocalSqrt(Dot4(v, v));
+	return {_mm_mul_ps(v.x, r), _mm_mul_ps(v.y, r), _mm_mul_ps(v.z, r)};
+}
+
+// 行列の3行(+平行移動)を要素ごとに4つ並べたもの
+struct Matrix3x4Splat {
+	__m128 m[4][3];
+};
+
+inline Matrix3x4Splat Splat(const Matrix4x4& m) {
+	Matrix3x4Splat result;
+	for (int row = 0; row < 4; ++row) {
+		for (int column = 0; column < 3; ++column) {
+			result.m[row][column] = _mm_set1_ps(m.m[row][column]);
+		}
+	}
+	return result;
+}
+
+// 行ベクトル × 3x3部分
+inline Vector3x4 MultiplyDirection4(const Vector3x4& v, const Matrix3x4Splat& m) {
+	Vector3x4 result;
+	result.x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(v.x, m.m[0][0]), _mm_mul_ps(v.y, m.m[1][0])), _mm_mul_ps(v.z, m.m[2][0]));
+	result.y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(v.x, m.m[0][1]), _mm_mul_ps(v.y, m.m[1][1])), _mm_mul_ps(v.z, m.m[2][1]));
+	result.z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(v.x, m.m[0][2]), _mm_mul_ps(v.y, m.m[1][2])), _mm_mul_ps(v.z, m.m[2][2]));
+	return result;
+}
+
+} // namespace
+
+// 正規化
+Vector3 NormalizeFast(const Vector3& v) {
+	__m128 value = _mm_setr_ps(v.x, v.y, v.z, 0.0f);
+	__m128 d = _mm_mul_ps(value, value);
+	d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+	d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 0, 3, 2)));
+	alignas(16) float result[4];
+	_mm_store_ps(result, _mm_mul_ps(value, ReciprocalSqrt(d)));
+	return {result[0], result[1], result[2]};
+}
+
+Vector4 NormalizeFast(const Vector4& v) {
+	__m128 value = _mm_loadu_ps(&v.x);
+	__m128 d = _mm_mul_ps(value, value);
+	d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+	d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 0, 3, 2)));
+	Vector4 result;
+	_mm_storeu_ps(&result.x, _mm_mul_ps(value, ReciprocalSqrt(d)));
+	return result;
+}
+
+void AddBatch(const Vector3* a, const Vector3* b, Vector3* out, size_t n) {
+	// 要素ごとの計算なので並べ替えずにfloat配列として足す
+	const float* pa = &a->x;
+	const float* pb = &b->x;
+	float* po = &out->x;
+	size_t count = n * 3;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(po + i, _mm_add_ps(_mm_loadu_ps(pa + i), _mm_loadu_ps(pb + i)));
+	}
+	for (; i < count; ++i) {
+		po[i] = pa[i] + pb[i];
+	}
+}
+
+void ScaleBatch(const Vector3* v, float s, Vector3* out, size_t n) {
+	const float* pv = &v->x;
+	float* po = &out->x;
+	__m128 scale = _mm_set1_ps(s);
+	size_t count = n * 3;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(po + i, _mm_mul_ps(_mm_loadu_ps(pv + i), scale));
+	}
+	for (; i < count; ++i) {
+		po[i] = pv[i] * s;
+	}
+}
+
+void DotBatch(const Vector3* a, const Vector3* b, float* out, size_t n) {
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_ps(out + i, Dot4(Load4(a + i), Load4(b + i)));
+	}
+	for (; i < n; ++i) {
+		out[i] = Dot(a[i], b[i]);
+	}
+}
+
+void CrossBatch(const Vector3* a, const Vector3* b, Vector3* out, size_t n) {
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		Vector3x4 va = Load4(a + i);
+		Vector3x4 vb = Load4(b + i);
+		Vector3x4 result;
+		result.x = _mm_sub_ps(_mm_mul_ps(va.y, vb.z), _mm_mul_ps(va.z, vb.y));
+		result.y = _mm_sub_ps(_mm_mul_ps(va.z, vb.x), _mm_mul_ps(va.x, vb.z));
+		result.z = _mm_sub_ps(_mm_mul_ps(va.x, vb.y), _mm_mul_ps(va.y, vb.x));
+		Store4(out + i, result);
+	}
+	for (; i < n; ++i) {
+		out[i] = Cross(a[i], b[i]);
+	}
+}
+
+void NormalizeBatch(const Vector3* v, Vector3* out, size_t n) {
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		Store4(out + i, Normalize4(Load4(v + i)));
+	}
+	for (; i < n; ++i) {
+		out[i] = NormalizeFast(v[i]);
+	}
+}
+
+void TransformPointBatch(const Vector3* points, const Matrix4x4& m, Vector3* out, size_t n) {
+	Matrix3x4Splat splat = Splat(m);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		Vector3x4 result = MultiplyDirection4(Load4(points + i), splat);
+		result.x = _mm_add_ps(result.x, splat.m[3][0]);
+		result.y = _mm_add_ps(result.y, splat.m[3][1]);
+		result.z = _mm_add_ps(result.z, splat.m[3][2]);
+		Store4(out + i, result);
+	}
+	for (; i < n; ++i) {
+		const Vector3& p = points[i];
+		out[i] = {
+		    p.x * m.m[0][0] + p.y * m.m[1][0] + p.z * m.m[2][0] + m.m[3][0],
+		    p.x * m.m[0][1] + p.y * m.m[1][1] + p.z * m.m[2][1] + m.m[3][1],
+		    p.x * m.m[0][2] + p.y * m.m[1][2] + p.z * m.m[2][2] + m.m[3][2],
+		};
+	}
+}
+
+void TransformDirectionBatch(const Vector3* directions, const Matrix4x4& m, Vector3* out, size_t n) {
+	Matrix3x4Splat splat = Splat(m);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		Store4(out + i, MultiplyDirection4(Load4(directions + i), splat));
+	}
+	for (; i < n; ++i) {
+		const Vector3& d = directions[i];
+		out[i] = {
+		    d.x * m.m[0][0] + d.y * m.m[1][0] + d.z * m.m[2][0],
+		    d.x * m.m[0][1] + d.y * m.m[1][1] + d.z * m.m[2][1],
+		    d.x * m.m[0][2] + d.y * m.m[1][2] + d.z * m.m[2][2],
+		};
+	}
+}
+
+void TransformNormalBatch(const Vector3* normals, const Matrix4x4& m, Vector3* out, size_t n) {
+	Matrix3x4Splat splat = Splat(m);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		Store4(out + i, Normalize4(MultiplyDirection4(Load4(normals + i), splat)));
+	}
+	if (i < n) {
+		TransformDirectionBatch(normals + i, m, out + i, n - i);
+		for (; i < n; ++i) {
+			out[i] = NormalizeFast(out[i]);
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "MathTypes.h"
+#include <cstddef>
+
+// SSEを使ったベクトル演算
+// 加算・スカラー倍などの1つずつの演算はMathConstexpr.hの演算子を使う
+// ここでは逆数平方根を使う正規化と、配列をまとめて処理する関数を用意する
+// (法線やメッシュの頂点など、数千個単位で処理するもの向け)
+
+// 逆数平方根の近似 + ニュートン法1回での正規化(相対誤差 約1e-6)
+// 長さ0のベクトルは0ベクトルを返す
+Vector3 NormalizeFast(const Vector3& v);
+Vector4 NormalizeFast(const Vector4& v);
+
+// 配列をまとめて計算する版(outは入力と同じ配列でもよい)
+void AddBatch(const Vector3* a, const Vector3* b, Vector3* out, size_t n);
+void ScaleBatch(const Vector3* v, float s, Vector3* out, size_t n);
+void DotBatch(const Vector3* a, const Vector3* b, float* out, size_t n);
+void CrossBatch(const Vector3* a, const Vector3* b, Vector3* out, size_t n);
+void NormalizeBatch(const Vector3* v, Vector3* out, size_t n);
+
+// 座標の変換(mはアフィン変換として扱い、wでは割らない)
+void TransformPointBatch(const Vector3* points, const Matrix4x4& m, Vector3* out, size_t n);
+// 向きの変換(mの3x3部分だけを使う)
+void TransformDirectionBatch(const Vector3* directions, const Matrix4x4& m, Vector3* out, size_t n);
+// 法線の変換(向きを変換してから正規化する。拡縮が不均一な場合は逆転置行列を渡す)
+void TransformNormalBatch(const Vector3* normals, const Matrix4x4& m, Vector3* out, size_t n);
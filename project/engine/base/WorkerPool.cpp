@@ -0,0 +1,102 @@
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cassert>
+
+// スレッドを作る
+WorkerPool::WorkerPool(uint32_t threadCount) {
+	if (threadCount == 0) {
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	// 呼ぶスレッドも範囲を取るので、作るのは1つ少なくてよい
+	threads_.reserve(threadCount - 1);
+	for (uint32_t i = 1; i < threadCount; ++i) {
+		threads_.emplace_back([this]() { WorkerMain(); });
+	}
+}
+
+// スレッドを止める
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isExiting_ = true;
+	}
+	startCondition_.notify_all();
+	for (std::thread& thread : threads_) {
+		thread.join();
+	}
+}
+
+// [0, count)をchunkSizeずつ並列に実行する
+void WorkerPool::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& func) {
+	assert(chunkSize > 0);
+	if (count == 0) {
+		return;
+	}
+	size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+	// 分けられなければスレッドを起こさない
+	if (chunkCount == 1 || threads_.empty()) {
+		for (size_t begin = 0; begin < count; begin += chunkSize) {
+			func(begin, std::min(begin + chunkSize, count));
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		assert(func_ == nullptr && "ParallelFor cannot be nested");
+		func_ = &func;
+		count_ = count;
+		chunkSize_ = chunkSize;
+		chunkCount_ = chunkCount;
+		nextChunk_.store(0, std::memory_order_relaxed);
+		busyWorkerCount_ = static_cast<uint32_t>(threads_.size());
+		++generation_;
+	}
+	startCondition_.notify_all();
+
+	// このスレッドも範囲を取る
+	RunChunks();
+
+	// ワーカーが全員終わるまで待つ(終わる前に次の仕事を渡すと、前の仕事を見ているワーカーが混ざる)
+	std::unique_lock<std::mutex> lock(mutex_);
+	finishCondition_.wait(lock, [this]() { return busyWorkerCount_ == 0; });
+	func_ = nullptr;
+}
+
+// ワーカースレッドの処理
+void WorkerPool::WorkerMain() {
+	uint64_t generation = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			startCondition_.wait(lock, [&]() { return isExiting_ || generation_ != generation; });
+			if (isExiting_) {
+				return;
+			}
+			generation = generation_;
+		}
+
+		RunChunks();
+
+		bool isLast;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			isLast = --busyWorkerCount_ == 0;
+		}
+		if (isLast) {
+			finishCondition_.notify_one();
+		}
+	}
+}
+
+// 残っている範囲を取って実行する
+void WorkerPool::RunChunks() {
+	while (true) {
+		size_t chunk = nextChunk_.fetch_add(1, std::memory_order_relaxed);
+		if (chunk >= chunkCount_) {
+			return;
+		}
+		size_t begin = chunk * chunkSize_;
+		(*func_)(begin, std::min(begin + chunkSize_, count_));
+	}
+}
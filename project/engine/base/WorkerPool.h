@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 作ったままにしておくワーカースレッド
+// 毎フレームの並列処理のたびにスレッドを作ると、作る時間の方が長くなるので使い回す
+//
+// ParallelForは[0, count)をchunkSizeずつの範囲に分け、呼んだスレッドも含めて空いたスレッドから順に取って実行する
+// 範囲の分け方はスレッド数によらないので、範囲ごとに書き込み先を分ければ結果は毎回同じになる
+class WorkerPool {
+public:
+	// threadCountは呼ぶスレッドを含めた数(0ならハードウェアのスレッド数)
+	explicit WorkerPool(uint32_t threadCount = 0);
+	~WorkerPool();
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// 呼ぶスレッドを含めたスレッド数
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(threads_.size()) + 1; }
+
+	// [0, count)をchunkSizeずつ並列に実行する(func(begin, end))
+	// 範囲が1つしかなければこのスレッドでそのまま実行する。funcの中からParallelForは呼べない
+	void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& func);
+
+private:
+	// ワーカースレッドの処理
+	void WorkerMain();
+	// 残っている範囲を取って実行する
+	void RunChunks();
+
+	std::vector<std::thread> threads_;
+	std::mutex mutex_;
+	// 仕事が来た・ワーカーが全員終わった
+	std::condition_variable startCondition_;
+	std::condition_variable finishCondition_;
+
+	// 実行中の仕事
+	const std::function<void(size_t, size_t)>* func_ = nullptr;
+	size_t count_ = 0;
+	size_t chunkSize_ = 0;
+	size_t chunkCount_ = 0;
+	// 次に取る範囲の番号
+	std::atomic<size_t> nextChunk_ = 0;
+	// 仕事を渡した回数(ワーカーは前回と違えば起きる)
+	uint64_t generation_ = 0;
+	// まだ終わっていないワーカー数
+	uint32_t busyWorkerCount_ = 0;
+	bool isExiting_ = false;
+};
@@ -0,0 +1,251 @@
+#include "SceneGraph.h"
+#include <algorithm>
+#include <cassert>
+
+// ノードの作成
+SceneNodeId SceneGraph::CreateNode(SceneNodeId parent, const Transform& localTransform) {
+	uint32_t parentIndex = parent == kInvalidSceneNode ? kNoParent : IndexOf(parent);
+
+	SceneNodeId id;
+	if (!freeIds_.empty()) {
+		id = freeIds_.back();
+		freeIds_.pop_back();
+	} else {
+		id = static_cast<SceneNodeId>(indexOfIds_.size());
+		indexOfIds_.push_back(kInvalidSceneNode);
+	}
+
+	// 親より後ろに追加するので深さ順は崩れない
+	uint32_t index = static_cast<uint32_t>(nodeIds_.size());
+	indexOfIds_[id] = index;
+	nodeIds_.push_back(id);
+	parentIndices_.push_back(parentIndex);
+	localTransforms_.push_back(localTransform);
+	worldMatrices_.push_back(kIdentity4x4);
+	worldGenerations_.push_back(0);
+	isLocalDirty_.push_back(0);
+	updatedFrames_.push_back(0);
+	MarkDirty(index);
+	return id;
+}
+
+// ノードの削除
+void SceneGraph::DestroyNode(SceneNodeId node) {
+	// 子孫が後ろにある前提で探すので、先に並べ直しておく
+	if (isOrderDirty_) {
+		SortByDepth();
+	}
+	uint32_t first = IndexOf(node);
+
+	// 子孫は必ず後ろにあるので、前から順に親が削除対象なら削除する
+	std::vector<uint8_t> isRemoved(nodeIds_.size(), 0);
+	isRemoved[first] = 1;
+	for (uint32_t i = first + 1; i < nodeIds_.size(); ++i) {
+		if (parentIndices_[i] != kNoParent && isRemoved[parentIndices_[i]]) {
+			isRemoved[i] = 1;
+		}
+	}
+
+	// 残すノードを前に詰める(並び順は保たれる)
+	std::vector<uint32_t> newIndices(nodeIds_.size(), kNoParent);
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < nodeIds_.size(); ++i) {
+		if (isRemoved[i]) {
+			indexOfIds_[nodeIds_[i]] = kInvalidSceneNode;
+			freeIds_.push_back(nodeIds_[i]);
+			continue;
+		}
+		newIndices[i] = count;
+		nodeIds_[count] = nodeIds_[i];
+		parentIndices_[count] = parentIndices_[i] == kNoParent ? kNoParent : newIndices[parentIndices_[i]];
+		localTransforms_[count] = localTransforms_[i];
+		worldMatrices_[count] = worldMatrices_[i];
+		worldGenerations_[count] = worldGenerations_[i];
+		isLocalDirty_[count] = isLocalDirty_[i];
+		updatedFrames_[count] = updatedFrames_[i];
+		indexOfIds_[nodeIds_[count]] = count;
+		++count;
+	}
+	nodeIds_.resize(count);
+	parentIndices_.resize(count);
+	localTransforms_.resize(count);
+	worldMatrices_.resize(count);
+	worldGenerations_.resize(count);
+	isLocalDirty_.resize(count);
+	updatedFrames_.resize(count);
+
+	// 位置がずれたので、未計算のノードが残っていれば削除した位置から見直す
+	firstDirtyIndex_ = firstDirtyIndex_ < isRemoved.size() ? std::min(firstDirtyIndex_, first) : count;
+}
+
+// 親の変更
+void SceneGraph::SetParent(SceneNodeId node, SceneNodeId parent) {
+	uint32_t index = IndexOf(node);
+	uint32_t parentIndex = parent == kInvalidSceneNode ? kNoParent : IndexOf(parent);
+	if (parentIndices_[index] == parentIndex) {
+		return;
+	}
+
+	// 自分の子孫を親にはできない
+	for (uint32_t i = parentIndex; i != kNoParent; i = parentIndices_[i]) {
+		assert(i != index);
+	}
+
+	parentIndices_[index] = parentIndex;
+	MarkDirty(index);
+	// 親が後ろにあると深さ順が崩れる
+	if (parentIndex != kNoParent && parentIndex > index) {
+		isOrderDirty_ = true;
+	}
+}
+
+// 親のgetter
+SceneNodeId SceneGraph::GetParent(SceneNodeId node) const {
+	uint32_t parentIndex = parentIndices_[IndexOf(node)];
+	return parentIndex == kNoParent ? kInvalidSceneNode : nodeIds_[parentIndex];
+}
+
+// ローカルTransformのsetter
+void SceneGraph::SetLocalTransform(SceneNodeId node, const Transform& transform) {
+	uint32_t index = IndexOf(node);
+	Transform& local = localTransforms_[index];
+	if (local.scale == transform.scale && local.rotate == transform.rotate && local.translate == transform.translate) {
+		return;
+	}
+	local = transform;
+	MarkDirty(index);
+}
+
+void SceneGraph::SetScale(SceneNodeId node, const Vector3& scale) {
+	uint32_t index = IndexOf(node);
+	if (localTransforms_[index].scale == scale) {
+		return;
+	}
+	localTransforms_[index].scale = scale;
+	MarkDirty(index);
+}
+
+void SceneGraph::SetRotate(SceneNodeId node, const Vector3& rotate) {
+	uint32_t index = IndexOf(node);
+	if (localTransforms_[index].rotate == rotate) {
+		return;
+	}
+	localTransforms_[index].rotate = rotate;
+	MarkDirty(index);
+}
+
+void SceneGraph::SetTranslate(SceneNodeId node, const Vector3& translate) {
+	uint32_t index = IndexOf(node);
+	if (localTransforms_[index].translate == translate) {
+		return;
+	}
+	localTransforms_[index].translate = translate;
+	MarkDirty(index);
+}
+
+// World行列の計算
+void SceneGraph::Update() {
+	recomputedNodeCount_ = 0;
+	++frame_;
+
+	if (isOrderDirty_) {
+		SortByDepth();
+	}
+
+	// 何も変わっていなければ何もしない
+	uint32_t count = static_cast<uint32_t>(nodeIds_.size());
+	if (firstDirtyIndex_ >= count) {
+		return;
+	}
+
+	// 親は必ず前にあるので、前から順に計算すれば親のWorld行列は計算済み
+	for (uint32_t i = firstDirtyIndex_; i < count; ++i) {
+		uint32_t parentIndex = parentIndices_[i];
+		bool isParentUpdated = parentIndex != kNoParent && updatedFrames_[parentIndex] == frame_;
+		if (!isLocalDirty_[i] && !isParentUpdated) {
+			continue;
+		}
+
+		const Transform& local = localTransforms_[i];
+		Matrix4x4 localMatrix = MakeAffineMatrix(local.scale, local.rotate, local.translate);
+		worldMatrices_[i] = parentIndex == kNoParent ? localMatrix : Multiply(localMatrix, worldMatrices_[parentIndex]);
+		++worldGenerations_[i];
+		isLocalDirty_[i] = 0;
+		updatedFrames_[i] = frame_;
+		++recomputedNodeCount_;
+	}
+	firstDirtyIndex_ = count;
+}
+
+// IDから配列の位置を求める
+uint32_t SceneGraph::IndexOf(SceneNodeId node) const {
+	assert(node < indexOfIds_.size());
+	uint32_t index = indexOfIds_[node];
+	assert(index != kInvalidSceneNode);
+	return index;
+}
+
+// ローカルTransformが変わったことを記録する
+void SceneGraph::MarkDirty(uint32_t index) {
+	isLocalDirty_[index] = 1;
+	firstDirtyIndex_ = std::min(firstDirtyIndex_, index);
+}
+
+// 深さ順に並べ直す
+void SceneGraph::SortByDepth() {
+	uint32_t count = static_cast<uint32_t>(nodeIds_.size());
+
+	// 各ノードの深さ(親をたどった回数)
+	std::vector<uint32_t> depths(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		uint32_t depth = 0;
+		for (uint32_t p = parentIndices_[i]; p != kNoParent; p = parentIndices_[p]) {
+			++depth;
+		}
+		depths[i] = depth;
+	}
+
+	// 同じ深さの中では今の並びを保つ
+	std::vector<uint32_t> order(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return depths[a] < depths[b]; });
+
+	std::vector<uint32_t> newIndices(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		newIndices[order[i]] = i;
+	}
+
+	std::vector<SceneNodeId> nodeIds(count);
+	std::vector<uint32_t> parentIndices(count);
+	std::vector<Transform> localTransforms(count);
+	std::vector<Matrix4x4> worldMatrices(count);
+	std::vector<uint32_t> worldGenerations(count);
+	std::vector<uint8_t> isLocalDirty(count);
+	std::vector<uint32_t> updatedFrames(count);
+	firstDirtyIndex_ = count;
+	for (uint32_t i = 0; i < count; ++i) {
+		uint32_t from = order[i];
+		nodeIds[i] = nodeIds_[from];
+		parentIndices[i] = parentIndices_[from] == kNoParent ? kNoParent : newIndices[parentIndices_[from]];
+		localTransforms[i] = localTransforms_[from];
+		worldMatrices[i] = worldMatrices_[from];
+		worldGenerations[i] = worldGenerations_[from];
+		isLocalDirty[i] = isLocalDirty_[from];
+		updatedFrames[i] = updatedFrames_[from];
+		indexOfIds_[nodeIds[i]] = i;
+		if (isLocalDirty[i]) {
+			firstDirtyIndex_ = std::min(firstDirtyIndex_, i);
+		}
+	}
+	nodeIds_.swap(nodeIds);
+	parentIndices_.swap(parentIndices);
+	localTransforms_.swap(localTransforms);
+	worldMatrices_.swap(worldMatrices);
+	worldGenerations_.swap(worldGenerations);
+	isLocalDirty_.swap(isLocalDirty);
+	updatedFrames_.swap(updatedFrames);
+
+	isOrderDirty_ = false;
+}
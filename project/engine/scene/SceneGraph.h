@@ -0,0 +1,83 @@
+#pragma once
+#include "base/Math.h"
+#include "base/MathTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ノードのID(配列の並びが変わっても変わらない)
+using SceneNodeId = uint32_t;
+inline constexpr SceneNodeId kInvalidSceneNode = UINT32_MAX;
+
+// 親子関係を持つTransformの階層
+// ノードは深さ順(親が必ず子より前)の配列に並べて持ち、
+// ローカルTransformが変わったノードとその子孫だけWorld行列を計算し直す
+class SceneGraph {
+public:
+	// ノードの作成(parentがkInvalidSceneNodeならルート)
+	SceneNodeId CreateNode(SceneNodeId parent = kInvalidSceneNode, const Transform& localTransform = {{1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}});
+	// ノードの削除(子孫もまとめて削除する)
+	void DestroyNode(SceneNodeId node);
+
+	// 親の変更
+	void SetParent(SceneNodeId node, SceneNodeId parent);
+	// 親のgetter
+	SceneNodeId GetParent(SceneNodeId node) const;
+
+	// ローカルTransformのgetter
+	const Transform& GetLocalTransform(SceneNodeId node) const { return localTransforms_[IndexOf(node)]; }
+	// ローカルTransformのsetter(値が変わったときだけ計算し直す)
+	void SetLocalTransform(SceneNodeId node, const Transform& transform);
+	void SetScale(SceneNodeId node, const Vector3& scale);
+	void SetRotate(SceneNodeId node, const Vector3& rotate);
+	void SetTranslate(SceneNodeId node, const Vector3& translate);
+
+	// World行列の計算(変更があったノードとその子孫だけ)
+	void Update();
+
+	// World行列のgetter(Update後の値)
+	const Matrix4x4& GetWorldMatrix(SceneNodeId node) const { return worldMatrices_[IndexOf(node)]; }
+	// World行列を計算し直すたびに増える番号
+	// 取り付けたオブジェクトは前回の値と比べて、変わっていなければ自分の計算を省ける
+	uint32_t GetWorldGeneration(SceneNodeId node) const { return worldGenerations_[IndexOf(node)]; }
+
+	// ノード数のgetter
+	size_t GetNodeCount() const { return nodeIds_.size(); }
+	// 直前のUpdateでWorld行列を計算し直したノード数
+	uint32_t GetRecomputedNodeCount() const { return recomputedNodeCount_; }
+
+private:
+	// 親がないことを表す配列の位置
+	static constexpr uint32_t kNoParent = UINT32_MAX;
+
+	// IDから配列の位置を求める
+	uint32_t IndexOf(SceneNodeId node) const;
+	// ローカルTransformが変わったことを記録する
+	void MarkDirty(uint32_t index);
+	// 深さ順に並べ直す
+	void SortByDepth();
+
+	// 以下は深さ順に並んだ配列(同じ位置が同じノード)
+	std::vector<SceneNodeId> nodeIds_;
+	std::vector<uint32_t> parentIndices_;
+	std::vector<Transform> localTransforms_;
+	std::vector<Matrix4x4> worldMatrices_;
+	std::vector<uint32_t> worldGenerations_;
+	// ローカルTransformが変わったか
+	std::vector<uint8_t> isLocalDirty_;
+	// World行列を最後に計算したUpdateの番号
+	std::vector<uint32_t> updatedFrames_;
+
+	// IDから配列の位置への対応(削除済みはkInvalidSceneNode)
+	std::vector<uint32_t> indexOfIds_;
+	// 再利用できるID
+	std::vector<SceneNodeId> freeIds_;
+
+	// ここより前のノードは変更がない(変更がなければノード数)
+	uint32_t firstDirtyIndex_ = 0;
+	// 親の変更で並べ直しが必要か
+	bool isOrderDirty_ = false;
+	// Updateを呼んだ回数
+	uint32_t frame_ = 0;
+	uint32_t recomputedNodeCount_ = 0;
+};
@@ -25,8 +25,21 @@
 //#include <d3d12shader.h>
 //#include <wrl.h>
 #include "2d/SpriteCommon.h"
-#include "2d/SpriteTransform.h"
-#include "2d/Sprite.h"
+#include "2d/SpriteBatch.h"
+#include "2d/SpriteBroadphase.h"
+#include "2d/SpriteRenderQueue.h"
+#include "2d/BitmapFont.h"
+#include "2d/NineSliceSprite.h"
+#include "2d/TextBuilder.h"
+#include "2d/InstancedSpriteBatch.h"
+#include "2d/Tilemap.h"
+#include "2d/TilemapRenderer.h"
+#include "2d/FlipbookSystem.h"
+#include "2d/TweenSystem.h"
+#include "2d/Camera2D.h"
+#include "3d/Camera3D.h"
+#include "scene/SceneGraph.h"
+#include "base/VectorMath.h"
 
 #define DIRECTINPUT_VERSION 0x0800 // DirectInputのバージョン指定
 #include <dinput.h>
@@ -35,6 +48,7 @@
 #include "engine/base/DirectXCommon.h"
 #include <CommCtrl.h>
 #include "base/TextureManager.h"
+#include "base/WorkerPool.h"
 
 // デバッグ用
 #pragma comment(lib, "Dbghelp.lib")
@@ -62,6 +76,7 @@ struct Material {
 struct TransformationMatrix {
 	Matrix4x4 WVP;
 	Matrix4x4 World;
+	Matrix4x4 WorldInverseTranspose;
 };
 
 struct DirectionalLight {
@@ -95,13 +110,6 @@ struct D3DResourceLeakChecker {
 	}
 };
 
-Vector3 Normalize(const Vector3& v) {
-	float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-	if (length == 0.0f)
-		return {0.0f, 0.0f, 0.0f};
-	return {v.x / length, v.y / length, v.z / length};
-}
-
 static LONG WINAPI ExportDump(EXCEPTION_POINTERS* exception) {
 	SYSTEMTIME time;
 	GetLocalTime(&time);
@@ -581,8 +589,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	TextureManager::GetInstance()->Initialize(directXCommon);
 
 	// テクスチャ呼び出し
-	TextureManager::GetInstance()->LoadTexture("Resources/yukkuri_doyagao.png");
-	TextureManager::GetInstance()->LoadTexture("Resources/uvChecker.png");
+	// スプライト用の画像は1枚のアトラスにまとめる(テクスチャが切り替わらないのでバッチが途切れない)
+	// 詰めた結果はキャッシュに書き出し、画像が変わっていなければ次回からはそれを読む
+	TextureManager::GetInstance()->LoadAtlas({"Resources/yukkuri_doyagao.png", "Resources/uvChecker.png"}, "Resources/spriteAtlas.cache");
 
 
 	// Inputの初期化
@@ -595,25 +604,99 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	spriteCommon = new SpriteCommon;
 	spriteCommon->Initialize(directXCommon);
 
+	// スプライト用カメラの初期化
+	Camera2D* camera2D = new Camera2D();
+	camera2D->Initialize(float(WindowsAPI::kClientWidth), float(WindowsAPI::kClientHeight));
+	spriteCommon->SetDefaultCamera(camera2D);
+
+	// スプライトをまとめて描画する(テクスチャが同じスプライトは1回のDrawCallで描く)
+	const uint32_t kMaxBatchSprites = 10000;
+	SpriteBatch* spriteBatch = new SpriteBatch();
+	spriteBatch->Initialize(spriteCommon, kMaxBatchSprites);
+	// インスタンシングでまとめて描画する(ブレンドモードごとに1回のDrawCall)
+	InstancedSpriteBatch* instancedSpriteBatch = new InstancedSpriteBatch();
+	instancedSpriteBatch->Initialize(spriteCommon, kMaxBatchSprites);
+	// HUDの文字(Windowsのフォントから英数字・かなと、使う漢字だけをアトラスに焼き込む)
+	// 文字列はTextBuilderがキャッシュするので、変わらない文字列は毎フレーム頂点をコピーするだけ
+	const std::string kHudFontPath = "C:/Windows/Fonts/msgothic.ttc";
+	BitmapFont* hudFont = nullptr;
+	TextBuilder* hudText = nullptr;
+	uint32_t hudFontTextureIndex = 0;
+	if (std::filesystem::exists(kHudFontPath)) {
+		std::ifstream fontFile(kHudFontPath, std::ios::binary);
+		std::vector<uint8_t> fontData((std::istreambuf_iterator<char>(fontFile)), std::istreambuf_iterator<char>());
+		hudFont = new BitmapFont();
+		bool isBuilt = hudFont->Build(fontData, {BitmapFont::kBasicLatin, BitmapFont::kJapanesePunctuation, BitmapFont::kHiraganaKatakana}, "描画中表示枚", {24.0f});
+		assert(isBuilt && "Font build failed");
+		(void)isBuilt;
+		hudFontTextureIndex = TextureManager::GetInstance()->LoadAtlasPages(hudFont->GetAtlas(), kHudFontPath);
+		hudText = new TextBuilder(*hudFont);
+	}
+	// HUDの文字の下に敷くパネル(9分割で四隅の大きさを保ったまま伸ばす。16頂点のメッシュ1つでSpriteBatchに積む)
+	NineSliceSprite* hudPanel = new NineSliceSprite(spriteCommon->FindTextureRegion("Resources/uvChecker.png"), {64.0f, 64.0f, 64.0f, 64.0f});
+	hudPanel->SetPosition({8.0f, float(WindowsAPI::kClientHeight) - 88.0f});
+	hudPanel->SetSize({360.0f, 80.0f});
+	hudPanel->SetColor({1.0f, 1.0f, 1.0f, 0.6f});
+	// 背景のタイルマップ(1024x1024タイル。uvCheckerを4x4に分けたものをタイルセットにする)
+	// チャンクごとに頂点を作って置いておき、映るチャンクだけチャンクごとに1回のDrawCallで描く
+	const uint32_t kTilemapSize = 1024;
+	Tilemap* tilemap = new Tilemap(kTilemapSize, kTilemapSize, {32.0f, 32.0f}, spriteCommon->FindTextureRegion("Resources/uvChecker.png"), 4, 4);
+	for (uint32_t y = 0; y < kTilemapSize; ++y) {
+		for (uint32_t x = 0; x < kTilemapSize; ++x) {
+			tilemap->SetTile(x, y, (x + y) % 11 == 0 ? kEmptyTile : static_cast<TileId>((x * 7 + y * 13) % 16 + 1));
+		}
+	}
+	tilemap->SetColor({0.5f, 0.5f, 0.5f, 1.0f});
+	// 1チャンクは1024x1024ピクセルなので、画面には多くても3x2チャンク(カメラを縮小するなら増やす)
+	TilemapRenderer* tilemapRenderer = new TilemapRenderer();
+	tilemapRenderer->Initialize(spriteCommon, 16);
+	// スプライトの当たり判定の候補(範囲が重なっている組)を毎フレーム求める
+	SpriteBroadphase* spriteBroadphase = new SpriteBroadphase();
+	// 見えているスプライトをレイヤーごとに不透明・半透明(奥から手前)の順に並べる(並べた順にバッチに積む)
+	SpriteRenderQueue* spriteRenderQueue = new SpriteRenderQueue();
+	// スプライトの描画方法 1:SpriteBatch 2:インスタンシング
+	// (1枚ずつ描くSprite::DrawはSpriteを持つ側で使う。ここではハンドルだけ持つので使わない)
+	int spriteDrawMode = 1;
+
+	// シーングラフ(スプライトはまとめて動かせるようにルートノードに取り付ける)
+	SceneGraph* sceneGraph = new SceneGraph();
+	Transform spriteRootTransform{
+	    {1.0f, 1.0f, 1.0f},
+        {0.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f}
+    };
+	SceneNodeId spriteRootNode = sceneGraph->CreateNode(kInvalidSceneNode, spriteRootTransform);
+
+	// スプライトの更新と頂点の書き込みを分けて行うワーカースレッド
+	WorkerPool* workerPool = new WorkerPool();
+
 	// スプライトの複数化
-	std::vector<Sprite*> sprites_;
-	std::vector<SpriteTransform*> spriteTransforms_;
+	// 状態はSpriteSystemが配列にまとめて持つので、ここではハンドルだけ持つ
+	SpriteSystem* spriteSystem = spriteCommon->GetSpriteSystem();
+	std::vector<SpriteHandle> spriteHandles;
 	std::vector<std::string> texturePaths = {"Resources/yukkuri_doyagao.png", "Resources/uvChecker.png"};
 	for (uint32_t i = 0; i < 5; ++i) {
-		Sprite* sprite = new Sprite();
-		sprite->Initialize(spriteCommon, texturePaths[i%2]);
+		SpriteHandle sprite = spriteCommon->CreateSprite(texturePaths[i%2]);
 
 		 // 座標をそれぞれ変える
-		sprite->SetPosition({0.0f + i * 150.0f, 0.0f});
+		spriteSystem->SetPosition(sprite, {0.0f + i * 150.0f, 0.0f});
 		// スプライトのサイズを変える
-		sprite->SetSize({75.0f, 75.0f});
-		sprites_.push_back(sprite);
-
-		SpriteTransform* transform = new SpriteTransform();
-		transform->Initialize(sprite);
-		spriteTransforms_.push_back(transform);
+		spriteSystem->SetSize(sprite, {75.0f, 75.0f});
+		spriteSystem->SetParentNode(sprite, sceneGraph, spriteRootNode);
+		spriteHandles.push_back(sprite);
 	}
 
+	// パラパラアニメ(uvCheckerを4x4のコマに分けて、往復とループで再生する)
+	// 60FPS固定なので1フレームの経過時間も固定
+	const float kDeltaTime = 1.0f / 60.0f;
+	FlipbookSystem* flipbookSystem = new FlipbookSystem();
+	FlipbookClipId checkerClip = flipbookSystem->CreateGridClip(spriteCommon->FindTextureRegion("Resources/uvChecker.png"), 4, 4, 16, 8.0f);
+	flipbookSystem->Play(spriteHandles[1], checkerClip, FlipbookPlayMode::kPingPong);
+	flipbookSystem->Play(spriteHandles[3], checkerClip, FlipbookPlayMode::kLoop, 0.5f);
+
+	// スプライトの移動・回転・色・拡縮はTweenでまとめて動かす
+	TweenSystem* tweenSystem = new TweenSystem();
+
 	
 
 
@@ -1233,6 +1316,12 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
         {0.0f, 0.0f, -5.0f}
     };
 
+	// 3Dカメラの初期化
+	Camera3D* camera3D = new Camera3D();
+	camera3D->SetRotate(cameraTransform.rotate);
+	camera3D->SetTranslate(cameraTransform.translate);
+	camera3D->Initialize(0.45f, static_cast<float>(kwindowWidth) / static_cast<float>(kwindowHeight), 0.1f, 100.0f);
+
 	//// SpriteのTransform
 	//Transform transformSprite{
 	//    {1.0f, 1.0f, 1.0f},
@@ -1328,7 +1417,7 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	materialResourceSphere->Map(0, nullptr, reinterpret_cast<void**>(&materialDataSphere));
 	materialDataSphere->enableLighting = true;
 	materialDataSphere->color = {1.0f, 1.0f, 1.0f, 1.0f};
-	materialDataSphere->uvTransform = MakeIdentity4x4();
+	materialDataSphere->uvTransform = kIdentity4x4;
 //
 //
 	//// スプライト用マテリアル（ライティング無効）
@@ -1362,6 +1451,10 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// ==============================
 	// ゲームループ
 	// ==============================
+	// カリング用の作業領域
+	std::vector<Rect2D> spriteBounds;
+	std::vector<uint32_t> visibleSpriteIndices;
+
 	MSG msg{};
 	// ウィンドウの×ボタンが押されるまでループ
 	while (true) {
@@ -1373,32 +1466,112 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 
 		input->Update();
-		for (SpriteTransform* spriteTransform : spriteTransforms_) {
 
-			if (MoveSwitch) {
-				spriteTransform->Move();
+		// カメラの行列再計算回数をリセット
+		Camera2D::ResetMatrixRebuildCount();
+		Camera3D::ResetMatrixRebuildCount();
+		// スプライトを計算し直した数をリセット
+		spriteSystem->ResetRebuildCount();
+		flipbookSystem->ResetFrameChangeCount();
+
+		// スイッチが入っている間はTweenで動かし続け、切ったら今の値で止める
+		for (SpriteHandle sprite : spriteHandles) {
+			if (MoveSwitch != tweenSystem->IsTweening(sprite, TweenProperty::kPosition)) {
+				if (MoveSwitch) {
+					Vector2 position = spriteSystem->GetPosition(sprite);
+					tweenSystem->TweenPosition(*spriteSystem, sprite, {position.x + 100.0f, position.y + 100.0f}, {2.0f, EasingType::kInOutSine, TweenLoopMode::kYoyo});
+				} else {
+					tweenSystem->Cancel(sprite, TweenProperty::kPosition);
+				}
 			}
-			if (RotateSwitch) {
-				spriteTransform->Rotate();
+			if (RotateSwitch != tweenSystem->IsTweening(sprite, TweenProperty::kRotation)) {
+				if (RotateSwitch) {
+					// 1周したら始まりに戻る(同じ向きなのでつながって見える)
+					float rotation = spriteSystem->GetRotation(sprite);
+					tweenSystem->TweenRotation(*spriteSystem, sprite, rotation + 6.28318530f, {4.0f, EasingType::kLinear, TweenLoopMode::kLoop});
+				} else {
+					tweenSystem->Cancel(sprite, TweenProperty::kRotation);
+				}
 			}
-			if (ChangeColorSwitch) {
-				spriteTransform->ChangeColor();
+			if (ChangeColorSwitch != tweenSystem->IsTweening(sprite, TweenProperty::kColor)) {
+				if (ChangeColorSwitch) {
+					tweenSystem->TweenColor(*spriteSystem, sprite, {1.0f, 0.2f, 0.2f, 1.0f}, {1.0f, EasingType::kInOutQuad, TweenLoopMode::kYoyo});
+				} else {
+					tweenSystem->Cancel(sprite, TweenProperty::kColor);
+				}
 			}
-			if (ScaleSwitch) {
-				spriteTransform->Scale();
+			if (ScaleSwitch != tweenSystem->IsTweening(sprite, TweenProperty::kSize)) {
+				if (ScaleSwitch) {
+					Vector2 size = spriteSystem->GetSize(sprite);
+					tweenSystem->TweenSize(*spriteSystem, sprite, {size.x * 1.5f, size.y * 1.5f}, {1.0f, EasingType::kInOutQuad, TweenLoopMode::kYoyo});
+				} else {
+					tweenSystem->Cancel(sprite, TweenProperty::kSize);
+				}
 			}
 		}
+		tweenSystem->Update(kDeltaTime, *spriteSystem);
+
+		// コマが変わったスプライトだけ画像の範囲を差し替える
+		flipbookSystem->Update(kDeltaTime, *spriteSystem);
 
 		directXCommon->PreDraw();
-		for (Sprite* sprite : sprites_) {
-			sprite->Update();
+		// カメラは変更があったときだけ行列を作り直す
+		camera2D->Update();
+		// 動いたノードとその子孫だけWorld行列を計算し直す
+		sceneGraph->Update();
+
+		// 範囲が重なっているスプライトの組(前のフレームの並びから並べ直すので、少しずつ動くなら速い)
+		spriteBroadphase->Update(*spriteSystem, workerPool);
+
+		// 画面内のスプライトだけを残す(番号はSpriteSystemの配列の位置)
+		size_t spriteCount = spriteSystem->GetCount();
+		spriteBounds.resize(spriteCount);
+		visibleSpriteIndices.resize(spriteCount);
+		spriteSystem->ComputeBoundingRects(spriteBounds.data(), *workerPool);
+		size_t visibleSpriteCount = CullRects(camera2D->GetViewRect(), spriteBounds.data(), spriteBounds.size(), visibleSpriteIndices.data());
+
+		spriteSystem->Update(visibleSpriteIndices.data(), visibleSpriteCount, *workerPool);
+
+		// 描く順番に並べる(同じレイヤーの中では同じテクスチャが続くので、DrawCallがまとまる)
+		spriteRenderQueue->Clear();
+		spriteRenderQueue->Push(*spriteSystem, visibleSpriteIndices.data(), visibleSpriteCount);
+		spriteRenderQueue->Sort();
+
+		// HUDの文字
+		if (hudText != nullptr) {
+			hudText->ResetLayoutCount();
+			hudText->Begin();
+			float hudTop = float(WindowsAPI::kClientHeight) - 80.0f;
+			hudText->Add("スプライトを描画中", {16.0f, hudTop}, 1.0f, {1.0f, 1.0f, 1.0f, 1.0f});
+			hudText->Add(std::format("表示 {}/{} 枚", visibleSpriteCount, spriteCount), {16.0f, hudTop + 32.0f}, 1.0f, {1.0f, 1.0f, 0.4f, 1.0f});
 		}
 
-		// Spriteの描画準備。Spriteの描画に共通のグラフィックスコマンドを積む
-		spriteCommon->SetCommonPipelineState();
-		for (Sprite* sprite : sprites_) {
-			sprite->Draw();
+		// 背景のタイルマップ(中身が変わったチャンクと、映り始めたチャンクだけ頂点を作る)
+		tilemapRenderer->ResetRebuildCount();
+		tilemapRenderer->Draw(*tilemap, camera2D->GetViewRect());
+
+		uint32_t spriteDrawCallCount = 0;
+		if (spriteDrawMode == 2) {
+			// 1枚ごとにインスタンスのデータを1つ書き込み、頂点はVertexShaderで作る
+			instancedSpriteBatch->Begin();
+			instancedSpriteBatch->Add(*spriteSystem, spriteRenderQueue->GetValues(), spriteRenderQueue->GetCount(), workerPool);
+			instancedSpriteBatch->End();
+			spriteDrawCallCount = instancedSpriteBatch->GetDrawCallCount();
 		}
+		// 見えているスプライトを1つの頂点バッファに詰めて、テクスチャが変わるところだけDrawCallを積む
+		// HUDの文字も同じ頂点バッファに積む(Beginし直すと描く前の頂点を上書きしてしまうので、1フレームに1回だけ)
+		spriteBatch->Begin();
+		if (spriteDrawMode == 1) {
+			spriteBatch->Add(*spriteSystem, spriteRenderQueue->GetValues(), spriteRenderQueue->GetCount(), workerPool);
+		}
+		// パネルは大きさなどが変わったときだけ頂点を作り直す
+		hudPanel->Update();
+		spriteBatch->Add(*hudPanel);
+		if (hudText != nullptr) {
+			spriteBatch->Add(*hudText, hudFontTextureIndex);
+		}
+		spriteBatch->End();
+		spriteDrawCallCount += spriteBatch->GetDrawCallCount();
 
 
 	//
@@ -1409,9 +1582,27 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 		    ImGui::Begin("Debug");
 		    ImGui::Text("ImGui OK");
+		    ImGui::Text("VisibleSprites:%zu/%zu", visibleSpriteCount, spriteCount);
+		    ImGui::RadioButton("SpriteBatch", &spriteDrawMode, 1);
+		    ImGui::SameLine();
+		    ImGui::RadioButton("Instanced", &spriteDrawMode, 2);
+		    ImGui::Text("SpriteDrawCalls:%u", spriteDrawCallCount);
+		    ImGui::Text("SpriteRebuilt:%u/%zu", spriteSystem->GetRebuildCount(), visibleSpriteCount);
+		    ImGui::Text("SpritePairs:%zu", spriteBroadphase->GetPairs().size());
+		    ImGui::Text(
+		        "TilemapDrawCalls:%u Tiles:%u ChunkRebuilt:%u Skipped:%u", tilemapRenderer->GetDrawCallCount(), tilemapRenderer->GetTileCount(),
+		        tilemapRenderer->GetRebuildCount(), tilemapRenderer->GetSkippedChunkCount());
+		    ImGui::Text("SceneNodeRecomputed:%u/%zu", sceneGraph->GetRecomputedNodeCount(), sceneGraph->GetNodeCount());
+		    ImGui::Text("FlipbookFrameChanged:%u/%u", flipbookSystem->GetFrameChangeCount(), flipbookSystem->GetCount());
+		    if (hudText != nullptr) {
+			    ImGui::Text("TextLayout:%u Glyphs:%u", hudText->GetLayoutCount(), hudText->GetGlyphCount());
+		    }
+		    Vector2 hudPanelSize = hudPanel->GetSize();
+		    if (ImGui::DragFloat2("HudPanelSize", &hudPanelSize.x, 1.0f, 0.0f, 1280.0f)) {
+			    hudPanel->SetSize(hudPanelSize);
+		    }
 		    ImGui::End();
 	//
-			Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, static_cast<float>(kwindowWidth) / static_cast<float>(kwindowHeight), 0.1f, 100.0f);
 	
 			
 			//Matrix4x4 worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
@@ -1421,6 +1612,7 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 			//Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, Multiply(viewMatrix, projectiomMatrix));
 			//wvpData->World = worldMatrix;
 			//wvpData->WVP = worldViewProjectionMatrix;
+			//wvpData->WorldInverseTranspose = ToMatrix4x4(MakeNormalMatrix(worldMatrix));
 	
 			// Sprite用のWorldViewProjectionMatrixを作る
 			//Matrix4x4 worldMatrixSprite = MakeAffineMatrix(transformSprite.scale, transformSprite.rotate, transformSprite.translate);
@@ -1440,6 +1632,10 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 			ImGui::Begin("camera");
 			ImGui::DragFloat3("Camera.translate", &cameraTransform.translate.x, 0.01f, -10.0f, 10.0f);
 			ImGui::DragFloat3("Camera.rotate.", &cameraTransform.rotate.x, 0.01f, -10.0f, 10.0f);
+			camera3D->SetRotate(cameraTransform.rotate);
+			camera3D->SetTranslate(cameraTransform.translate);
+			camera3D->Update();
+			ImGui::Text("MatrixRebuild 2D:%u 3D:%u", Camera2D::GetMatrixRebuildCount(), Camera3D::GetMatrixRebuildCount());
 			ImGui::End();
 	
 			ImGui::Begin("object");
@@ -1449,6 +1645,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 			//ImGui::ColorEdit4("Color", &materialData->color.x);
 			ImGui::ColorEdit4("litingColor", &(directionalLightData->color).x);
 			ImGui::DragFloat3("litingColor.direction", &(directionalLightData->direction).x,0.01f, -10.0f, 10.0f);
+			// ライトの向きは単位ベクトルで渡す
+			directionalLightData->direction = NormalizeFast(directionalLightData->direction);
 			//ImGui::Checkbox("useMonsterBall", &useMonsterBall);
 			ImGui::End();
 	
@@ -1464,8 +1662,30 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		    ImGui::Checkbox("RotateSwitch", &RotateSwitch);
 		    ImGui::Checkbox("ChangeColorSwitch", &ChangeColorSwitch);
 		    ImGui::Checkbox("ScaleSwitch", &ScaleSwitch);
-		    for (int i = 0; i < sprites_.size(); ++i) {
-			    sprites_[i]->spriteImGui(i);
+		    ImGui::DragFloat2("RootTranslate", &spriteRootTransform.translate.x, 1.0f);
+		    ImGui::SliderAngle("RootRotate", &spriteRootTransform.rotate.z);
+		    sceneGraph->SetLocalTransform(spriteRootNode, spriteRootTransform);
+		    for (size_t i = 0; i < spriteHandles.size(); ++i) {
+			    // 変更があったときだけ計算し直すのでsetterを通す
+			    SpriteHandle sprite = spriteHandles[i];
+			    ImGui::PushID(static_cast<int>(i));
+			    bool isFlipX = spriteSystem->GetIsFlipX(sprite);
+			    if (ImGui::Checkbox("IsFlipX", &isFlipX)) {
+				    spriteSystem->SetIsFlipX(sprite, isFlipX);
+			    }
+			    bool isFlipY = spriteSystem->GetIsFlipY(sprite);
+			    if (ImGui::Checkbox("IsFlipY", &isFlipY)) {
+				    spriteSystem->SetIsFlipY(sprite, isFlipY);
+			    }
+			    int layer = spriteSystem->GetLayer(sprite);
+			    if (ImGui::SliderInt("Layer", &layer, 0, 3)) {
+				    spriteSystem->SetLayer(sprite, static_cast<uint8_t>(layer));
+			    }
+			    Vector2 textureCutSize = spriteSystem->GetTextureCutSize(sprite);
+			    if (ImGui::DragFloat2("TextureCutSize", &textureCutSize.x, 1.0f, 0.0f, 4096.0f)) {
+				    spriteSystem->SetTextureCutSize(sprite, textureCutSize);
+			    }
+			    ImGui::PopID();
 		    }
 		    ImGui::End();
 	
@@ -1642,14 +1862,22 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	delete input;
 	delete windowsAPI;
 	delete directXCommon;	
+	delete instancedSpriteBatch;
+	delete spriteBatch;
 	delete spriteCommon;
-	// 複数化したSpriteの解放
-	for (Sprite* sprite : sprites_) {
-	    delete sprite;
-	}
-	for (SpriteTransform* SpriteTransform : spriteTransforms_) {
-		delete SpriteTransform;
-	}
+	delete camera2D;
+	delete camera3D;
+	delete sceneGraph;
+	delete workerPool;
+	delete flipbookSystem;
+	delete tweenSystem;
+	delete hudText;
+	delete hudPanel;
+	delete spriteRenderQueue;
+	delete spriteBroadphase;
+	delete tilemapRenderer;
+	delete tilemap;
+	delete hudFont;
 
 	return 0;
 }
@@ -4,7 +4,9 @@
 struct TransformationMatrix
 {  
     float32_t4x4 WVP;
-    float32_t4x4 World;    
+    float32_t4x4 World;
+    // 法線変換用(Worldの逆転置行列)。拡縮が不均一でも法線が面に垂直なままになる
+    float32_t4x4 WorldInverseTranspose;
 };
 ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
 
@@ -21,7 +23,7 @@ VertexShaderOutput main(VertexShaderInput input)
     VertexShaderOutput output;
     output.position = mul(input.position, gTransformationMatrix.WVP);
     output.texcoord = input.texcoord;
-    output.normal = normalize(mul(input.normal, (float32_t3x3) gTransformationMatrix.World));
+    output.normal = normalize(mul(input.normal, (float32_t3x3) gTransformationMatrix.WorldInverseTranspose));
     return output;
 }
 
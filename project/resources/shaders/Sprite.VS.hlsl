@@ -0,0 +1,24 @@
+#include "Sprite.hlsli"
+
+// SpriteBatch用。頂点はWorld変換済みなのでViewProjectionだけ掛ける
+struct ViewProjection
+{
+    float32_t4x4 matrix;
+};
+ConstantBuffer<ViewProjection> gViewProjection : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t4 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t4 color : COLOR0;
+};
+
+VertexShaderOutput main(VertexShaderInput input)
+{
+    VertexShaderOutput output;
+    output.position = mul(input.position, gViewProjection.matrix);
+    output.texcoord = input.texcoord;
+    output.color = input.color;
+    return output;
+}
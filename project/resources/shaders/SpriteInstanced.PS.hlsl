@@ -0,0 +1,19 @@
+#include "SpriteInstanced.hlsli"
+
+// TextureManagerのテクスチャ全部(テクスチャ番号で引く)
+Texture2D<float32_t4> gTextures[] : register(t0);
+SamplerState gSampler : register(s0);
+
+struct PixelShaderOutput
+{
+    float32_t4 color : SV_TARGET0;
+};
+
+PixelShaderOutput main(VertexShaderOutput input)
+{
+    PixelShaderOutput output;
+    // 1回のDrawCallの中でスプライトごとにテクスチャが変わる
+    Texture2D<float32_t4> texture = gTextures[NonUniformResourceIndex(input.textureIndex)];
+    output.color = input.color * texture.Sample(gSampler, input.texcoord);
+    return output;
+}
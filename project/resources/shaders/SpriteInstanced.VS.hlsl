@@ -0,0 +1,43 @@
+#include "SpriteInstanced.hlsli"
+
+// インスタンシング用。1枚分のデータをSV_InstanceIDで取り出し、4頂点に広げる
+// 並びはC++側のSpriteInstanceと同じ
+struct SpriteInstance
+{
+    float32_t4 axes;
+    float32_t2 translate;
+    float32_t depth;
+    uint32_t textureIndex;
+    float32_t4 uvRect;
+    float32_t4 color;
+};
+StructuredBuffer<SpriteInstance> gInstances : register(t0, space1);
+
+struct ViewProjection
+{
+    float32_t4x4 matrix;
+};
+ConstantBuffer<ViewProjection> gViewProjection : register(b0);
+
+// SV_InstanceIDはStartInstanceLocationを含まないので、範囲の先頭を別に渡す
+struct DrawRange
+{
+    uint32_t firstInstance;
+};
+ConstantBuffer<DrawRange> gDrawRange : register(b1);
+
+VertexShaderOutput main(uint32_t vertexId : SV_VertexID, uint32_t instanceId : SV_InstanceID)
+{
+    SpriteInstance instance = gInstances[gDrawRange.firstInstance + instanceId];
+
+    // 頂点の順番はSpriteと同じ 左下(0,1)・左上(0,0)・右下(1,1)・右上(1,0)
+    float32_t2 corner = float32_t2(vertexId >> 1, 1 - (vertexId & 1));
+    float32_t2 position = instance.translate + corner.x * instance.axes.xy + corner.y * instance.axes.zw;
+
+    VertexShaderOutput output;
+    output.position = mul(float32_t4(position, instance.depth, 1.0f), gViewProjection.matrix);
+    output.texcoord = lerp(instance.uvRect.xy, instance.uvRect.zw, corner);
+    output.color = instance.color;
+    output.textureIndex = instance.textureIndex;
+    return output;
+}
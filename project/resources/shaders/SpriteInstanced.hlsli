@@ -0,0 +1,7 @@
+struct VertexShaderOutput
+{
+    float32_t4 position : SV_POSITION;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t4 color : COLOR0;
+    nointerpolation uint32_t textureIndex : TEXTURE_INDEX0;
+};